@@ -0,0 +1,79 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <helpers/path_helper.hpp>
+#include <helpers/timing.hpp>
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+// Save the workbook into memory with the given options and report how long it
+// took and how large the result is.
+void save(const xlnt::workbook &wb, const std::string &label, const xlnt::save_options &options)
+{
+    using xlnt::benchmarks::current_time;
+
+    std::vector<std::uint8_t> data;
+
+    auto start = current_time();
+    wb.save(data, options);
+    auto elapsed = current_time() - start;
+
+    std::cout << label << ": " << elapsed / 1000.0 << "s, "
+              << data.size() / 1024 << " KiB" << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    xlnt::workbook wb;
+    wb.load(path_helper::benchmark_file("large.xlsx"));
+
+    // the first save also pays for one-time setup so it isn't reported
+    std::vector<std::uint8_t> warm_up;
+    wb.save(warm_up);
+
+    xlnt::save_options options;
+    options.store_only = true;
+    save(wb, "store", options);
+    options.store_only = false;
+
+    for (auto level = 0; level <= 9; ++level)
+    {
+        options.compression_level = level;
+        save(wb, "level " + std::to_string(level), options);
+    }
+
+    options.compression_level = 6;
+    options.strategy = xlnt::save_options::compression_strategy::huffman_only;
+    save(wb, "level 6 huffman only", options);
+    options.strategy = xlnt::save_options::compression_strategy::run_length;
+    save(wb, "level 6 run length", options);
+
+    return 0;
+}
@@ -0,0 +1,95 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include <helpers/timing.hpp>
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+// Convert n random timestamps between 1950 and 2050 one at a time with
+// datetime::from_number and all at once with datetime::from_numbers, then
+// convert them to Unix microseconds and back.
+void convert(std::size_t n)
+{
+    using xlnt::benchmarks::current_time;
+
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> distribution(18264.0, 54789.0);
+    std::vector<double> numbers(n);
+
+    for (auto &number : numbers)
+    {
+        number = distribution(generator);
+    }
+
+    const auto base_date = xlnt::calendar::windows_1900;
+    std::vector<xlnt::datetime> single;
+    single.reserve(n);
+
+    auto start = current_time();
+
+    for (auto number : numbers)
+    {
+        single.push_back(xlnt::datetime::from_number(number, base_date));
+    }
+
+    auto one_at_a_time = current_time();
+
+    std::vector<xlnt::datetime> bulk;
+    xlnt::datetime::from_numbers(numbers, base_date, bulk);
+
+    auto all_at_once = current_time();
+
+    std::vector<double> round_trip;
+    xlnt::datetime::to_numbers(bulk, base_date, round_trip);
+
+    auto back = current_time();
+
+    std::vector<std::int64_t> microseconds;
+    xlnt::datetime::unix_microseconds_from_numbers(numbers, base_date, microseconds);
+    xlnt::datetime::numbers_from_unix_microseconds(microseconds, base_date, round_trip);
+
+    auto unix_round_trip = current_time();
+
+    std::cout << n << " datetimes: "
+              << (one_at_a_time - start) / 1000.0 << "s with from_number, "
+              << (all_at_once - one_at_a_time) / 1000.0 << "s with from_numbers, "
+              << (back - all_at_once) / 1000.0 << "s with to_numbers, "
+              << (unix_round_trip - back) / 1000.0 << "s to Unix microseconds and back"
+              << (single == bulk ? "" : " (results differ)") << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    convert(1000000);
+    convert(10000000);
+
+    return 0;
+}
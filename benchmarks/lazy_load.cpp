@@ -0,0 +1,96 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <helpers/timing.hpp>
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+// Build a workbook with many worksheets of numbers so that reading a single
+// one is a small part of loading all of them.
+std::vector<std::uint8_t> generate_workbook(std::size_t sheets, xlnt::row_t rows)
+{
+    xlnt::workbook wb;
+
+    for (std::size_t index = 0; index < sheets; ++index)
+    {
+        auto ws = index == 0 ? wb.active_sheet() : wb.create_sheet();
+
+        for (xlnt::row_t row = 1; row <= rows; ++row)
+        {
+            for (xlnt::column_t::index_t column = 1; column <= 10; ++column)
+            {
+                ws.cell(column, row).value(static_cast<double>(row * column));
+            }
+        }
+    }
+
+    std::vector<std::uint8_t> data;
+    wb.save(data);
+
+    return data;
+}
+
+// Load the workbook and sum the values of one worksheet in the middle of it.
+void read_one_sheet(const std::vector<std::uint8_t> &data, const std::string &label, bool lazy)
+{
+    using xlnt::benchmarks::current_time;
+
+    xlnt::load_options options;
+    options.lazy_parts = lazy;
+
+    const auto start = current_time();
+
+    xlnt::workbook wb;
+    wb.load(data, options);
+
+    auto sum = 0.0;
+
+    for (auto row : wb.sheet_by_index(wb.sheet_count() / 2).rows())
+    {
+        for (auto cell : row)
+        {
+            sum += cell.value<double>();
+        }
+    }
+
+    const auto elapsed = current_time() - start;
+
+    std::cout << label << ": " << elapsed << " ms (sum " << sum << ")" << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    const auto data = generate_workbook(200, 500);
+
+    read_one_sheet(data, "load everything", false);
+    read_one_sheet(data, "lazy parts", true);
+
+    return 0;
+}
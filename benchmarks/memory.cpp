@@ -0,0 +1,133 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include <helpers/timing.hpp>
+#include <xlnt/xlnt.hpp>
+
+// Count every heap allocation made by the process so that the cost of a cell
+// can be measured without relying on platform-specific RSS queries. The size
+// of each block is stored in front of it so that frees can be subtracted.
+
+namespace {
+
+std::atomic<std::size_t> live_bytes(0);
+
+const std::size_t header_size = alignof(std::max_align_t);
+
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    auto block = static_cast<char *>(std::malloc(size + header_size));
+
+    if (block == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    *reinterpret_cast<std::size_t *>(block) = size;
+    live_bytes += size;
+
+    return block + header_size;
+}
+
+void operator delete(void *pointer) noexcept
+{
+    if (pointer == nullptr) return;
+
+    auto block = static_cast<char *>(pointer) - header_size;
+    live_bytes -= *reinterpret_cast<std::size_t *>(block);
+    std::free(block);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+namespace {
+
+// Fill a worksheet with rows x cols cells of the given kind and report the
+// heap growth per cell.
+void measure(const std::string &label, int cols, int rows, bool strings)
+{
+    using xlnt::benchmarks::current_time;
+
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    // create the shared strings up front so that only cell storage is counted
+    if (strings)
+    {
+        for (int i = 0; i < cols; i++)
+        {
+            wb.add_shared_string(xlnt::rich_text(std::to_string(i)));
+        }
+    }
+
+    const auto before = live_bytes.load();
+    const auto start = current_time();
+
+    for (int row = 1; row <= rows; row++)
+    {
+        for (int col = 1; col <= cols; col++)
+        {
+            auto cell = ws.cell(xlnt::cell_reference(static_cast<xlnt::column_t::index_t>(col),
+                static_cast<xlnt::row_t>(row)));
+
+            if (strings)
+            {
+                cell.value(std::to_string(col - 1));
+            }
+            else
+            {
+                cell.value(row * col + 0.5);
+            }
+        }
+    }
+
+    const auto elapsed = current_time() - start;
+    const auto cells = static_cast<double>(cols) * rows;
+    const auto bytes = static_cast<double>(live_bytes.load() - before);
+
+    std::cout << label << ": " << cols << " cols " << rows << " rows, "
+              << bytes / cells << " bytes/cell, "
+              << elapsed / 1000.0 << "s" << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    measure("numbers", 10, 200000, false);
+    measure("numbers", 200, 10000, false);
+    measure("strings", 20, 100000, true);
+    measure("sparse numbers", 1, 500000, false);
+
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <detail/number_format/number_formatter.hpp>
+#include <helpers/timing.hpp>
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+// Render n values with the given format code the way a CSV export would,
+// first parsing the format code for every value as number_format used to
+// and then with the compiled program, one value at a time and as a column.
+void render_column(const std::string &format_code, std::size_t n)
+{
+    using xlnt::benchmarks::current_time;
+
+    const auto calendar = xlnt::calendar::windows_1900;
+    std::vector<double> numbers(n);
+
+    for (std::size_t i = 0; i < n; ++i)
+    {
+        numbers[i] = 40000 + static_cast<double>(i) / 7;
+    }
+
+    std::size_t total_length = 0;
+    auto start = current_time();
+
+    for (auto number : numbers)
+    {
+        total_length += xlnt::detail::number_formatter(format_code, calendar).format_number(number).size();
+    }
+
+    auto reparsed = current_time();
+
+    const xlnt::number_format format(format_code);
+    std::string buffer;
+
+    for (auto number : numbers)
+    {
+        format.format(number, calendar, buffer);
+        total_length += buffer.size();
+    }
+
+    auto compiled = current_time();
+
+    std::vector<std::string> column;
+    format.format(numbers, calendar, column);
+
+    auto bulk = current_time();
+
+    for (const auto &value : column)
+    {
+        total_length += value.size();
+    }
+
+    std::cout << n << " values as \"" << format_code << "\": "
+              << (reparsed - start) / 1000.0 << "s parsing every value, "
+              << (compiled - reparsed) / 1000.0 << "s compiled, "
+              << (bulk - compiled) / 1000.0 << "s as a column"
+              << " (" << total_length << " bytes)" << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    const std::size_t n = 1000000;
+
+    render_column("General", n);
+    render_column("#,##0.00", n);
+    render_column("yyyy-mm-dd h:mm:ss", n);
+
+    return 0;
+}
@@ -0,0 +1,142 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <cstdio>
+#include <iostream>
+#include <locale>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <detail/serialization/number_parser.hpp>
+#include <helpers/path_helper.hpp>
+#include <helpers/timing.hpp>
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+// Load the file with workbook::load and with the streaming reader and
+// report how many numeric cells per second each reads.
+std::vector<double> load(const xlnt::path &file)
+{
+    using xlnt::benchmarks::current_time;
+
+    auto start = current_time();
+
+    xlnt::workbook wb;
+    wb.load(file);
+
+    std::vector<double> numbers;
+
+    for (auto ws : wb)
+    {
+        for (auto row : ws.rows(false))
+        {
+            for (auto cell : row)
+            {
+                if (cell.data_type() == xlnt::cell::type::number)
+                {
+                    numbers.push_back(cell.value<double>());
+                }
+            }
+        }
+    }
+
+    auto loaded = current_time();
+
+    xlnt::streaming_workbook_reader reader;
+    reader.open(file);
+    std::size_t streamed = 0;
+
+    for (const auto &title : reader.sheet_titles())
+    {
+        reader.begin_worksheet(title);
+        reader.visit_cells([&streamed](const xlnt::cell_view &view) {
+            streamed += view.type == xlnt::cell_type::number ? 1 : 0;
+        });
+        reader.end_worksheet();
+    }
+
+    auto visited = current_time();
+
+    std::cout << numbers.size() << " numeric cells: "
+              << numbers.size() / ((loaded - start) / 1000.0) << " cells/s with workbook::load, "
+              << streamed / ((visited - loaded) / 1000.0) << " cells/s with visit_cells" << std::endl;
+
+    return numbers;
+}
+
+// Parse the text of every number with a C locale istringstream, as the
+// consumer used to, and with detail::parse_double.
+void parse(const std::vector<double> &numbers)
+{
+    using xlnt::benchmarks::current_time;
+
+    std::vector<std::string> texts;
+    char buffer[32];
+
+    for (auto number : numbers)
+    {
+        std::snprintf(buffer, sizeof(buffer), "%.17g", number);
+        texts.push_back(buffer);
+    }
+
+    std::istringstream stream;
+    stream.imbue(std::locale("C"));
+    double stream_sum = 0;
+    auto start = current_time();
+
+    for (const auto &text : texts)
+    {
+        double value = 0;
+        stream.str(text);
+        stream.clear();
+        stream >> value;
+        stream_sum += value;
+    }
+
+    auto streamed = current_time();
+    double parsed_sum = 0;
+
+    for (const auto &text : texts)
+    {
+        parsed_sum += xlnt::detail::parse_double(text);
+    }
+
+    auto parsed = current_time();
+
+    std::cout << texts.size() << " values: "
+              << texts.size() / ((streamed - start) / 1000.0) << " values/s with istringstream, "
+              << texts.size() / ((parsed - streamed) / 1000.0) << " values/s with parse_double"
+              << (stream_sum == parsed_sum ? "" : " (results differ)") << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    parse(load(path_helper::benchmark_file("large.xlsx")));
+
+    return 0;
+}
@@ -0,0 +1,120 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <detail/serialization/shortest_double.hpp>
+#include <helpers/timing.hpp>
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+std::vector<double> random_values(std::size_t n)
+{
+    std::mt19937 random(42);
+    std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+    std::vector<double> values(n);
+
+    for (auto &value : values)
+    {
+        value = distribution(random);
+    }
+
+    return values;
+}
+
+// Format each value as the producer used to, through a stringstream with
+// 20 digits of precision, and with detail::write_shortest_double.
+void format(const std::vector<double> &values)
+{
+    using xlnt::benchmarks::current_time;
+
+    std::size_t stream_length = 0;
+    auto start = current_time();
+
+    for (auto value : values)
+    {
+        std::stringstream ss;
+        ss.precision(20);
+        ss << value;
+        stream_length += ss.str().size();
+    }
+
+    auto streamed = current_time();
+
+    std::size_t shortest_length = 0;
+    char buffer[xlnt::detail::max_shortest_double_length];
+
+    for (auto value : values)
+    {
+        shortest_length += xlnt::detail::write_shortest_double(value, buffer);
+    }
+
+    auto shortest = current_time();
+
+    std::cout << values.size() << " values: "
+              << (streamed - start) / 1000.0 << "s and " << stream_length << " characters with stringstream, "
+              << (shortest - streamed) / 1000.0 << "s and " << shortest_length << " characters shortest" << std::endl;
+}
+
+// Save a sheet of non-integral numbers and report the time and file size.
+void save(const std::vector<double> &values, std::size_t columns)
+{
+    using xlnt::benchmarks::current_time;
+
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    for (std::size_t i = 0; i < values.size(); ++i)
+    {
+        ws.cell(static_cast<xlnt::column_t::index_t>(i % columns + 1),
+            static_cast<xlnt::row_t>(i / columns + 1)).value(values[i]);
+    }
+
+    auto start = current_time();
+    wb.save("benchmark.xlsx");
+    auto saved = current_time();
+
+    std::ifstream file("benchmark.xlsx", std::ios::binary | std::ios::ate);
+
+    std::cout << "saved " << values.size() << " numbers in " << (saved - start) / 1000.0 << "s, "
+              << file.tellg() << " bytes" << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    const auto values = random_values(1000000);
+
+    format(values);
+    save(values, 20);
+
+    return 0;
+}
@@ -0,0 +1,69 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <iostream>
+
+#include <helpers/timing.hpp>
+#include <xlnt/xlnt.hpp>
+
+namespace {
+
+// Write n distinct strings into a single column and save the result.
+// Every value goes through workbook::add_shared_string so this measures
+// the cost of deduplicating against an ever-growing shared string table.
+void write_distinct_strings(int n)
+{
+    using xlnt::benchmarks::current_time;
+
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    auto start = current_time();
+
+    for (int index = 0; index < n; index++)
+    {
+        ws.cell(xlnt::cell_reference(1, static_cast<xlnt::row_t>(index + 1)))
+            .value("string " + std::to_string(index));
+    }
+
+    auto populated = current_time();
+
+    wb.save("benchmark.xlsx");
+
+    auto saved = current_time();
+
+    std::cout << n << " distinct strings: "
+              << (populated - start) / 1000.0 << "s to populate, "
+              << (saved - populated) / 1000.0 << "s to save" << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    write_distinct_strings(10000);
+    write_distinct_strings(100000);
+    write_distinct_strings(1000000);
+
+    return 0;
+}
@@ -0,0 +1,141 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include <helpers/path_helper.hpp>
+#include <helpers/timing.hpp>
+#include <xlnt/xlnt.hpp>
+
+// Count heap allocations so that the per-cell cost of each streaming API can
+// be reported next to its speed.
+
+namespace {
+
+std::atomic<std::size_t> allocations(0);
+
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    ++allocations;
+    auto block = std::malloc(size);
+
+    if (block == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    return block;
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+namespace {
+
+// Read the cells of every sheet in the file selected by plan with
+// read_cell() or visit_cells() and report cells per second and
+// allocations per cell.
+void read(const xlnt::path &file, bool visit, const std::string &label, const xlnt::read_plan &plan)
+{
+    using xlnt::benchmarks::current_time;
+
+    xlnt::streaming_workbook_reader reader;
+    reader.open(file);
+
+    std::size_t cells = 0;
+    double sum = 0;
+
+    const auto allocations_before = allocations.load();
+    const auto start = current_time();
+
+    for (const auto &title : reader.sheet_titles())
+    {
+        reader.begin_worksheet(title, plan);
+
+        if (visit)
+        {
+            reader.visit_cells([&cells, &sum](const xlnt::cell_view &view) {
+                ++cells;
+                sum += view.number;
+            });
+        }
+        else
+        {
+            while (reader.has_cell())
+            {
+                auto cell = reader.read_cell();
+                ++cells;
+
+                if (cell.data_type() == xlnt::cell::type::number)
+                {
+                    sum += cell.value<double>();
+                }
+            }
+        }
+
+        reader.end_worksheet();
+    }
+
+    const auto elapsed = current_time() - start;
+    const auto allocated = allocations.load() - allocations_before;
+
+    std::cout << label << ": "
+              << cells << " cells, " << elapsed / 1000.0 << "s, "
+              << cells / (elapsed / 1000.0) << " cells/s, "
+              << static_cast<double>(allocated) / cells << " allocations/cell"
+              << " (checksum " << sum << ")" << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    const auto file = path_helper::benchmark_file("large.xlsx");
+
+    read(file, false, "read_cell", xlnt::read_plan());
+    read(file, true, "visit_cells", xlnt::read_plan());
+
+    xlnt::read_plan narrow;
+    narrow.columns = {"A", "C", "E"};
+    read(file, false, "read_cell, 3 columns", narrow);
+    read(file, true, "visit_cells, 3 columns", narrow);
+
+    xlnt::read_plan rows;
+    rows.first_row = 10;
+    rows.last_row = 20;
+    read(file, true, "visit_cells, 11 rows", rows);
+
+    return 0;
+}
@@ -0,0 +1,130 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <atomic>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+
+#include <helpers/timing.hpp>
+#include <xlnt/xlnt.hpp>
+
+// Track the peak heap size while a large workbook is streamed to disk. The
+// peak should stay flat as the number of rows grows.
+
+namespace {
+
+std::atomic<std::size_t> live_bytes(0);
+std::atomic<std::size_t> peak_bytes(0);
+
+const std::size_t header_size = alignof(std::max_align_t);
+
+} // namespace
+
+void *operator new(std::size_t size)
+{
+    auto block = static_cast<char *>(std::malloc(size + header_size));
+
+    if (block == nullptr)
+    {
+        throw std::bad_alloc();
+    }
+
+    *reinterpret_cast<std::size_t *>(block) = size;
+    const auto live = live_bytes += size;
+
+    if (live > peak_bytes)
+    {
+        peak_bytes = live;
+    }
+
+    return block + header_size;
+}
+
+void operator delete(void *pointer) noexcept
+{
+    if (pointer == nullptr) return;
+
+    auto block = static_cast<char *>(pointer) - header_size;
+    live_bytes -= *reinterpret_cast<std::size_t *>(block);
+    std::free(block);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    operator delete(pointer);
+}
+
+namespace {
+
+void measure(int cols, int rows)
+{
+    using xlnt::benchmarks::current_time;
+
+    const auto before = live_bytes.load();
+    peak_bytes = before;
+    const auto start = current_time();
+
+    {
+        xlnt::streaming_workbook_writer writer;
+        writer.open(xlnt::path("benchmark-streaming.xlsx"));
+        writer.add_worksheet("data");
+
+        for (int row = 1; row <= rows; row++)
+        {
+            for (int col = 1; col <= cols; col++)
+            {
+                const auto ref = xlnt::cell_reference(static_cast<xlnt::column_t::index_t>(col),
+                    static_cast<xlnt::row_t>(row));
+
+                if (col % 2 == 0)
+                {
+                    writer.add_string(ref, "row " + std::to_string(row));
+                }
+                else
+                {
+                    writer.add_number(ref, row * col + 0.5);
+                }
+            }
+        }
+
+        writer.close();
+    }
+
+    const auto elapsed = current_time() - start;
+
+    std::cout << cols << " cols " << rows << " rows, peak heap "
+              << (peak_bytes.load() - before) / 1024 << " KiB, "
+              << elapsed / 1000.0 << "s" << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    measure(10, 10000);
+    measure(10, 100000);
+    measure(10, 1000000);
+
+    return 0;
+}
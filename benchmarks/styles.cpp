@@ -24,6 +24,7 @@
 #include <chrono>
 #include <iostream>
 #include <iterator>
+#include <memory>
 #include <random>
 
 #include <helpers/timing.hpp>
@@ -164,6 +165,44 @@ void to_profile(xlnt::workbook &wb, const std::string &f, int n)
     std::cout << "took " << elapsed / 1000.0 << "s for " << n << " styles" << std::endl;
 }
 
+// Give each of n cells its own font and fill so that every cell ends up with
+// a distinct format. Each call looks up the new font, fill and format among
+// all of those created so far. If batched, the formats are applied inside a
+// style_edit_session so unused styles are collected once at the end instead
+// of after every change.
+void apply_distinct_formats(int n, bool batched)
+{
+    using xlnt::benchmarks::current_time;
+
+    xlnt::workbook wb;
+    auto ws = wb.active_sheet();
+
+    auto start = current_time();
+
+    {
+        std::unique_ptr<xlnt::style_edit_session> session;
+
+        if (batched)
+        {
+            session.reset(new xlnt::style_edit_session(wb));
+        }
+
+        for (int index = 0; index < n; index++)
+        {
+            auto cell = ws.cell(xlnt::cell_reference(1, static_cast<xlnt::row_t>(index + 1)));
+
+            cell.font(xlnt::font().size(6 + index / 100.0));
+            cell.fill(xlnt::fill::solid(xlnt::rgb_color(
+                static_cast<std::uint8_t>(index % 256), static_cast<std::uint8_t>(index / 256 % 256), 0)));
+        }
+    }
+
+    auto elapsed = current_time() - start;
+
+    std::cout << "took " << elapsed / 1000.0 << "s to apply " << n << " distinct formats"
+              << (batched ? " in a style edit session" : "") << std::endl;
+}
+
 } // namespace
 
 int main()
@@ -173,5 +212,9 @@ int main()
     std::string f = "temp.xlsx";
     to_profile(wb, f, n);
 
+    apply_distinct_formats(10000, false);
+    apply_distinct_formats(10000, true);
+    apply_distinct_formats(100000, true);
+
     return 0;
 }
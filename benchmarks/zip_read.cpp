@@ -0,0 +1,101 @@
+// Copyright (c) 2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <detail/serialization/mapped_file.hpp>
+#include <detail/serialization/vector_streambuf.hpp>
+#include <detail/serialization/zstream.hpp>
+#include <helpers/path_helper.hpp>
+#include <helpers/timing.hpp>
+
+namespace {
+
+// Decompress every part of the archive and report the throughput in
+// uncompressed MB/s. Parts are read either through the streambuf returned by
+// izstream::open or directly into memory with izstream::read.
+void read_parts(const xlnt::detail::izstream &archive, const std::string &label, bool direct)
+{
+    using xlnt::benchmarks::current_time;
+
+    std::vector<std::uint8_t> destination;
+    std::vector<char> chunk(64 * 1024);
+    std::size_t total = 0;
+
+    const auto start = current_time();
+
+    for (auto repeat = 0; repeat < 20; ++repeat)
+    {
+        for (const auto &part : archive.files())
+        {
+            if (direct)
+            {
+                const auto size = archive.uncompressed_size(part);
+                destination.resize(std::max(destination.size(), size));
+                total += archive.read(part, destination.data(), size);
+                continue;
+            }
+
+            auto part_buffer = archive.open(part);
+            std::istream part_stream(part_buffer.get());
+
+            while (part_stream.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || part_stream.gcount() > 0)
+            {
+                total += static_cast<std::size_t>(part_stream.gcount());
+            }
+        }
+    }
+
+    const auto elapsed = current_time() - start;
+
+    std::cout << label << ": " << (total / 1048576.0) / (elapsed / 1000.0) << " MB/s" << std::endl;
+}
+
+} // namespace
+
+int main()
+{
+    std::ifstream file(path_helper::benchmark_file("large.xlsx").string(), std::ios::binary);
+    const auto archive_data = std::vector<std::uint8_t>(
+        (std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    xlnt::detail::vector_istreambuf archive_buffer(archive_data);
+    std::istream archive_stream(&archive_buffer);
+
+    read_parts(xlnt::detail::izstream(archive_stream, 512), "streambuf, 512 byte buffers", false);
+    read_parts(xlnt::detail::izstream(archive_stream, 0), "streambuf, adaptive buffers", false);
+    read_parts(xlnt::detail::izstream(archive_stream, 0), "direct into caller memory", true);
+
+    // the compressed bytes are read in place from the page cache
+    const auto mapping = std::make_shared<xlnt::detail::mapped_file>(path_helper::benchmark_file("large.xlsx"));
+
+    read_parts(xlnt::detail::izstream(mapping, 0), "mapped file, streambuf", false);
+    read_parts(xlnt::detail::izstream(mapping, 0), "mapped file, direct into caller memory", true);
+
+    return 0;
+}
@@ -71,6 +71,19 @@ public:
     static std::pair<std::string, row_t> split_reference(
         const std::string &reference_string, bool &absolute_column, bool &absolute_row);
 
+    /// <summary>
+    /// The largest number of characters in a cell reference string such as "$XFD$1048576".
+    /// </summary>
+    static const std::size_t max_string_length = 16;
+
+    /// <summary>
+    /// Parses the reference in [first, last), such as "B12" or "$B$12", without
+    /// allocating. Throws invalid_cell_reference if the range isn't an optional
+    /// dollar sign, letters, an optional dollar sign and digits, and
+    /// invalid_column_index if the letters aren't a valid column.
+    /// </summary>
+    static cell_reference from_chars(const char *first, const char *last);
+
     // constructors
 
     /// <summary>
@@ -180,6 +193,14 @@ public:
     /// </summary>
     std::string to_string() const;
 
+    /// <summary>
+    /// Writes the string representation of this reference to buffer without
+    /// allocating and returns the number of characters written. buffer must
+    /// have room for max_string_length characters and no null terminator is
+    /// written.
+    /// </summary>
+    std::size_t to_chars(char *buffer) const;
+
     /// <summary>
     /// Returns a 1x1 range_reference containing only this cell_reference.
     /// </summary>
@@ -0,0 +1,98 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/cell/cell_type.hpp>
+#include <xlnt/cell/index_types.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// A read-only description of a single cell as it is being parsed. Views are
+/// passed to the visitor of streaming_workbook_reader::visit_cells and are only
+/// valid for the duration of that call. Nothing is allocated to create one.
+/// </summary>
+struct XLNT_API cell_view
+{
+    /// <summary>
+    /// The row of the cell.
+    /// </summary>
+    row_t row;
+
+    /// <summary>
+    /// The column of the cell.
+    /// </summary>
+    column_t::index_t column;
+
+    /// <summary>
+    /// The type of the cell's value. Cells without a value are empty.
+    /// </summary>
+    cell_type type;
+
+    /// <summary>
+    /// The value of a number cell, or 1 or 0 for a boolean cell.
+    /// </summary>
+    double number;
+
+    /// <summary>
+    /// The index into workbook::shared_strings() of a shared string cell.
+    /// </summary>
+    std::size_t shared_string;
+
+    /// <summary>
+    /// The characters of an inline string, formula string, error or date cell.
+    /// This points into a buffer owned by the reader and is not null terminated.
+    /// </summary>
+    const char *text;
+
+    /// <summary>
+    /// The number of characters pointed to by text.
+    /// </summary>
+    std::size_t text_length;
+
+    /// <summary>
+    /// True if the cell has a format.
+    /// </summary>
+    bool has_format;
+
+    /// <summary>
+    /// The index of the cell's format in the workbook if has_format is true.
+    /// </summary>
+    std::size_t format;
+
+    /// <summary>
+    /// True if the cell is a number with a date or time format, as for cell::is_date.
+    /// </summary>
+    bool is_date;
+
+    /// <summary>
+    /// True if the cell is a number with an elapsed time format, such as [h]:mm.
+    /// </summary>
+    bool is_timedelta;
+};
+
+} // namespace xlnt
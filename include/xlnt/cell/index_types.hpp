@@ -72,6 +72,26 @@ public:
     /// </remarks>
     static std::string column_string_from_index(index_t column_index);
 
+    /// <summary>
+    /// The largest number of letters in a column string.
+    /// </summary>
+    static const std::size_t max_string_length = 3;
+
+    /// <summary>
+    /// Converts the letters in [first, last) into a column number without
+    /// allocating. Letters may be upper or lower case. Throws invalid_column_index
+    /// under the same conditions as column_index_from_string(const std::string &).
+    /// </summary>
+    static index_t column_index_from_string(const char *first, const char *last);
+
+    /// <summary>
+    /// Writes the letters of column_index (e.g. "AB" for 28) to buffer without
+    /// allocating and returns the number written. buffer must have room for
+    /// max_string_length characters and no null terminator is written.
+    /// Throws invalid_column_index if column_index is out of range.
+    /// </summary>
+    static std::size_t column_string_from_index(index_t column_index, char *buffer);
+
     /// <summary>
     /// Default constructor. The column points to the "A" column.
     /// </summary>
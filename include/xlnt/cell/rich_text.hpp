@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <functional>
 #include <string>
 #include <vector>
 
@@ -110,10 +111,45 @@ public:
     bool operator!=(const std::string &rhs) const;
 
 private:
+    friend struct rich_text_hash;
+
     /// <summary>
     /// The runs that make up this rich text.
     /// </summary>
     std::vector<rich_text_run> runs_;
 };
 
+/// <summary>
+/// Functor for hashing rich text. Only the text of each run is hashed so
+/// texts that differ only in formatting share a hash value.
+/// Allows for use of std::unordered_map<rich_text, T, rich_text_hash> and similar.
+/// </summary>
+struct XLNT_API rich_text_hash
+{
+    /// <summary>
+    /// Returns the result of hashing text k.
+    /// </summary>
+    std::size_t operator()(const rich_text &k) const;
+};
+
 } // namespace xlnt
+
+namespace std {
+
+/// <summary>
+/// Template specialization to allow xlnt::rich_text to be used as a key in a std container.
+/// </summary>
+template <>
+struct hash<xlnt::rich_text>
+{
+    /// <summary>
+    /// Returns the result of hashing text k.
+    /// </summary>
+    size_t operator()(const xlnt::rich_text &k) const
+    {
+        static xlnt::rich_text_hash hasher;
+        return hasher(k);
+    }
+};
+
+} // namespace std
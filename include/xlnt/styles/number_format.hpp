@@ -25,7 +25,9 @@
 #pragma once
 
 #include <cstdint>
+#include <memory>
 #include <string>
+#include <vector>
 
 #include <xlnt/xlnt_config.hpp>
 #include <xlnt/utils/optional.hpp>
@@ -34,6 +36,12 @@ namespace xlnt {
 
 enum class calendar;
 
+namespace detail {
+
+struct number_format_program;
+
+} // namespace detail
+
 /// <summary>
 /// Describes the number formatting applied to text and numbers within a certain cell.
 /// </summary>
@@ -203,6 +211,16 @@ public:
     /// </summary>
     number_format(const std::string &code, std::size_t custom_id);
 
+    /// <summary>
+    /// Constructs a copy of other, sharing its compiled format code.
+    /// </summary>
+    number_format(const number_format &other);
+
+    /// <summary>
+    /// Makes this a copy of other, sharing its compiled format code.
+    /// </summary>
+    number_format &operator=(const number_format &other);
+
     /// <summary>
     /// Sets the format code of this number format to format_code.
     /// </summary>
@@ -244,11 +262,31 @@ public:
     /// </summary>
     std::string format(double number, calendar base_date) const;
 
+    /// <summary>
+    /// Replaces the contents of output with number formatted according to this
+    /// number format's format code with the given base date. Reusing the same
+    /// output string avoids an allocation per call.
+    /// </summary>
+    void format(double number, calendar base_date, std::string &output) const;
+
+    /// <summary>
+    /// Formats each of numbers with the given base date, storing the result in
+    /// the element of output with the same index. output is resized to match
+    /// numbers and the capacity of its existing strings is reused.
+    /// </summary>
+    void format(const std::vector<double> &numbers, calendar base_date, std::vector<std::string> &output) const;
+
     /// <summary>
     /// Returns true if this format code returns a number formatted as a date.
     /// </summary>
     bool is_date_format() const;
 
+    /// <summary>
+    /// Returns true if this format code returns a number formatted as an elapsed
+    /// time, such as [h]:mm:ss.
+    /// </summary>
+    bool is_timedelta_format() const;
+
     /// <summary>
     /// Returns true if this format is equivalent to other.
     /// </summary>
@@ -269,6 +307,19 @@ private:
     /// The format code
     /// </summary>
     std::string format_string_;
+
+    /// <summary>
+    /// Returns the parsed format code, compiling it on first use.
+    /// </summary>
+    std::shared_ptr<const detail::number_format_program> program() const;
+
+    /// <summary>
+    /// The parsed format code, shared between copies of this format and with
+    /// other formats using the same format code. Null until first needed.
+    /// Only accessed with std::atomic_load/atomic_store so that const methods
+    /// can be called from several threads.
+    /// </summary>
+    mutable std::shared_ptr<const detail::number_format_program> program_;
 };
 
 } // namespace xlnt
@@ -23,7 +23,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include <xlnt/xlnt_config.hpp>
 #include <xlnt/utils/calendar.hpp>
@@ -48,6 +50,37 @@ struct XLNT_API date
     /// </summary>
     static date from_number(int days_since_base_year, calendar base_date);
 
+    /// <summary>
+    /// Converts the integer part of every number in numbers to a date as
+    /// date::from_number does and stores the results in dates, which is
+    /// resized to match. This is much faster than converting one value at a
+    /// time when there are many values.
+    /// </summary>
+    static void from_numbers(const std::vector<double> &numbers, calendar base_date, std::vector<date> &dates);
+
+    /// <summary>
+    /// Converts every date in dates to a number as date::to_number does and
+    /// stores the results in numbers, which is resized to match.
+    /// </summary>
+    static void to_numbers(const std::vector<date> &dates, calendar base_date, std::vector<double> &numbers);
+
+    /// <summary>
+    /// Converts every number in numbers, rounded down to a whole day, to the
+    /// number of days since 1970-01-01 and stores the results in days, which is resized
+    /// to match. In the 1900 date system, day 60 (the fictitious 29 February
+    /// 1900) becomes 1 March 1900.
+    /// </summary>
+    static void unix_days_from_numbers(const std::vector<double> &numbers, calendar base_date,
+        std::vector<std::int32_t> &days);
+
+    /// <summary>
+    /// Converts every number of days since 1970-01-01 in days to a number in
+    /// the given date system and stores the results in numbers, which is
+    /// resized to match.
+    /// </summary>
+    static void numbers_from_unix_days(const std::vector<std::int32_t> &days, calendar base_date,
+        std::vector<double> &numbers);
+
     /// <summary>
     /// Constructs a data from a given year, month, and day.
     /// </summary>
@@ -23,7 +23,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <string>
+#include <vector>
 
 #include <xlnt/xlnt_config.hpp>
 #include <xlnt/utils/calendar.hpp>
@@ -56,6 +58,39 @@ struct XLNT_API datetime
     /// </summary>
     static datetime from_number(double number, calendar base_date);
 
+    /// <summary>
+    /// Converts every number in numbers to a datetime as datetime::from_number
+    /// does and stores the results in datetimes, which is resized to match.
+    /// This is much faster than converting one value at a time when there are
+    /// many values.
+    /// </summary>
+    static void from_numbers(const std::vector<double> &numbers, calendar base_date,
+        std::vector<datetime> &datetimes);
+
+    /// <summary>
+    /// Converts every datetime in datetimes to a number as datetime::to_number
+    /// does and stores the results in numbers, which is resized to match.
+    /// </summary>
+    static void to_numbers(const std::vector<datetime> &datetimes, calendar base_date,
+        std::vector<double> &numbers);
+
+    /// <summary>
+    /// Converts every number in numbers to the number of microseconds since
+    /// 1970-01-01 00:00:00, rounded to the nearest microsecond, and stores the
+    /// results in microseconds, which is resized to match. In the 1900 date
+    /// system, day 60 (the fictitious 29 February 1900) becomes 1 March 1900.
+    /// </summary>
+    static void unix_microseconds_from_numbers(const std::vector<double> &numbers, calendar base_date,
+        std::vector<std::int64_t> &microseconds);
+
+    /// <summary>
+    /// Converts every number of microseconds since 1970-01-01 00:00:00 in
+    /// microseconds to a number in the given date system and stores the
+    /// results in numbers, which is resized to match.
+    /// </summary>
+    static void numbers_from_unix_microseconds(const std::vector<std::int64_t> &microseconds,
+        calendar base_date, std::vector<double> &numbers);
+
     /// <summary>
     /// Returns a datetime equivalent to the ISO-formatted string iso_string.
     /// </summary>
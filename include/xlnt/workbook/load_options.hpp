@@ -0,0 +1,93 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// Options controlling how workbook::load reads an XLSX package.
+/// </summary>
+class XLNT_API load_options
+{
+public:
+    /// <summary>
+    /// Constructs options which load the workbook the same way as
+    /// workbook::load without options.
+    /// </summary>
+    load_options();
+
+    /// <summary>
+    /// The number of threads used to parse worksheets. Each worksheet is
+    /// inflated and parsed by one thread and the results are merged into the
+    /// workbook once all of them are done. 1 reads worksheets one after
+    /// another on the calling thread and 0 uses one thread per hardware core.
+    /// </summary>
+    std::size_t worksheet_threads;
+
+    /// <summary>
+    /// The size in bytes of the buffers used to decompress each part. 0 (the
+    /// default) picks a size between 64 KiB and 1 MiB from the size of each part.
+    /// </summary>
+    std::size_t zip_buffer_size;
+
+    /// <summary>
+    /// When loading from a path, maps the file into memory instead of reading
+    /// it through a stream. Parts are inflated straight from the mapping so
+    /// the compressed package is never copied into the process and pages
+    /// already cached by the operating system are shared with other readers.
+    /// The file must not be truncated while it is being loaded.
+    /// </summary>
+    bool memory_map;
+
+    /// <summary>
+    /// The number of bytes of shared strings which streaming_workbook_reader
+    /// keeps in memory. Larger shared string tables are moved to a temporary
+    /// file and read back as cells refer to them. The default is 64 MiB.
+    /// workbook::load always keeps shared strings in memory.
+    /// </summary>
+    std::size_t shared_string_memory_limit;
+
+    /// <summary>
+    /// When true, workbook::load only reads the package structure, the workbook
+    /// part, shared strings, styles and document properties. The part of each
+    /// worksheet, along with its comments, and images such as the thumbnail are
+    /// read the first time they are accessed through the workbook, e.g. by
+    /// workbook::sheet_by_title or by iterating over the worksheets. Everything
+    /// left is read before the workbook is copied or saved. A package loaded
+    /// from a stream or a vector is copied so that neither has to outlive the
+    /// workbook. Since const accessors such as workbook::sheet_by_index may then
+    /// parse a part, they can throw load errors and they change the workbook.
+    /// The workbook serializes these reads, but reading one worksheet can update
+    /// state shared with the others (e.g. the shared strings), so every
+    /// worksheet should be accessed once before the workbook is used from
+    /// several threads. The default is false.
+    /// </summary>
+    bool lazy_parts;
+};
+
+} // namespace xlnt
@@ -0,0 +1,71 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <vector>
+
+#include <xlnt/xlnt_config.hpp>
+#include <xlnt/cell/index_types.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// Selects the cells of a worksheet which streaming_workbook_reader returns.
+/// Cells outside the plan are skipped as they are parsed, before their values
+/// are decoded, and reading stops once a row after last_row is reached.
+/// </summary>
+class XLNT_API read_plan
+{
+public:
+    /// <summary>
+    /// Constructs a plan which reads every cell of a worksheet.
+    /// </summary>
+    read_plan();
+
+    /// <summary>
+    /// Returns true if this plan reads every cell of a worksheet.
+    /// </summary>
+    bool reads_everything() const;
+
+    /// <summary>
+    /// The columns whose cells are read. Empty, the default, reads every column.
+    /// </summary>
+    std::vector<column_t> columns;
+
+    /// <summary>
+    /// The first row whose cells are read. The properties of rows before it
+    /// are not read either.
+    /// </summary>
+    row_t first_row;
+
+    /// <summary>
+    /// The last row whose cells are read. Once a row after it is reached, the
+    /// rest of the worksheet isn't read, so the worksheet returned by
+    /// streaming_workbook_reader::end_worksheet won't have properties stored
+    /// after its cells, like merged cells and page setup.
+    /// </summary>
+    row_t last_row;
+};
+
+} // namespace xlnt
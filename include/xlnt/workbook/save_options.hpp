@@ -0,0 +1,92 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+
+/// <summary>
+/// Options controlling how workbook::save writes an XLSX package.
+/// </summary>
+class XLNT_API save_options
+{
+public:
+    /// <summary>
+    /// Enumerates the strategies deflate can use to find matches. These
+    /// correspond to the zlib strategies of the same names.
+    /// </summary>
+    enum class compression_strategy
+    {
+        default_strategy,
+        filtered,
+        huffman_only,
+        run_length,
+        fixed
+    };
+
+    /// <summary>
+    /// Constructs options which save the workbook the same way as
+    /// workbook::save without options.
+    /// </summary>
+    save_options();
+
+    /// <summary>
+    /// The deflate compression level from 0 (no compression) to 9 (smallest
+    /// output). The default is 6.
+    /// </summary>
+    int compression_level;
+
+    /// <summary>
+    /// The deflate strategy. The default is compression_strategy::default_strategy.
+    /// </summary>
+    compression_strategy strategy;
+
+    /// <summary>
+    /// If true, parts are stored in the package without any compression and
+    /// compression_level and strategy are ignored. This is the fastest way to
+    /// write a file which will be read again soon. The default is false.
+    /// </summary>
+    bool store_only;
+
+    /// <summary>
+    /// The number of threads used to compress package parts. When this isn't 1,
+    /// each part is written to memory and deflated on a worker pool while the
+    /// next part is being written, and parts larger than a few hundred kilobytes
+    /// are split into blocks which are deflated in parallel. 1 compresses each
+    /// part on the calling thread as it is written and 0 uses one thread per
+    /// hardware core.
+    /// </summary>
+    std::size_t compression_threads;
+
+    /// <summary>
+    /// The size in bytes of the buffers used to compress each part. 0 (the
+    /// default) uses 64 KiB. Otherwise it must be at least 16.
+    /// </summary>
+    std::size_t zip_buffer_size;
+};
+
+} // namespace xlnt
@@ -38,9 +38,13 @@ class parser;
 namespace xlnt {
 
 class cell;
+struct cell_view;
+class load_options;
 template<typename T>
 class optional;
 class path;
+class read_plan;
+class rich_text;
 class workbook;
 class worksheet;
 
@@ -71,6 +75,14 @@ public:
     /// </summary>
     cell read_cell();
 
+    /// <summary>
+    /// Reads the remaining cells of the current worksheet, calling visitor once
+    /// per cell in document order. Unlike read_cell, no cell objects are created
+    /// and no memory is allocated per cell. The view passed to visitor is only
+    /// valid until it returns.
+    /// </summary>
+    void visit_cells(const std::function<void(const cell_view &)> &visitor);
+
     bool has_worksheet(const std::string &name);
 
     /// <summary>
@@ -79,6 +91,14 @@ public:
     /// </summary>
     void begin_worksheet(const std::string &name);
 
+    /// <summary>
+    /// Begins reading of the worksheet with the given title, returning only the
+    /// cells selected by plan from read_cell and visit_cells. Cells outside the
+    /// plan are skipped without their values being parsed and has_cell returns
+    /// false once a row after the plan is reached.
+    /// </summary>
+    void begin_worksheet(const std::string &name, const read_plan &plan);
+
     /// <summary>
     /// Ends reading of the current worksheet in the workbook and optionally
     /// returns a worksheet object corresponding to the worksheet with the title
@@ -112,6 +132,13 @@ public:
     /// </summary>
     void open(const path &filename);
 
+    /// <summary>
+    /// Interprets file with the given filename as an XLSX file and sets the
+    /// content of this workbook to match that file, reading it as described
+    /// by options. If options.memory_map is set, the file is mapped into memory.
+    /// </summary>
+    void open(const path &filename, const load_options &options);
+
     /// <summary>
     /// Interprets data in stream as an XLSX file and sets the content of this
     /// workbook to match that file.
@@ -129,6 +156,19 @@ public:
     /// </summary>
     std::vector<std::string> sheet_titles();
 
+    /// <summary>
+    /// Returns the shared string at index, such as the shared_string of a
+    /// cell_view passed to a visit_cells visitor. The runs of formatted strings
+    /// are only decoded when they are requested. Throws invalid_parameter if
+    /// index is out of range.
+    /// </summary>
+    rich_text shared_string(std::size_t index);
+
+    /// <summary>
+    /// Returns the text of the shared string at index without its formatting.
+    /// </summary>
+    std::string shared_string_text(std::size_t index);
+
 private:
     std::string worksheet_rel_id_;
     std::unique_ptr<detail::xlsx_consumer> consumer_;
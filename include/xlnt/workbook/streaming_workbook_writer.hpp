@@ -38,6 +38,8 @@ namespace xlnt {
 
 class cell;
 class cell_reference;
+class format;
+class save_options;
 class worksheet;
 
 namespace detail {
@@ -56,20 +58,62 @@ public:
     /// <summary>
     /// Finishes writing of the remaining contents of the workbook and closes
     /// currently open write stream. This will be called automatically by the
-    /// destructor if it hasn't already been called manually.
+    /// destructor if it hasn't already been called manually. If writing a cell
+    /// has failed, the workbook is left unfinished and an exception is thrown
+    /// here instead, except from the destructor where it is dropped.
     /// </summary>
     void close();
 
     /// <summary>
-    /// Writes a cell to the currently active worksheet at the position given by
-    /// ref and with the given value. ref should be to the right of or below
-    /// the previously written cell.
+    /// Begins a cell in the current worksheet at the position given by ref and
+    /// returns it so that its value and format can be set. The cell is written
+    /// when the next cell is added, so ref must be to the right of or below the
+    /// previously added cell. If no worksheet has been added yet, cells are
+    /// written to a worksheet titled "Sheet1".
     /// </summary>
     cell add_cell(const cell_reference &ref);
 
+    /// <summary>
+    /// Writes a number cell at ref using the format registered as format_id.
+    /// Format id 0 is the default format.
+    /// </summary>
+    void add_number(const cell_reference &ref, double value, std::size_t format_id = 0);
+
+    /// <summary>
+    /// Writes a string cell at ref using the format registered as format_id.
+    /// The string is appended to a shared string table held in a temporary file
+    /// rather than in memory.
+    /// </summary>
+    void add_string(const cell_reference &ref, const std::string &value, std::size_t format_id = 0);
+
+    /// <summary>
+    /// Writes a boolean cell at ref using the format registered as format_id.
+    /// </summary>
+    void add_boolean(const cell_reference &ref, bool value, std::size_t format_id = 0);
+
+    /// <summary>
+    /// Writes a cell at ref with the given formula and no cached value using
+    /// the format registered as format_id.
+    /// </summary>
+    void add_formula(const cell_reference &ref, const std::string &formula, std::size_t format_id = 0);
+
+    /// <summary>
+    /// Creates a new format in the workbook's stylesheet. Once it has been
+    /// configured, pass it to register_format to get the id used to apply it.
+    /// </summary>
+    format create_format();
+
+    /// <summary>
+    /// Returns the id of format for use with add_number, add_string,
+    /// add_boolean, and add_formula. Changing the format after registering it
+    /// may give it a different id.
+    /// </summary>
+    std::size_t register_format(const format &format);
+
     /// <summary>
     /// Ends writing of data to the current sheet and begins writing a new sheet
-    /// with the given title.
+    /// with the given title. Properties of the returned worksheet, like column
+    /// widths and views, can be set until the first cell is added to it.
     /// </summary>
     worksheet add_worksheet(const std::string &title);
 
@@ -104,6 +148,30 @@ public:
     /// </summary>
     void open(std::ostream &stream);
 
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and saves the bytes into
+    /// byte vector data, writing it as described by options.
+    /// </summary>
+    void open(std::vector<std::uint8_t> &data, const save_options &options);
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and saves the data into a file
+    /// named filename, writing it as described by options.
+    /// </summary>
+    void open(const std::string &filename, const save_options &options);
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and saves the data into a file
+    /// named filename, writing it as described by options.
+    /// </summary>
+    void open(const xlnt::path &filename, const save_options &options);
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and saves the data into stream,
+    /// writing it as described by options.
+    /// </summary>
+    void open(std::ostream &stream, const save_options &options);
+
     std::unique_ptr<xlnt::detail::xlsx_producer> producer_;
     std::unique_ptr<workbook> workbook_;
     std::unique_ptr<std::ostream> stream_;
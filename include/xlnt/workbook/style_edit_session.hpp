@@ -0,0 +1,66 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+
+class workbook;
+
+/// <summary>
+/// Defers style garbage collection for a workbook while it is in scope.
+/// Normally every change to the formatting of a cell looks for formats and
+/// style components that are no longer used, so styling many cells costs
+/// time proportional to the number of cells times the number of formats.
+/// While a session is open unused formats are kept and a single collection
+/// runs when the outermost session ends or when the workbook is saved.
+/// Format indices may therefore include unused formats until then.
+/// </summary>
+class XLNT_API style_edit_session
+{
+public:
+    /// <summary>
+    /// Starts a session on the given workbook which must outlive it.
+    /// Sessions may be nested.
+    /// </summary>
+    explicit style_edit_session(workbook &wb);
+
+    /// <summary>
+    /// Ends the session, collecting unused styles if it was the outermost one.
+    /// </summary>
+    ~style_edit_session();
+
+    style_edit_session(const style_edit_session &) = delete;
+    style_edit_session &operator=(const style_edit_session &) = delete;
+
+private:
+    /// <summary>
+    /// The workbook whose stylesheet is being edited.
+    /// </summary>
+    workbook *workbook_;
+};
+
+} // namespace xlnt
@@ -52,6 +52,7 @@ class drawing;
 class fill;
 class font;
 class format;
+class load_options;
 class rich_text;
 class manifest;
 class metadata_property;
@@ -63,6 +64,7 @@ class protection;
 class range;
 class range_reference;
 class relationship;
+class save_options;
 class streaming_workbook_reader;
 class style;
 class style_serializer;
@@ -79,6 +81,7 @@ namespace detail {
 
 struct stylesheet;
 struct workbook_impl;
+struct worksheet_impl;
 class xlsx_consumer;
 class xlsx_producer;
 
@@ -186,6 +189,8 @@ public:
     /// Returns the worksheet with the given name. This may throw an exception
     /// if the sheet isn't found. Use workbook::contains(const std::string &)
     /// to make sure the sheet exists before calling this method.
+    /// A worksheet of a workbook loaded with load_options::lazy_parts is read
+    /// here on first access, so this may also throw if its part is invalid.
     /// </summary>
     worksheet sheet_by_title(const std::string &title);
 
@@ -193,30 +198,40 @@ public:
     /// Returns the worksheet with the given name. This may throw an exception
     /// if the sheet isn't found. Use workbook::contains(const std::string &)
     /// to make sure the sheet exists before calling this method.
+    /// A worksheet of a workbook loaded with load_options::lazy_parts is read
+    /// here on first access, so this may also throw if its part is invalid.
     /// </summary>
     const worksheet sheet_by_title(const std::string &title) const;
 
     /// <summary>
     /// Returns the worksheet at the given index. This will throw an exception
     /// if index is greater than or equal to the number of sheets in this workbook.
+    /// A worksheet of a workbook loaded with load_options::lazy_parts is read
+    /// here on first access, so this may also throw if its part is invalid.
     /// </summary>
     worksheet sheet_by_index(std::size_t index);
 
     /// <summary>
     /// Returns the worksheet at the given index. This will throw an exception
     /// if index is greater than or equal to the number of sheets in this workbook.
+    /// A worksheet of a workbook loaded with load_options::lazy_parts is read
+    /// here on first access, so this may also throw if its part is invalid.
     /// </summary>
     const worksheet sheet_by_index(std::size_t index) const;
 
     /// <summary>
     /// Returns the worksheet with a sheetId of id. Sheet IDs are arbitrary numbers
     /// that uniquely identify a sheet. Most users won't need this.
+    /// A worksheet of a workbook loaded with load_options::lazy_parts is read
+    /// here on first access, so this may also throw if its part is invalid.
     /// </summary>
     worksheet sheet_by_id(std::size_t id);
 
     /// <summary>
     /// Returns the worksheet with a sheetId of id. Sheet IDs are arbitrary numbers
     /// that uniquely identify a sheet. Most users won't need this.
+    /// A worksheet of a workbook loaded with load_options::lazy_parts is read
+    /// here on first access, so this may also throw if its part is invalid.
     /// </summary>
     const worksheet sheet_by_id(std::size_t id) const;
 
@@ -485,6 +500,30 @@ public:
     /// </summary>
     void save(std::ostream &stream, const std::string &password) const;
 
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and loads the bytes into
+    /// byte vector data, writing it as described by options.
+    /// </summary>
+    void save(std::vector<std::uint8_t> &data, const save_options &options) const;
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and saves the bytes into
+    /// file with the given filename, writing it as described by options.
+    /// </summary>
+    void save(const std::string &filename, const save_options &options) const;
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and saves the bytes into
+    /// file with the given filename, writing it as described by options.
+    /// </summary>
+    void save(const xlnt::path &filename, const save_options &options) const;
+
+    /// <summary>
+    /// Serializes the workbook into an XLSX file and saves the data into
+    /// stream, writing it as described by options.
+    /// </summary>
+    void save(std::ostream &stream, const save_options &options) const;
+
     /// <summary>
     /// Interprets byte vector data as an XLSX file and sets the content of this
     /// workbook to match that file.
@@ -547,6 +586,32 @@ public:
     /// </summary>
     void load(std::istream &stream, const std::string &password);
 
+    /// <summary>
+    /// Interprets byte vector data as an XLSX file and sets the content of this
+    /// workbook to match that file, reading it as described by options.
+    /// </summary>
+    void load(const std::vector<std::uint8_t> &data, const load_options &options);
+
+    /// <summary>
+    /// Interprets file with the given filename as an XLSX file and sets the
+    /// content of this workbook to match that file, reading it as described
+    /// by options.
+    /// </summary>
+    void load(const std::string &filename, const load_options &options);
+
+    /// <summary>
+    /// Interprets file with the given filename as an XLSX file and sets the
+    /// content of this workbook to match that file, reading it as described
+    /// by options.
+    /// </summary>
+    void load(const xlnt::path &filename, const load_options &options);
+
+    /// <summary>
+    /// Interprets data in stream as an XLSX file and sets the content of this
+    /// workbook to match that file, reading it as described by options.
+    /// </summary>
+    void load(std::istream &stream, const load_options &options);
+
     // View
 
     /// <summary>
@@ -727,6 +792,7 @@ public:
 
     /// <summary>
     /// Returns a vector of bytes representing the workbook's thumbnail.
+    /// Images of a workbook loaded with load_options::lazy_parts are read here.
     /// </summary>
     const std::vector<std::uint8_t> &thumbnail() const;
 
@@ -778,7 +844,9 @@ public:
     bool operator!=(const workbook &rhs) const;
 
 private:
+    friend class cell;
     friend class streaming_workbook_reader;
+    friend class style_edit_session;
     friend class worksheet;
     friend class detail::xlsx_consumer;
     friend class detail::xlsx_producer;
@@ -839,6 +907,17 @@ private:
     /// </summary>
     void swap(workbook &other);
 
+    /// <summary>
+    /// Reads the part of the worksheet with implementation ws if it was left
+    /// unread by load_options::lazy_parts.
+    /// </summary>
+    void read_deferred_sheet(detail::worksheet_impl *ws) const;
+
+    /// <summary>
+    /// Reads every part left unread by load_options::lazy_parts.
+    /// </summary>
+    void read_deferred_parts() const;
+
     /// <summary>
     /// An opaque pointer to a structure that holds all of the data relating to this workbook.
     /// </summary>
@@ -333,6 +333,46 @@ void append_cell_value(arrow::ArrayBuilder *builder, arrow::Type::type type, xln
     }
 }
 
+// Appends serials, the raw values of the cells in a date column, to builder
+// after converting them all at once to Arrow's Unix-based representation.
+void append_dates(arrow::ArrayBuilder *builder, arrow::Type::type type,
+    const std::vector<double> &serials, xlnt::calendar base_date)
+{
+    auto status = arrow::Status::OK();
+
+    if (type == arrow::Type::DATE32)
+    {
+        std::vector<std::int32_t> days;
+        xlnt::date::unix_days_from_numbers(serials, base_date, days);
+        status = static_cast<arrow::Date32Builder *>(builder)
+            ->Append(days.data(), static_cast<std::int64_t>(days.size()));
+    }
+    else
+    {
+        std::vector<std::int64_t> microseconds;
+        xlnt::datetime::unix_microseconds_from_numbers(serials, base_date, microseconds);
+
+        // serials are rounded to the nearest microsecond above, which is then
+        // truncated to whole milliseconds towards negative infinity so that
+        // times before the epoch don't move forward
+        std::vector<std::int64_t> milliseconds(microseconds.size());
+
+        for (std::size_t i = 0; i < microseconds.size(); ++i)
+        {
+            const auto value = microseconds[i];
+            milliseconds[i] = (value - ((value % 1000) + 1000) % 1000) / 1000;
+        }
+
+        status = static_cast<arrow::Date64Builder *>(builder)
+            ->Append(milliseconds.data(), static_cast<std::int64_t>(milliseconds.size()));
+    }
+
+    if (!status.ok())
+    {
+        throw xlnt::exception("Append failed");
+    }
+}
+
 pybind11::handle read_batch(xlnt::streaming_workbook_reader &reader,
     pybind11::object pyschema, int max_rows)
 {
@@ -355,6 +395,9 @@ pybind11::handle read_batch(xlnt::streaming_workbook_reader &reader,
         builders.emplace_back(make_array_builder(type));
     }
 
+    // date columns are collected and converted in bulk once the batch is read
+    auto date_serials = std::vector<std::vector<double>>(column_types.size());
+    auto base_date = xlnt::calendar::windows_1900;
     auto row = std::int64_t(0);
 
     while (row < max_rows)
@@ -370,12 +413,27 @@ pybind11::handle read_batch(xlnt::streaming_workbook_reader &reader,
             auto column_type = column_types.at(zero_indexed_column);
             auto builder = builders.at(zero_indexed_column).get();
 
+            if (column_type == arrow::Type::DATE32 || column_type == arrow::Type::DATE64)
+            {
+                base_date = cell.base_date();
+                date_serials.at(zero_indexed_column).push_back(cell.value<double>());
+                continue;
+            }
+
             append_cell_value(builder, column_type, cell);
         }
 
         ++row;
     }
 
+    for (std::size_t column = 0; column < column_types.size(); ++column)
+    {
+        if (!date_serials[column].empty())
+        {
+            append_dates(builders[column].get(), column_types[column], date_serials[column], base_date);
+        }
+    }
+
     auto columns = std::vector<std::shared_ptr<arrow::Array>>();
 
     for (auto &builder : builders)
@@ -437,7 +495,8 @@ PYBIND11_MODULE(lib, m)
             })
         .def("format_is_date", [](xlnt::cell &cell)
             {
-                return cell.has_format() && cell.number_format().is_date_format();
+                // a lookup in the classification made when the stylesheet was read
+                return cell.is_date();
             });
 
     pybind11::enum_<xlnt::cell::type>(cell, "Type")
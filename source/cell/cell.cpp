@@ -24,12 +24,15 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <sstream>
 
 #include <detail/implementations/cell_impl.hpp>
 #include <detail/implementations/format_impl.hpp>
 #include <detail/implementations/stylesheet.hpp>
+#include <detail/implementations/workbook_impl.hpp>
 #include <detail/implementations/worksheet_impl.hpp>
+#include <detail/serialization/shared_string_arena.hpp>
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/cell/cell_reference.hpp>
 #include <xlnt/cell/comment.hpp>
@@ -205,44 +208,44 @@ void cell::value(std::nullptr_t)
 
 void cell::value(bool boolean_value)
 {
-    d_->type_ = type::boolean;
+    d_->type(type::boolean);
     d_->value_numeric_ = boolean_value ? 1.0 : 0.0;
 }
 
 void cell::value(int int_value)
 {
     d_->value_numeric_ = static_cast<double>(int_value);
-    d_->type_ = type::number;
+    d_->type(type::number);
 }
 
 void cell::value(unsigned int int_value)
 {
     d_->value_numeric_ = static_cast<double>(int_value);
-    d_->type_ = type::number;
+    d_->type(type::number);
 }
 
 void cell::value(long long int int_value)
 {
     d_->value_numeric_ = static_cast<double>(int_value);
-    d_->type_ = type::number;
+    d_->type(type::number);
 }
 
 void cell::value(unsigned long long int int_value)
 {
     d_->value_numeric_ = static_cast<double>(int_value);
-    d_->type_ = type::number;
+    d_->type(type::number);
 }
 
 void cell::value(float float_value)
 {
     d_->value_numeric_ = static_cast<double>(float_value);
-    d_->type_ = type::number;
+    d_->type(type::number);
 }
 
 void cell::value(double float_value)
 {
     d_->value_numeric_ = static_cast<double>(float_value);
-    d_->type_ = type::number;
+    d_->type(type::number);
 }
 
 void cell::value(const std::string &s)
@@ -254,7 +257,7 @@ void cell::value(const rich_text &text)
 {
     check_string(text.plain_text());
 
-    d_->type_ = type::shared_string;
+    d_->type(type::shared_string);
     d_->value_numeric_ = static_cast<double>(workbook().add_shared_string(text));
 }
 
@@ -265,38 +268,36 @@ void cell::value(const char *c)
 
 void cell::value(const cell c)
 {
-    d_->type_ = c.d_->type_;
+    d_->type(c.d_->type_);
     d_->value_numeric_ = c.d_->value_numeric_;
-    d_->value_text_ = c.d_->value_text_;
-    d_->hyperlink_ = c.d_->hyperlink_;
-    d_->formula_ = c.d_->formula_;
+    d_->copy_side_data(*c.d_);
     d_->format_ = c.d_->format_;
 }
 
 void cell::value(const date &d)
 {
-    d_->type_ = type::number;
+    d_->type(type::number);
     d_->value_numeric_ = d.to_number(base_date());
     number_format(number_format::date_yyyymmdd2());
 }
 
 void cell::value(const datetime &d)
 {
-    d_->type_ = type::number;
+    d_->type(type::number);
     d_->value_numeric_ = d.to_number(base_date());
     number_format(number_format::date_datetime());
 }
 
 void cell::value(const time &t)
 {
-    d_->type_ = type::number;
+    d_->type(type::number);
     d_->value_numeric_ = t.to_number();
     number_format(number_format::date_time6());
 }
 
 void cell::value(const timedelta &t)
 {
-    d_->type_ = type::number;
+    d_->type(type::number);
     d_->value_numeric_ = t.to_number();
     number_format(xlnt::number_format("[hh]:mm:ss"));
 }
@@ -325,7 +326,7 @@ bool cell::is_date() const
 {
     return data_type() == type::number
         && has_format()
-        && number_format().is_date_format();
+        && d_->format_->parent->format_kind(d_->format_->id) == detail::number_format_kind::date;
 }
 
 cell_reference cell::reference() const
@@ -345,23 +346,29 @@ bool cell::operator==(const cell &comparand) const
 
 cell &cell::operator=(const cell &rhs)
 {
+    // retype before taking rhs's parent so the count of the owning store is kept
+    d_->type(rhs.d_->type_);
     d_->column_ = rhs.d_->column_;
     d_->format_ = rhs.d_->format_;
-    d_->formula_ = rhs.d_->formula_;
-    d_->hyperlink_ = rhs.d_->hyperlink_;
+    d_->has_formula_ = rhs.d_->has_formula_;
+    d_->has_hyperlink_ = rhs.d_->has_hyperlink_;
+    d_->has_comment_ = rhs.d_->has_comment_;
     d_->is_merged_ = rhs.d_->is_merged_;
     d_->parent_ = rhs.d_->parent_;
     d_->row_ = rhs.d_->row_;
-    d_->type_ = rhs.d_->type_;
     d_->value_numeric_ = rhs.d_->value_numeric_;
-    d_->value_text_ = rhs.d_->value_text_;
 
     return *this;
 }
 
 std::string cell::hyperlink() const
 {
-    return d_->hyperlink_.get();
+    if (!has_hyperlink())
+    {
+        throw invalid_attribute();
+    }
+
+    return d_->hyperlink();
 }
 
 void cell::hyperlink(const std::string &hyperlink)
@@ -372,7 +379,7 @@ void cell::hyperlink(const std::string &hyperlink)
         throw invalid_parameter();
     }
 
-    d_->hyperlink_ = hyperlink;
+    d_->hyperlink(hyperlink);
 }
 
 void cell::hyperlink(const std::string &url, const std::string &display)
@@ -395,11 +402,11 @@ void cell::formula(const std::string &formula)
 
     if (formula[0] == '=')
     {
-        d_->formula_ = formula.substr(1);
+        d_->formula(formula.substr(1));
     }
     else
     {
-        d_->formula_ = formula;
+        d_->formula(formula);
     }
 
     data_type(type::number);
@@ -409,19 +416,24 @@ void cell::formula(const std::string &formula)
 
 bool cell::has_formula() const
 {
-    return d_->formula_.is_set();
+    return d_->has_formula_;
 }
 
 std::string cell::formula() const
 {
-    return d_->formula_.get();
+    if (!has_formula())
+    {
+        throw invalid_attribute();
+    }
+
+    return d_->formula();
 }
 
 void cell::clear_formula()
 {
     if (has_formula())
     {
-        d_->formula_.clear();
+        d_->clear_formula();
         worksheet().garbage_collect_formulae();
     }
 }
@@ -433,8 +445,8 @@ void cell::error(const std::string &error)
         throw invalid_data_type();
     }
 
-    d_->value_text_.plain_text(error);
-    d_->type_ = type::error;
+    d_->text(rich_text(error));
+    d_->type(type::error);
 }
 
 cell cell::offset(int column, int row)
@@ -488,7 +500,7 @@ cell::type cell::data_type() const
 
 void cell::data_type(type t)
 {
-    d_->type_ = t;
+    d_->type(t);
 }
 
 number_format cell::computed_number_format() const
@@ -524,8 +536,8 @@ protection cell::computed_protection() const
 void cell::clear_value()
 {
     d_->value_numeric_ = 0;
-    d_->value_text_.clear();
-    d_->type_ = cell::type::empty;
+    d_->clear_text();
+    d_->type(cell::type::empty);
     clear_formula();
 }
 
@@ -634,6 +646,14 @@ void cell::protection(const class protection &protection_)
 template <>
 XLNT_API std::string cell::value() const
 {
+    const auto &arena = workbook().d_->shared_string_arena_;
+
+    // streamed strings without runs are returned without building a rich_text
+    if (arena && data_type() == cell::type::shared_string)
+    {
+        return arena->text(static_cast<std::size_t>(d_->value_numeric_));
+    }
+
     return value<rich_text>().plain_text();
 }
 
@@ -642,10 +662,13 @@ XLNT_API rich_text cell::value() const
 {
     if (data_type() == cell::type::shared_string)
     {
-        return workbook().shared_strings().at(static_cast<std::size_t>(d_->value_numeric_));
+        const auto index = static_cast<std::size_t>(d_->value_numeric_);
+        const auto &arena = workbook().d_->shared_string_arena_;
+
+        return arena ? arena->at(index) : workbook().shared_strings().at(index);
     }
 
-    return d_->value_text_;
+    return d_->text();
 }
 
 bool cell::has_value() const
@@ -678,7 +701,7 @@ std::string cell::to_string() const
 
 bool cell::has_format() const
 {
-    return d_->format_.is_set();
+    return d_->format_ != nullptr;
 }
 
 void cell::format(const class format new_format)
@@ -728,7 +751,7 @@ void cell::value(const std::string &value_string, bool infer_type)
     if (percentage.first)
     {
         d_->value_numeric_ = percentage.second;
-        d_->type_ = cell::type::number;
+        d_->type(cell::type::number);
         number_format(xlnt::number_format::percentage());
     }
     else
@@ -737,7 +760,7 @@ void cell::value(const std::string &value_string, bool infer_type)
 
         if (time.first)
         {
-            d_->type_ = cell::type::number;
+            d_->type(cell::type::number);
             number_format(number_format::date_time6());
             d_->value_numeric_ = time.second.to_number();
         }
@@ -748,7 +771,7 @@ void cell::value(const std::string &value_string, bool infer_type)
             if (numeric.first)
             {
                 d_->value_numeric_ = numeric.second;
-                d_->type_ = cell::type::number;
+                d_->type(cell::type::number);
             }
         }
     }
@@ -757,7 +780,7 @@ void cell::value(const std::string &value_string, bool infer_type)
 void cell::clear_format()
 {
     format().d_->references -= format().d_->references > 0 ? 1 : 0;
-    d_->format_.clear();
+    d_->format_ = nullptr;
 }
 
 void cell::clear_style()
@@ -808,22 +831,22 @@ bool cell::has_style() const
 
 format cell::modifiable_format()
 {
-    if (!d_->format_.is_set())
+    if (d_->format_ == nullptr)
     {
         throw invalid_attribute();
     }
 
-    return xlnt::format(d_->format_.get());
+    return xlnt::format(d_->format_);
 }
 
 const format cell::format() const
 {
-    if (!d_->format_.is_set())
+    if (d_->format_ == nullptr)
     {
         throw invalid_attribute();
     }
 
-    return xlnt::format(d_->format_.get());
+    return xlnt::format(d_->format_);
 }
 
 alignment cell::alignment() const
@@ -858,14 +881,14 @@ protection cell::protection() const
 
 bool cell::has_hyperlink() const
 {
-    return d_->hyperlink_.is_set();
+    return d_->has_hyperlink_;
 }
 
 // comment
 
 bool cell::has_comment()
 {
-    return d_->comment_.is_set();
+    return d_->has_comment_;
 }
 
 void cell::clear_comment()
@@ -873,7 +896,7 @@ void cell::clear_comment()
     if (has_comment())
     {
         d_->parent_->comments_.erase(reference().to_string());
-        d_->comment_.clear();
+        d_->has_comment_ = false;
     }
 }
 
@@ -884,7 +907,7 @@ class comment cell::comment()
         throw xlnt::exception("cell has no comment");
     }
 
-    return *d_->comment_.get();
+    return d_->parent_->comments_.at(reference().to_string());
 }
 
 void cell::comment(const std::string &text, const std::string &author)
@@ -900,23 +923,17 @@ void cell::comment(const std::string &text, const class font &comment_font, cons
 
 void cell::comment(const class comment &new_comment)
 {
-    if (has_comment())
-    {
-        *d_->comment_.get() = new_comment;
-    }
-    else
-    {
-        d_->parent_->comments_[reference().to_string()] = new_comment;
-        d_->comment_.set(&d_->parent_->comments_[reference().to_string()]);
-    }
+    auto &stored_comment = d_->parent_->comments_[reference().to_string()];
+    stored_comment = new_comment;
+    d_->has_comment_ = true;
 
     // offset comment 5 pixels down and 5 pixels right of the top right corner of the cell
     auto cell_position = anchor();
     cell_position.first += static_cast<int>(width()) + 5;
     cell_position.second += 5;
 
-    d_->comment_.get()->position(cell_position.first, cell_position.second);
-    d_->comment_.get()->size(200, 100);
+    stored_comment.position(cell_position.first, cell_position.second);
+    stored_comment.size(200, 100);
 
     worksheet().register_comments_in_manifest();
 }
@@ -22,7 +22,7 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
-#include <cctype>
+#include <cstring>
 
 #include <xlnt/cell/cell_reference.hpp>
 #include <xlnt/utils/exceptions.hpp>
@@ -32,6 +32,8 @@
 
 namespace xlnt {
 
+const std::size_t cell_reference::max_string_length;
+
 std::size_t cell_reference_hash::operator()(const cell_reference &k) const
 {
     return k.row() * constants::max_column().index + k.column_index();
@@ -51,15 +53,12 @@ cell_reference::cell_reference()
 }
 
 cell_reference::cell_reference(const std::string &string)
+    : cell_reference(from_chars(string.data(), string.data() + string.size()))
 {
-    auto split = split_reference(string, absolute_column_, absolute_row_);
-
-    column(split.first);
-    row(split.second);
 }
 
 cell_reference::cell_reference(const char *reference_string)
-    : cell_reference(std::string(reference_string))
+    : cell_reference(from_chars(reference_string, reference_string + std::strlen(reference_string)))
 {
 }
 
@@ -82,23 +81,43 @@ range_reference cell_reference::operator,(const xlnt::cell_reference &other) con
 
 std::string cell_reference::to_string() const
 {
-    std::string string_representation;
+    char buffer[max_string_length];
+
+    return std::string(buffer, to_chars(buffer));
+}
+
+std::size_t cell_reference::to_chars(char *buffer) const
+{
+    auto out = buffer;
 
     if (absolute_column_)
     {
-        string_representation.append("$");
+        *out++ = '$';
     }
 
-    string_representation.append(column_.column_string());
+    out += column_t::column_string_from_index(column_.index, out);
 
     if (absolute_row_)
     {
-        string_representation.append("$");
+        *out++ = '$';
     }
 
-    string_representation.append(std::to_string(row_));
+    char digits[10];
+    std::size_t digit_count = 0;
+    auto row = row_;
+
+    do
+    {
+        digits[digit_count++] = static_cast<char>('0' + row % 10);
+        row /= 10;
+    } while (row > 0);
+
+    while (digit_count > 0)
+    {
+        *out++ = digits[--digit_count];
+    }
 
-    return string_representation;
+    return static_cast<std::size_t>(out - buffer);
 }
 
 range_reference cell_reference::to_range() const
@@ -115,76 +134,52 @@ std::pair<std::string, row_t> cell_reference::split_reference(const std::string
 std::pair<std::string, row_t> cell_reference::split_reference(
     const std::string &reference_string, bool &absolute_column, bool &absolute_row)
 {
-    absolute_column = false;
-    absolute_row = false;
+    const auto reference = from_chars(reference_string.data(), reference_string.data() + reference_string.size());
 
-    // Convert a coordinate string like 'B12' to a tuple ('B', 12)
-    bool column_part = true;
+    absolute_column = reference.column_absolute();
+    absolute_row = reference.row_absolute();
 
-    std::string column_string;
+    return {reference.column().column_string(), reference.row()};
+}
 
-    for (auto character : reference_string)
-    {
-        auto upper = static_cast<char>(std::toupper(static_cast<std::uint8_t>(character)));
-
-        if (std::isalpha(character))
-        {
-            if (column_part)
-            {
-                column_string.append(1, upper);
-            }
-            else
-            {
-                throw invalid_cell_reference(reference_string);
-            }
-        }
-        else if (character == '$')
-        {
-            if (column_part)
-            {
-                if (column_string.empty())
-                {
-                    column_string.append(1, upper);
-                }
-                else
-                {
-                    column_part = false;
-                }
-            }
-        }
-        else
-        {
-            if (column_part)
-            {
-                column_part = false;
-            }
-            else if (!std::isdigit(character))
-            {
-                throw invalid_cell_reference(reference_string);
-            }
-        }
-    }
+cell_reference cell_reference::from_chars(const char *first, const char *last)
+{
+    auto position = first;
+    const auto absolute_column = position != last && *position == '$';
+    position += absolute_column ? 1 : 0;
 
-    std::string row_string = reference_string.substr(column_string.length());
+    const auto column_first = position;
 
-    if (row_string.length() == 0)
+    while (position != last && ((*position >= 'A' && *position <= 'Z') || (*position >= 'a' && *position <= 'z')))
     {
-        throw invalid_cell_reference(reference_string);
+        ++position;
     }
 
-    if (column_string[0] == '$')
+    const auto column_last = position;
+    const auto absolute_row = position != last && *position == '$';
+    position += absolute_row ? 1 : 0;
+
+    const auto row_first = position;
+    std::uint64_t row = 0;
+
+    while (position != last && *position >= '0' && *position <= '9' && row <= constants::max_row())
     {
-        absolute_row = true;
-        column_string = column_string.substr(1);
+        row = row * 10 + static_cast<std::uint64_t>(*position - '0');
+        ++position;
     }
 
-    if (row_string[0] == '$')
+    if (column_first == column_last || row_first == position || position != last || row > constants::max_row())
     {
-        absolute_column = true;
-        row_string = row_string.substr(1);
+        throw invalid_cell_reference(std::string(first, last));
     }
 
-    return {column_string, std::stoi(row_string)};
+    cell_reference result;
+    result.column_ = column_t::column_index_from_string(column_first, column_last);
+    result.row_ = static_cast<row_t>(row);
+    result.absolute_column_ = absolute_column;
+    result.absolute_row_ = absolute_row;
+
+    return result;
 }
 
 bool cell_reference::column_absolute() const
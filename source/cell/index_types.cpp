@@ -21,7 +21,7 @@
 //
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
-#include <cctype>
+#include <cstddef>
 
 #include <xlnt/cell/index_types.hpp>
 #include <xlnt/utils/exceptions.hpp>
@@ -29,37 +29,51 @@
 
 namespace xlnt {
 
+const std::size_t column_t::max_string_length;
+
 column_t::index_t column_t::column_index_from_string(const std::string &column_string)
 {
-    if (column_string.length() > 3 || column_string.empty())
+    return column_index_from_string(column_string.data(), column_string.data() + column_string.size());
+}
+
+column_t::index_t column_t::column_index_from_string(const char *first, const char *last)
+{
+    const auto length = last - first;
+
+    if (length > static_cast<std::ptrdiff_t>(max_string_length) || length <= 0)
     {
         throw invalid_column_index();
     }
 
     column_t::index_t column_index = 0;
-    int place = 1;
 
-    for (int i = static_cast<int>(column_string.length()) - 1; i >= 0; i--)
+    for (; first != last; ++first)
     {
-        if (!std::isalpha(column_string[static_cast<std::size_t>(i)]))
+        // clearing bit 5 maps lower case ASCII letters to upper case
+        const auto letter = static_cast<unsigned char>(*first) & ~0x20u;
+
+        if (letter < 'A' || letter > 'Z')
         {
             throw invalid_column_index();
         }
 
-        auto char_index = std::toupper(column_string[static_cast<std::size_t>(i)]) - 'A';
-
-        column_index += static_cast<column_t::index_t>((char_index + 1) * place);
-        place *= 26;
+        column_index = column_index * 26 + (letter - 'A' + 1);
     }
 
     return column_index;
 }
 
-// Convert a column number into a column letter (3 -> 'C')
-// Right shift the column col_idx by 26 to find column letters in reverse
-// order.These numbers are 1 - based, and can be converted to ASCII
-// ordinals by adding 64.
 std::string column_t::column_string_from_index(column_t::index_t column_index)
+{
+    char buffer[max_string_length];
+
+    return std::string(buffer, column_string_from_index(column_index, buffer));
+}
+
+// Convert a column number into a column letter (3 -> 'C')
+// Each letter is a base 26 digit from 1 (A) to 26 (Z) with no zero, so
+// one is borrowed before each division.
+std::size_t column_t::column_string_from_index(column_t::index_t column_index, char *buffer)
 {
     // these indicies corrospond to A->ZZZ and include all allowed
     // columns
@@ -68,25 +82,22 @@ std::string column_t::column_string_from_index(column_t::index_t column_index)
         throw invalid_column_index();
     }
 
-    int temp = static_cast<int>(column_index);
-    std::string column_letter = "";
+    char reversed[max_string_length];
+    std::size_t length = 0;
 
-    while (temp > 0)
+    while (column_index > 0)
     {
-        int quotient = temp / 26, remainder = temp % 26;
-
-        // check for exact division and borrow if needed
-        if (remainder == 0)
-        {
-            quotient -= 1;
-            remainder = 26;
-        }
+        --column_index;
+        reversed[length++] = static_cast<char>('A' + column_index % 26);
+        column_index /= 26;
+    }
 
-        column_letter = std::string(1, char(remainder + 64)) + column_letter;
-        temp = quotient;
+    for (std::size_t i = 0; i < length; ++i)
+    {
+        buffer[i] = reversed[length - 1 - i];
     }
 
-    return column_letter;
+    return length;
 }
 
 column_t::column_t()
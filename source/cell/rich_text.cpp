@@ -21,6 +21,7 @@
 //
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
+#include <functional>
 #include <numeric>
 
 #include <xlnt/cell/rich_text.hpp>
@@ -97,4 +98,23 @@ bool rich_text::operator!=(const std::string &rhs) const
     return !(*this == rhs);
 }
 
+std::size_t rich_text_hash::operator()(const rich_text &k) const
+{
+    static std::hash<std::string> hasher;
+
+    if (k.runs_.size() == 1)
+    {
+        return hasher(k.runs_.front().first);
+    }
+
+    std::size_t seed = k.runs_.size();
+
+    for (const auto &run : k.runs_)
+    {
+        seed ^= hasher(run.first) + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+    }
+
+    return seed;
+}
+
 } // namespace xlnt
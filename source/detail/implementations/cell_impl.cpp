@@ -24,19 +24,129 @@
 #include <xlnt/worksheet/worksheet.hpp>
 
 #include "cell_impl.hpp"
+#include "worksheet_impl.hpp"
 
 namespace xlnt {
 namespace detail {
 
 cell_impl::cell_impl()
-    : type_(cell_type::empty),
-      parent_(nullptr),
+    : parent_(nullptr),
+      value_numeric_(0),
+      format_(nullptr),
       column_(1),
       row_(1),
+      type_(cell_type::empty),
       is_merged_(false),
-      value_numeric_(0)
+      has_formula_(false),
+      has_hyperlink_(false),
+      has_comment_(false)
 {
 }
 
+std::uint64_t cell_impl::key() const
+{
+    return cell_store::key(row_, column_.index);
+}
+
+void cell_impl::type(cell_type t)
+{
+    if (parent_ != nullptr)
+    {
+        parent_->cell_map_.type_changed(type_, t);
+    }
+
+    type_ = t;
+}
+
+const std::string &cell_impl::formula() const
+{
+    return parent_->cell_map_.formulae.at(key());
+}
+
+void cell_impl::formula(const std::string &formula)
+{
+    parent_->cell_map_.formulae[key()] = formula;
+    has_formula_ = true;
+}
+
+void cell_impl::clear_formula()
+{
+    if (!has_formula_) return;
+
+    parent_->cell_map_.formulae.erase(key());
+    has_formula_ = false;
+}
+
+const std::string &cell_impl::hyperlink() const
+{
+    return parent_->cell_map_.hyperlinks.at(key());
+}
+
+void cell_impl::hyperlink(const std::string &hyperlink)
+{
+    parent_->cell_map_.hyperlinks[key()] = hyperlink;
+    has_hyperlink_ = true;
+}
+
+void cell_impl::clear_hyperlink()
+{
+    if (!has_hyperlink_) return;
+
+    parent_->cell_map_.hyperlinks.erase(key());
+    has_hyperlink_ = false;
+}
+
+const rich_text &cell_impl::text() const
+{
+    static const auto *empty = new rich_text();
+
+    const auto &text_values = parent_->cell_map_.text_values;
+    const auto match = text_values.find(key());
+
+    return match == text_values.end() ? *empty : match->second;
+}
+
+void cell_impl::text(const rich_text &text)
+{
+    parent_->cell_map_.text_values[key()] = text;
+}
+
+void cell_impl::clear_text()
+{
+    parent_->cell_map_.text_values.erase(key());
+}
+
+void cell_impl::copy_side_data(const cell_impl &other)
+{
+    // take copies first since other may live in the same tables
+    const auto &other_text_values = other.parent_->cell_map_.text_values;
+    const auto other_text = other_text_values.find(other.key());
+    const auto has_text = other_text != other_text_values.end();
+    const auto text_copy = has_text ? other_text->second : rich_text();
+    const auto formula_copy = other.has_formula_ ? other.formula() : std::string();
+    const auto hyperlink_copy = other.has_hyperlink_ ? other.hyperlink() : std::string();
+    const auto other_has_formula = other.has_formula_;
+    const auto other_has_hyperlink = other.has_hyperlink_;
+
+    clear_text();
+    clear_formula();
+    clear_hyperlink();
+
+    if (has_text)
+    {
+        text(text_copy);
+    }
+
+    if (other_has_formula)
+    {
+        formula(formula_copy);
+    }
+
+    if (other_has_hyperlink)
+    {
+        hyperlink(hyperlink_copy);
+    }
+}
+
 } // namespace detail
 } // namespace xlnt
@@ -23,13 +23,12 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 
 #include <xlnt/cell/cell_type.hpp>
-#include <xlnt/cell/comment.hpp>
 #include <xlnt/cell/rich_text.hpp>
 #include <xlnt/cell/index_types.hpp>
-#include <xlnt/utils/optional.hpp>
 
 namespace xlnt {
 namespace detail {
@@ -37,26 +36,68 @@ namespace detail {
 struct format_impl;
 struct worksheet_impl;
 
+/// <summary>
+/// The per-cell record stored by cell_store. Only data that nearly every cell
+/// has is kept here. Formulae, hyperlinks, text values and comments are kept
+/// in side tables owned by the parent worksheet and the has_*_ flags below
+/// record whether an entry exists.
+/// </summary>
 struct cell_impl
 {
     cell_impl();
 
-    cell_type type_;
+    /// <summary>
+    /// The key of this cell in the side tables of its worksheet's cell_store.
+    /// </summary>
+    std::uint64_t key() const;
+
+    /// <summary>
+    /// Changes the type of this cell, keeping the shared string usage count
+    /// of the parent worksheet's cell_store up to date.
+    /// </summary>
+    void type(cell_type t);
+
+    const std::string &formula() const;
+
+    void formula(const std::string &formula);
+
+    void clear_formula();
+
+    const std::string &hyperlink() const;
+
+    void hyperlink(const std::string &hyperlink);
+
+    void clear_hyperlink();
+
+    /// <summary>
+    /// The value of an inline string, formula string or error cell.
+    /// </summary>
+    const rich_text &text() const;
+
+    void text(const rich_text &text);
+
+    void clear_text();
+
+    /// <summary>
+    /// Copies the side table entries of other into this cell's entries.
+    /// </summary>
+    void copy_side_data(const cell_impl &other);
 
     worksheet_impl *parent_;
 
+    double value_numeric_;
+
+    format_impl *format_;
+
     column_t column_;
     row_t row_;
 
-    bool is_merged_;
-
-    rich_text value_text_;
-    double value_numeric_;
+    cell_type type_;
 
-    optional<std::string> formula_;
-    optional<std::string> hyperlink_;
-    optional<format_impl *> format_;
-    optional<comment *> comment_;
+    bool is_merged_;
+    bool has_formula_;
+    bool has_hyperlink_;
+    bool has_comment_;
 };
 
 } // namespace detail
@@ -0,0 +1,366 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <algorithm>
+
+#include <detail/implementations/cell_store.hpp>
+
+namespace {
+
+// Blocks start small so that a workbook with many tiny sheets stays cheap
+// and double up to this many cells for large sheets.
+const std::size_t initial_block_size = 64;
+const std::size_t max_block_size = 8192;
+
+using entry = xlnt::detail::cell_store::entry;
+
+bool entry_before(const entry &e, xlnt::column_t::index_t column)
+{
+    return e.column < column;
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+cell_store::cell_store()
+    : block_size_(0),
+      block_used_(0),
+      size_(0),
+      shared_string_count_(0),
+      lowest_row_(0),
+      highest_row_(0),
+      lowest_column_(0),
+      highest_column_(0),
+      bounds_stale_(false)
+{
+}
+
+cell_store::cell_store(const cell_store &other)
+    : cell_store()
+{
+    *this = other;
+}
+
+cell_store &cell_store::operator=(const cell_store &other)
+{
+    if (this == &other) return *this;
+
+    clear();
+    rows_.reserve(other.rows_.size());
+
+    for (const auto &other_row : other.rows_)
+    {
+        auto &row = rows_[other_row.first];
+        row.reserve(other_row.second.size());
+
+        for (const auto &other_entry : other_row.second)
+        {
+            auto cell = allocate();
+            *cell = *other_entry.cell;
+            row.push_back({other_entry.column, cell});
+        }
+    }
+
+    size_ = other.size_;
+    shared_string_count_ = other.shared_string_count_;
+    lowest_row_ = other.lowest_row_;
+    highest_row_ = other.highest_row_;
+    lowest_column_ = other.lowest_column_;
+    highest_column_ = other.highest_column_;
+    bounds_stale_ = other.bounds_stale_;
+    formulae = other.formulae;
+    hyperlinks = other.hyperlinks;
+    text_values = other.text_values;
+
+    return *this;
+}
+
+bool cell_store::empty() const
+{
+    return size_ == 0;
+}
+
+std::size_t cell_store::size() const
+{
+    return size_;
+}
+
+row_t cell_store::lowest_row() const
+{
+    refresh_bounds();
+    return lowest_row_;
+}
+
+row_t cell_store::highest_row() const
+{
+    refresh_bounds();
+    return highest_row_;
+}
+
+column_t::index_t cell_store::lowest_column() const
+{
+    refresh_bounds();
+    return lowest_column_;
+}
+
+column_t::index_t cell_store::highest_column() const
+{
+    refresh_bounds();
+    return highest_column_;
+}
+
+std::size_t cell_store::shared_string_count() const
+{
+    return shared_string_count_;
+}
+
+void cell_store::type_changed(cell_type before, cell_type after)
+{
+    if (before == after) return;
+
+    if (before == cell_type::shared_string)
+    {
+        --shared_string_count_;
+    }
+    else if (after == cell_type::shared_string)
+    {
+        ++shared_string_count_;
+    }
+}
+
+void cell_store::reserve(std::size_t rows)
+{
+    rows_.reserve(rows);
+}
+
+cell_impl *cell_store::find(row_t row, column_t::index_t column) const
+{
+    const auto row_match = rows_.find(row);
+    if (row_match == rows_.end()) return nullptr;
+
+    const auto &cells = row_match->second;
+    const auto match = std::lower_bound(cells.begin(), cells.end(), column, entry_before);
+    if (match == cells.end() || match->column != column) return nullptr;
+
+    return match->cell;
+}
+
+std::pair<cell_impl *, bool> cell_store::emplace(row_t row, column_t::index_t column)
+{
+    auto &cells = rows_[row];
+
+    // cells are usually added left to right so check the end first
+    auto position = cells.end();
+
+    if (!cells.empty() && cells.back().column >= column)
+    {
+        position = std::lower_bound(cells.begin(), cells.end(), column, entry_before);
+
+        if (position->column == column)
+        {
+            return {position->cell, false};
+        }
+    }
+
+    auto cell = allocate();
+    cell->row_ = row;
+    cell->column_ = column;
+    cells.insert(position, {column, cell});
+    extend_bounds(row, column);
+    ++size_;
+
+    return {cell, true};
+}
+
+bool cell_store::erase(row_t row, column_t::index_t column)
+{
+    auto row_match = rows_.find(row);
+    if (row_match == rows_.end()) return false;
+
+    auto &cells = row_match->second;
+    auto match = std::lower_bound(cells.begin(), cells.end(), column, entry_before);
+    if (match == cells.end() || match->column != column) return false;
+
+    erase_side_data(key(row, column));
+    release(match->cell);
+    cells.erase(match);
+    shrink_bounds(row, column, column);
+    --size_;
+
+    if (cells.empty())
+    {
+        rows_.erase(row_match);
+    }
+
+    return true;
+}
+
+void cell_store::erase_row(row_t row)
+{
+    auto row_match = rows_.find(row);
+    if (row_match == rows_.end()) return;
+
+    for (auto &cell : row_match->second)
+    {
+        erase_side_data(key(row, cell.column));
+        release(cell.cell);
+        --size_;
+    }
+
+    shrink_bounds(row, row_match->second.front().column, row_match->second.back().column);
+    rows_.erase(row_match);
+}
+
+void cell_store::clear()
+{
+    rows_.clear();
+    blocks_.clear();
+    free_.clear();
+    block_size_ = 0;
+    block_used_ = 0;
+    size_ = 0;
+    shared_string_count_ = 0;
+    bounds_stale_ = false;
+    formulae.clear();
+    hyperlinks.clear();
+    text_values.clear();
+}
+
+const cell_store::row_block *cell_store::row(row_t row) const
+{
+    const auto match = rows_.find(row);
+    return match == rows_.end() ? nullptr : &match->second;
+}
+
+std::vector<row_t> cell_store::rows() const
+{
+    std::vector<row_t> indices;
+    indices.reserve(rows_.size());
+
+    for (const auto &row : rows_)
+    {
+        indices.push_back(row.first);
+    }
+
+    std::sort(indices.begin(), indices.end());
+
+    return indices;
+}
+
+cell_impl *cell_store::allocate()
+{
+    if (!free_.empty())
+    {
+        auto cell = free_.back();
+        free_.pop_back();
+
+        return cell;
+    }
+
+    if (block_used_ == block_size_)
+    {
+        block_size_ = block_size_ == 0 ? initial_block_size : std::min(block_size_ * 2, max_block_size);
+        blocks_.emplace_back(new cell_impl[block_size_]);
+        block_used_ = 0;
+    }
+
+    return &blocks_.back()[block_used_++];
+}
+
+void cell_store::release(cell_impl *cell)
+{
+    type_changed(cell->type_, cell_type::empty);
+    *cell = cell_impl();
+    free_.push_back(cell);
+}
+
+void cell_store::extend_bounds(row_t row, column_t::index_t column)
+{
+    if (size_ == 0)
+    {
+        lowest_row_ = highest_row_ = row;
+        lowest_column_ = highest_column_ = column;
+        bounds_stale_ = false;
+
+        return;
+    }
+
+    // a stale box is recomputed from scratch later so there is nothing to extend
+    if (bounds_stale_) return;
+
+    lowest_row_ = std::min(lowest_row_, row);
+    highest_row_ = std::max(highest_row_, row);
+    lowest_column_ = std::min(lowest_column_, column);
+    highest_column_ = std::max(highest_column_, column);
+}
+
+void cell_store::shrink_bounds(row_t row, column_t::index_t first_column, column_t::index_t last_column)
+{
+    if (row == lowest_row_ || row == highest_row_
+        || first_column == lowest_column_ || last_column == highest_column_)
+    {
+        bounds_stale_ = true;
+    }
+}
+
+void cell_store::refresh_bounds() const
+{
+    if (!bounds_stale_ || rows_.empty()) return;
+
+    auto first = true;
+
+    for (const auto &row : rows_)
+    {
+        const auto front = row.second.front().column;
+        const auto back = row.second.back().column;
+
+        if (first)
+        {
+            lowest_row_ = highest_row_ = row.first;
+            lowest_column_ = front;
+            highest_column_ = back;
+            first = false;
+
+            continue;
+        }
+
+        lowest_row_ = std::min(lowest_row_, row.first);
+        highest_row_ = std::max(highest_row_, row.first);
+        lowest_column_ = std::min(lowest_column_, front);
+        highest_column_ = std::max(highest_column_, back);
+    }
+
+    bounds_stale_ = false;
+}
+
+void cell_store::erase_side_data(std::uint64_t cell_key)
+{
+    formulae.erase(cell_key);
+    hyperlinks.erase(cell_key);
+    text_values.erase(cell_key);
+}
+
+} // namespace detail
+} // namespace xlnt
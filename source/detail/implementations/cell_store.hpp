@@ -0,0 +1,246 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <detail/implementations/cell_impl.hpp>
+#include <xlnt/cell/index_types.hpp>
+#include <xlnt/cell/rich_text.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Row-major storage for the cells of a worksheet. Cells are allocated from
+/// blocks that never move so that pointers held by xlnt::cell stay valid as
+/// the sheet grows. Each row keeps a column-sorted index into those blocks.
+/// Data that only a few cells carry (formulae, hyperlinks and text values)
+/// lives in sparse side tables keyed by cell_store::key instead of in every
+/// cell_impl. The bounding box of the stored cells is maintained as cells are
+/// added and only recomputed lazily after a cell on its edge has been removed.
+/// </summary>
+class cell_store
+{
+public:
+    /// <summary>
+    /// One cell in a row, ordered by column.
+    /// </summary>
+    struct entry
+    {
+        column_t::index_t column;
+        cell_impl *cell;
+    };
+
+    using row_block = std::vector<entry>;
+
+    cell_store();
+
+    cell_store(const cell_store &other);
+
+    cell_store &operator=(const cell_store &other);
+
+    /// <summary>
+    /// Packs a row and column into the key used by the side tables.
+    /// </summary>
+    static std::uint64_t key(row_t row, column_t::index_t column)
+    {
+        return (static_cast<std::uint64_t>(row) << 32) | column;
+    }
+
+    /// <summary>
+    /// Returns true if no cells are stored.
+    /// </summary>
+    bool empty() const;
+
+    /// <summary>
+    /// Returns the number of stored cells.
+    /// </summary>
+    std::size_t size() const;
+
+    /// <summary>
+    /// Returns the lowest row index of any stored cell. The store must not be empty.
+    /// </summary>
+    row_t lowest_row() const;
+
+    /// <summary>
+    /// Returns the highest row index of any stored cell. The store must not be empty.
+    /// </summary>
+    row_t highest_row() const;
+
+    /// <summary>
+    /// Returns the lowest column index of any stored cell. The store must not be empty.
+    /// </summary>
+    column_t::index_t lowest_column() const;
+
+    /// <summary>
+    /// Returns the highest column index of any stored cell. The store must not be empty.
+    /// </summary>
+    column_t::index_t highest_column() const;
+
+    /// <summary>
+    /// Returns the number of stored cells of type cell_type::shared_string.
+    /// </summary>
+    std::size_t shared_string_count() const;
+
+    /// <summary>
+    /// Updates the shared string usage count when a stored cell changes type.
+    /// Called by cell_impl::type.
+    /// </summary>
+    void type_changed(cell_type before, cell_type after);
+
+    /// <summary>
+    /// Prepares the store to hold at least the given number of rows.
+    /// </summary>
+    void reserve(std::size_t rows);
+
+    /// <summary>
+    /// Returns the cell at the given coordinates or nullptr if it doesn't exist.
+    /// </summary>
+    cell_impl *find(row_t row, column_t::index_t column) const;
+
+    /// <summary>
+    /// Returns the cell at the given coordinates, creating it if it doesn't exist.
+    /// The second member of the result is true if the cell was created.
+    /// </summary>
+    std::pair<cell_impl *, bool> emplace(row_t row, column_t::index_t column);
+
+    /// <summary>
+    /// Removes the cell at the given coordinates along with its side table entries.
+    /// Returns false if there was no such cell.
+    /// </summary>
+    bool erase(row_t row, column_t::index_t column);
+
+    /// <summary>
+    /// Removes every cell in the given row.
+    /// </summary>
+    void erase_row(row_t row);
+
+    /// <summary>
+    /// Removes every cell.
+    /// </summary>
+    void clear();
+
+    /// <summary>
+    /// Returns the column-sorted cells of row or nullptr if the row is empty.
+    /// </summary>
+    const row_block *row(row_t row) const;
+
+    /// <summary>
+    /// Returns the indices of all non-empty rows in ascending order.
+    /// </summary>
+    std::vector<row_t> rows() const;
+
+    /// <summary>
+    /// Calls f with each stored cell. Rows are visited in no particular order.
+    /// </summary>
+    template <typename Function>
+    void for_each(Function f) const
+    {
+        for (const auto &row : rows_)
+        {
+            for (const auto &cell : row.second)
+            {
+                f(*cell.cell);
+            }
+        }
+    }
+
+    /// <summary>
+    /// Calls f with each non-empty row index and its column-sorted cells.
+    /// Rows are visited in no particular order.
+    /// </summary>
+    template <typename Function>
+    void for_each_row(Function f) const
+    {
+        for (const auto &row : rows_)
+        {
+            f(row.first, row.second);
+        }
+    }
+
+    /// <summary>
+    /// Formula text of cells for which cell_impl::has_formula_ is set.
+    /// </summary>
+    std::unordered_map<std::uint64_t, std::string> formulae;
+
+    /// <summary>
+    /// Targets of cells for which cell_impl::has_hyperlink_ is set.
+    /// </summary>
+    std::unordered_map<std::uint64_t, std::string> hyperlinks;
+
+    /// <summary>
+    /// Values of inline string, formula string and error cells.
+    /// </summary>
+    std::unordered_map<std::uint64_t, rich_text> text_values;
+
+private:
+    cell_impl *allocate();
+
+    void release(cell_impl *cell);
+
+    void erase_side_data(std::uint64_t cell_key);
+
+    void extend_bounds(row_t row, column_t::index_t column);
+
+    void shrink_bounds(row_t row, column_t::index_t first_column, column_t::index_t last_column);
+
+    void refresh_bounds() const;
+
+    std::unordered_map<row_t, row_block> rows_;
+
+    std::vector<std::unique_ptr<cell_impl[]>> blocks_;
+
+    std::size_t block_size_;
+
+    std::size_t block_used_;
+
+    std::vector<cell_impl *> free_;
+
+    std::size_t size_;
+
+    std::size_t shared_string_count_;
+
+    mutable row_t lowest_row_;
+
+    mutable row_t highest_row_;
+
+    mutable column_t::index_t lowest_column_;
+
+    mutable column_t::index_t highest_column_;
+
+    /// <summary>
+    /// Set when a cell on the edge of the bounds was removed. The bounds are
+    /// then recomputed on the next query.
+    /// </summary>
+    mutable bool bounds_stale_;
+};
+
+} // namespace detail
+} // namespace xlnt
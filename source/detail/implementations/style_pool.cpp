@@ -0,0 +1,185 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <functional>
+#include <string>
+
+#include <detail/implementations/format_impl.hpp>
+#include <detail/implementations/style_pool.hpp>
+
+namespace {
+
+void combine(std::size_t &seed, std::size_t value)
+{
+    seed ^= value + 0x9e3779b9 + (seed << 6) + (seed >> 2);
+}
+
+template <typename T>
+void combine(std::size_t &seed, const xlnt::optional<T> &value)
+{
+    combine(seed, value.is_set() ? static_cast<std::size_t>(value.get()) + 1 : 0);
+}
+
+void combine(std::size_t &seed, const std::string &value)
+{
+    combine(seed, std::hash<std::string>()(value));
+}
+
+void combine(std::size_t &seed, double value)
+{
+    // operator== treats 0.0 and -0.0 alike
+    combine(seed, value == 0.0 ? std::size_t(0) : std::hash<double>()(value));
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+std::size_t style_hash::operator()(const alignment &value) const
+{
+    std::size_t seed = 0;
+
+    combine(seed, value.horizontal());
+    combine(seed, value.vertical());
+    combine(seed, value.indent());
+    combine(seed, value.rotation());
+    combine(seed, static_cast<std::size_t>(value.wrap()));
+    combine(seed, static_cast<std::size_t>(value.shrink()));
+
+    return seed;
+}
+
+std::size_t style_hash::operator()(const border &value) const
+{
+    std::size_t seed = 0;
+
+    for (auto side : border::all_sides())
+    {
+        const auto property = value.side(side);
+
+        if (!property.is_set())
+        {
+            combine(seed, std::size_t(0));
+            continue;
+        }
+
+        combine(seed, property.get().style());
+        combine(seed, property.get().color().is_set() ? (*this)(property.get().color().get()) : 0);
+    }
+
+    return seed;
+}
+
+std::size_t style_hash::operator()(const color &value) const
+{
+    std::size_t seed = static_cast<std::size_t>(value.type());
+
+    combine(seed, static_cast<std::size_t>(value.auto_()));
+
+    switch (value.type())
+    {
+    case color_type::indexed:
+        combine(seed, value.indexed().index());
+        break;
+    case color_type::theme:
+        combine(seed, value.theme().index());
+        break;
+    case color_type::rgb:
+        combine(seed, value.rgb().hex_string());
+        break;
+    }
+
+    return seed;
+}
+
+std::size_t style_hash::operator()(const fill &value) const
+{
+    std::size_t seed = static_cast<std::size_t>(value.type());
+
+    if (value.type() == fill_type::pattern)
+    {
+        const auto pattern = value.pattern_fill();
+
+        combine(seed, static_cast<std::size_t>(pattern.type()));
+        combine(seed, pattern.foreground().is_set() ? (*this)(pattern.foreground().get()) : 0);
+        combine(seed, pattern.background().is_set() ? (*this)(pattern.background().get()) : 0);
+    }
+
+    return seed;
+}
+
+std::size_t style_hash::operator()(const font &value) const
+{
+    std::size_t seed = 0;
+
+    combine(seed, value.name());
+    combine(seed, value.size());
+    combine(seed, static_cast<std::size_t>(value.bold()));
+    combine(seed, static_cast<std::size_t>(value.italic()));
+    combine(seed, static_cast<std::size_t>(value.underline()));
+    combine(seed, static_cast<std::size_t>(value.strikethrough()));
+    combine(seed, static_cast<std::size_t>(value.superscript()));
+    combine(seed, value.has_color() ? (*this)(value.color()) : 0);
+
+    return seed;
+}
+
+std::size_t style_hash::operator()(const number_format &value) const
+{
+    return std::hash<std::string>()(value.format_string());
+}
+
+std::size_t style_hash::operator()(const protection &value) const
+{
+    return static_cast<std::size_t>(value.locked()) * 2 + static_cast<std::size_t>(value.hidden());
+}
+
+std::size_t style_hash::operator()(const format_impl &value) const
+{
+    std::size_t seed = 0;
+
+    combine(seed, value.alignment_id);
+    combine(seed, value.border_id);
+    combine(seed, value.fill_id);
+    combine(seed, value.font_id);
+    combine(seed, value.number_format_id);
+    combine(seed, value.protection_id);
+
+    combine(seed, (static_cast<std::size_t>(value.alignment_applied) << 0)
+        | (static_cast<std::size_t>(value.border_applied) << 1)
+        | (static_cast<std::size_t>(value.fill_applied) << 2)
+        | (static_cast<std::size_t>(value.font_applied) << 3)
+        | (static_cast<std::size_t>(value.number_format_applied) << 4)
+        | (static_cast<std::size_t>(value.protection_applied) << 5)
+        | (static_cast<std::size_t>(value.pivot_button_) << 6)
+        | (static_cast<std::size_t>(value.quote_prefix_) << 7));
+
+    combine(seed, value.style.is_set() ? std::hash<std::string>()(value.style.get()) + 1 : 0);
+
+    return seed;
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,205 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <unordered_map>
+#include <vector>
+
+#include <xlnt/styles/alignment.hpp>
+#include <xlnt/styles/border.hpp>
+#include <xlnt/styles/fill.hpp>
+#include <xlnt/styles/font.hpp>
+#include <xlnt/styles/number_format.hpp>
+#include <xlnt/styles/protection.hpp>
+
+namespace xlnt {
+namespace detail {
+
+struct format_impl;
+
+/// <summary>
+/// Hashes the style components kept in a stylesheet. Only properties compared
+/// by each type's operator== are used so that equal components hash equally.
+/// </summary>
+struct style_hash
+{
+    std::size_t operator()(const alignment &value) const;
+    std::size_t operator()(const border &value) const;
+    std::size_t operator()(const color &value) const;
+    std::size_t operator()(const fill &value) const;
+    std::size_t operator()(const font &value) const;
+    std::size_t operator()(const number_format &value) const;
+    std::size_t operator()(const protection &value) const;
+    std::size_t operator()(const format_impl &value) const;
+};
+
+/// <summary>
+/// An interned list of style components. Each component is identified by its
+/// position, as in the stylesheet XML, and a hash index over the contents
+/// finds the id of an existing equal component in constant time.
+/// Components can't be modified in place since that would invalidate the index.
+/// </summary>
+template <typename T>
+class style_pool
+{
+public:
+    using const_iterator = typename std::vector<T>::const_iterator;
+
+    /// <summary>
+    /// Returns the lowest id of a component equal to item, adding item to the
+    /// end of the pool if there is none. If added isn't null, it is set to
+    /// whether item was added.
+    /// </summary>
+    std::size_t find_or_add(const T &item, bool *added = nullptr)
+    {
+        const auto hash = style_hash()(item);
+        const auto candidates = index_.equal_range(hash);
+        auto match = items_.size();
+
+        for (auto candidate = candidates.first; candidate != candidates.second; ++candidate)
+        {
+            if (candidate->second < match && items_[candidate->second] == item)
+            {
+                match = candidate->second;
+            }
+        }
+
+        if (added != nullptr)
+        {
+            *added = match == items_.size();
+        }
+
+        if (match == items_.size())
+        {
+            items_.push_back(item);
+            index_.emplace(hash, match);
+        }
+
+        return match;
+    }
+
+    /// <summary>
+    /// Adds item to the end of the pool even if an equal component exists, as
+    /// when reading a stylesheet whose ids must be preserved.
+    /// </summary>
+    void push_back(const T &item)
+    {
+        index_.emplace(style_hash()(item), items_.size());
+        items_.push_back(item);
+    }
+
+    /// <summary>
+    /// Removes the components for which keep is false, preserving the order of
+    /// the rest. Returns the new id of each previously kept component by its old id.
+    /// </summary>
+    std::vector<std::size_t> compact(const std::vector<bool> &keep)
+    {
+        std::vector<std::size_t> id_map(items_.size(), 0);
+        std::size_t kept = 0;
+
+        for (std::size_t id = 0; id < items_.size(); ++id)
+        {
+            id_map[id] = kept;
+
+            if (id < keep.size() && keep[id])
+            {
+                if (kept != id)
+                {
+                    items_[kept] = items_[id];
+                }
+
+                ++kept;
+            }
+        }
+
+        if (kept != items_.size())
+        {
+            items_.erase(items_.begin() + static_cast<typename std::vector<T>::difference_type>(kept), items_.end());
+            reindex();
+        }
+
+        return id_map;
+    }
+
+    void clear()
+    {
+        items_.clear();
+        index_.clear();
+    }
+
+    const T &operator[](std::size_t id) const
+    {
+        return items_[id];
+    }
+
+    const T &at(std::size_t id) const
+    {
+        return items_.at(id);
+    }
+
+    const T &back() const
+    {
+        return items_.back();
+    }
+
+    std::size_t size() const
+    {
+        return items_.size();
+    }
+
+    bool empty() const
+    {
+        return items_.empty();
+    }
+
+    const_iterator begin() const
+    {
+        return items_.begin();
+    }
+
+    const_iterator end() const
+    {
+        return items_.end();
+    }
+
+private:
+    void reindex()
+    {
+        index_.clear();
+
+        for (std::size_t id = 0; id < items_.size(); ++id)
+        {
+            index_.emplace(style_hash()(items_[id]), id);
+        }
+    }
+
+    std::vector<T> items_;
+
+    std::unordered_multimap<std::size_t, std::size_t> index_;
+};
+
+} // namespace detail
+} // namespace xlnt
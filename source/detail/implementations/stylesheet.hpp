@@ -23,13 +23,17 @@
 // @author: see AUTHORS file
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
 #include <list>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <detail/implementations/conditional_format_impl.hpp>
 #include <detail/implementations/format_impl.hpp>
 #include <detail/implementations/style_impl.hpp>
+#include <detail/implementations/style_pool.hpp>
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/styles/conditional_format.hpp>
 #include <xlnt/styles/format.hpp>
@@ -42,32 +46,211 @@
 namespace xlnt {
 namespace detail {
 
+/// <summary>
+/// Indexes over stylesheet::format_impls. They point into the list they were
+/// built from so a copy starts out empty and is rebuilt from its own list.
+/// </summary>
+struct format_lookup
+{
+    format_lookup() = default;
+
+    format_lookup(const format_lookup &)
+    {
+    }
+
+    format_lookup &operator=(const format_lookup &)
+    {
+        by_id.clear();
+        by_hash.clear();
+
+        return *this;
+    }
+
+    /// <summary>
+    /// format_impls by id. Rebuilt by index_formats when it falls out of step with the list.
+    /// </summary>
+    std::vector<format_impl *> by_id;
+
+    /// <summary>
+    /// format_impls by style_hash so that find_format doesn't compare every format.
+    /// </summary>
+    std::unordered_multimap<std::size_t, format_impl *> by_hash;
+};
+
+/// <summary>
+/// The style edit sessions open on a stylesheet. Sessions belong to the workbook
+/// they were opened on so a copy of the stylesheet starts out with none.
+/// </summary>
+struct edit_session_state
+{
+    edit_session_state() = default;
+
+    edit_session_state(const edit_session_state &)
+    {
+    }
+
+    edit_session_state &operator=(const edit_session_state &)
+    {
+        sessions = 0;
+        garbage_pending = false;
+
+        return *this;
+    }
+
+    /// <summary>
+    /// The number of open sessions. Garbage collection is deferred while this is non-zero.
+    /// </summary>
+    std::size_t sessions = 0;
+
+    /// <summary>
+    /// True if a garbage collection was skipped while a session was open.
+    /// </summary>
+    bool garbage_pending = false;
+};
+
+/// <summary>
+/// How the number format of a format presents the numbers it's applied to.
+/// </summary>
+enum class number_format_kind : std::uint8_t
+{
+    number,
+    date,
+    timedelta
+};
+
 struct stylesheet
 {
     class format create_format(bool default_format)
     {
-		format_impls.push_back(format_impl());
-		auto &impl = format_impls.back();
+        format_impl pattern;
 
-		impl.parent = this;
-		impl.id = format_impls.size() - 1;
-        
-        impl.border_id = 0;
-        impl.fill_id = 0;
-        impl.font_id = 0;
-        impl.number_format_id = 0;
-        
+        pattern.parent = this;
+        pattern.id = 0;
+        pattern.border_id = 0;
+        pattern.fill_id = 0;
+        pattern.font_id = 0;
+        pattern.number_format_id = 0;
+
+        auto &impl = add_format_impl(pattern);
         impl.references = default_format ? 1 : 0;
-        
+
         return xlnt::format(&impl);
     }
 
     class xlnt::format format(std::size_t index)
     {
-        auto iter = format_impls.begin();
-        std::advance(iter, static_cast<std::list<format_impl>::difference_type>(index));
+        index_formats();
+
+        return xlnt::format(formats.by_id.at(index));
+    }
+
+    /// <summary>
+    /// Appends a copy of pattern to format_impls with the next id and indexes it.
+    /// </summary>
+    format_impl &add_format_impl(const format_impl &pattern)
+    {
+        index_formats();
+
+        format_impls.push_back(pattern);
+        auto &impl = format_impls.back();
+
+        impl.parent = this;
+        impl.id = format_impls.size() - 1;
+        impl.references = 0;
+
+        formats.by_id.push_back(&impl);
+        formats.by_hash.emplace(style_hash()(impl), &impl);
+        classify_formats();
+
+        return impl;
+    }
+
+    /// <summary>
+    /// Returns the format with the lowest id equal to pattern or nullptr if there is none.
+    /// </summary>
+    format_impl *find_format(const format_impl &pattern)
+    {
+        index_formats();
+
+        format_impl *match = nullptr;
+        const auto candidates = formats.by_hash.equal_range(style_hash()(pattern));
+
+        for (auto candidate = candidates.first; candidate != candidates.second; ++candidate)
+        {
+            if ((match == nullptr || candidate->second->id < match->id) && *candidate->second == pattern)
+            {
+                match = candidate->second;
+            }
+        }
+
+        return match;
+    }
+
+    /// <summary>
+    /// Brings formats.by_id and formats.by_hash up to date with format_impls after
+    /// formats were added to the list directly, as when reading a stylesheet.
+    /// </summary>
+    void index_formats()
+    {
+        if (formats.by_id.size() == format_impls.size()) return;
+
+        renumber_formats();
+        rehash_formats();
+        classify_formats();
+    }
+
+    /// <summary>
+    /// Sets the id of each format to its position in format_impls and rebuilds formats.by_id.
+    /// </summary>
+    void renumber_formats()
+    {
+        formats.by_id.clear();
+        format_kinds.clear();
 
-        return xlnt::format(&*iter);
+        for (auto &impl : format_impls)
+        {
+            impl.id = formats.by_id.size();
+            formats.by_id.push_back(&impl);
+        }
+    }
+
+    /// <summary>
+    /// Rebuilds formats.by_hash from the current contents of every format.
+    /// </summary>
+    void rehash_formats()
+    {
+        formats.by_hash.clear();
+
+        for (auto &impl : format_impls)
+        {
+            formats.by_hash.emplace(style_hash()(impl), &impl);
+        }
+    }
+
+    /// <summary>
+    /// Removes impl from formats.by_hash before one of its compared members is
+    /// changed in place. reindex_format must be called afterwards.
+    /// </summary>
+    void unindex_format(format_impl *impl)
+    {
+        const auto candidates = formats.by_hash.equal_range(style_hash()(*impl));
+
+        for (auto candidate = candidates.first; candidate != candidates.second; ++candidate)
+        {
+            if (candidate->second == impl)
+            {
+                formats.by_hash.erase(candidate);
+                return;
+            }
+        }
+    }
+
+    /// <summary>
+    /// Adds impl back to formats.by_hash after it was changed in place.
+    /// </summary>
+    void reindex_format(format_impl *impl)
+    {
+        formats.by_hash.emplace(style_hash()(*impl), impl);
     }
 
     class style create_style(const std::string &name)
@@ -162,81 +345,178 @@ struct stylesheet
 		return style_impls.count(name) > 0;
 	}
 
-	std::size_t next_custom_number_format_id() const
+	std::size_t next_custom_number_format_id()
 	{
-		std::size_t id = 164;
+		index_number_formats();
 
-		for (const auto &nf : number_formats)
+		return next_number_format_id;
+	}
+
+	/// <summary>
+	/// Returns the first number format with the given id or nullptr if there is none.
+	/// </summary>
+	const class number_format *find_number_format(std::size_t id)
+	{
+		index_number_formats();
+
+		const auto match = number_format_positions.find(id);
+
+		return match == number_format_positions.end() ? nullptr : &number_formats[match->second];
+	}
+
+	/// <summary>
+	/// Extends number_format_positions and next_number_format_id to cover number
+	/// formats added since the last call. Number formats are only ever appended.
+	/// </summary>
+	void index_number_formats()
+	{
+		if (number_format_positions_size > number_formats.size())
+		{
+			number_format_positions.clear();
+			number_format_positions_size = 0;
+			next_number_format_id = 164;
+			format_kinds.clear();
+		}
+
+		const auto first_added = number_format_positions_size;
+
+		for (; number_format_positions_size < number_formats.size(); ++number_format_positions_size)
 		{
-			if (nf.id() >= id)
+			const auto id = number_formats[number_format_positions_size].id();
+			number_format_positions.emplace(id, number_format_positions_size);
+			next_number_format_id = std::max(next_number_format_id, id + 1);
+		}
+
+		// a format may have been classified before its number format was added
+		for (auto added = first_added; added < number_format_positions_size; ++added)
+		{
+			const auto id = number_formats[added].id();
+
+			for (std::size_t index = 0; index < format_kinds.size() && index < formats.by_id.size(); ++index)
 			{
-				id = nf.id() + 1;
+				const auto &impl = *formats.by_id[index];
+
+				if (impl.number_format_id.is_set() && impl.number_format_id.get() == id)
+				{
+					format_kinds[index] = classify_format(impl);
+				}
 			}
 		}
-
-		return id;
 	}
-    
-    template<typename T, typename C>
-    std::size_t find_or_add(C &container, const T &item, bool *added = nullptr)
+
+    /// <summary>
+    /// Returns the kind of number format used by the format with the given id,
+    /// or number_format_kind::number if there is no such format. This only reads
+    /// format_kinds so it's safe to call from several threads.
+    /// </summary>
+    number_format_kind format_kind(std::size_t id) const
+    {
+        return id < format_kinds.size() ? format_kinds[id] : number_format_kind::number;
+    }
+
+    /// <summary>
+    /// Appends a number format and classifies the formats again since some may
+    /// already refer to its id.
+    /// </summary>
+    void add_number_format(const class number_format &new_number_format)
+    {
+        number_formats.push_back(new_number_format);
+        classify_formats();
+    }
+
+    /// <summary>
+    /// Brings format_kinds up to date with every format. This is called whenever
+    /// formats or number formats are added or renumbered, and once a stylesheet
+    /// has been read, so that format_kind never has to parse number format strings.
+    /// </summary>
+    void classify_formats()
     {
-        if (added != nullptr)
+        index_formats();
+
+        // may clear format_kinds if number formats were added directly
+        index_number_formats();
+
+        while (format_kinds.size() < formats.by_id.size())
         {
-            *added = false;
+            format_kinds.push_back(classify_format(*formats.by_id[format_kinds.size()]));
         }
+    }
 
-        std::size_t i = 0;
-        
-        for (auto iter = container.begin(); iter != container.end(); ++iter)
+    number_format_kind classify_format(const format_impl &impl)
+    {
+        if (!impl.number_format_id.is_set())
         {
-            if (*iter == item)
-            {
-                return i;
-            }
-
-            ++i;
+            return number_format_kind::number;
         }
 
-        if (added != nullptr)
+        // same lookup order as format::number_format
+        const auto id = impl.number_format_id.get();
+        const auto format = number_format::is_builtin_format(id)
+            ? &number_format::from_builtin_id(id)
+            : find_number_format(id);
+
+        if (format == nullptr)
         {
-            *added = true;
+            return number_format_kind::number;
         }
 
-        container.emplace(container.end(), item);
-
-        return container.size() - 1;
+        return format->is_date_format() ? number_format_kind::date
+            : format->is_timedelta_format() ? number_format_kind::timedelta
+            : number_format_kind::number;
     }
-    
+
     template<typename T>
-    std::unordered_map<std::size_t, std::size_t> garbage_collect(
-        const std::unordered_map<std::size_t, std::size_t> &reference_counts,
-        std::vector<T> &container)
+    std::size_t find_or_add(style_pool<T> &container, const T &item, bool *added = nullptr)
     {
-        std::unordered_map<std::size_t, std::size_t> id_map;
-        std::size_t unreferenced = 0;
-        const auto original_size = container.size();
+        return container.find_or_add(item, added);
+    }
 
-        for (std::size_t i = 0; i < original_size; ++i)
+    /// <summary>
+    /// Marks the component id as used in a vector of flags indexed by component id.
+    /// </summary>
+    static void mark_used(std::vector<bool> &used, const optional<std::size_t> &id)
+    {
+        if (id.is_set() && id.get() < used.size())
         {
-            id_map[i] = i - unreferenced;
-
-            if (reference_counts.count(i) == 0 || reference_counts.at(i) == 0)
-            {
-                container.erase(container.begin() + static_cast<typename std::vector<T>::difference_type>(i - unreferenced));
-                unreferenced++;
-            }
+            used[id.get()] = true;
         }
+    }
 
-        return id_map;
+    /// <summary>
+    /// Replaces id with its new value in id_map after its pool was compacted.
+    /// </summary>
+    static void remap(optional<std::size_t> &id, const std::vector<std::size_t> &id_map)
+    {
+        if (id.is_set())
+        {
+            id = id.get() < id_map.size() ? id_map[id.get()] : 0;
+        }
     }
     
     void garbage_collect()
     {
         if (!garbage_collection_enabled) return;
-        
+
+        if (edits.sessions > 0)
+        {
+            edits.garbage_pending = true;
+            return;
+        }
+
+        edits.garbage_pending = false;
+
+        index_formats();
+
+        const auto unused_formats = static_cast<std::size_t>(std::count_if(format_impls.begin(),
+            format_impls.end(), [](const format_impl &impl) { return impl.references == 0; }));
+
+        // after a batch of edits the unused formats are often identical copies
+        // sharing one hash bucket so rebuilding the index is cheaper than
+        // unindexing them one by one
+        const auto rebuild_index = unused_formats > 16;
         auto format_iter = format_impls.begin();
 
-        while (format_iter != format_impls.end())
+        while (unused_formats > 0 && format_iter != format_impls.end())
         {
             auto &impl = *format_iter;
 
@@ -246,176 +526,109 @@ struct stylesheet
             }
             else
             {
+                if (!rebuild_index)
+                {
+                    unindex_format(&impl);
+                }
+
                 format_iter = format_impls.erase(format_iter);
             }
         }
-        
-        std::size_t new_id = 0;
-
-        std::unordered_map<std::size_t, std::size_t> alignment_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> border_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> fill_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> font_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> number_format_reference_counts;
-        std::unordered_map<std::size_t, std::size_t> protection_reference_counts;
-        
-        fill_reference_counts[0]++;
-        fill_reference_counts[1]++;
-        
+
+        if (unused_formats > 0)
+        {
+            renumber_formats();
+            classify_formats();
+        }
+
+        if (rebuild_index)
+        {
+            rehash_formats();
+        }
+
+        std::vector<bool> alignments_used(alignments.size(), false);
+        std::vector<bool> borders_used(borders.size(), false);
+        std::vector<bool> fills_used(fills.size(), false);
+        std::vector<bool> fonts_used(fonts.size(), false);
+        std::vector<bool> protections_used(protections.size(), false);
+
+        // the first two fills are reserved
+        for (std::size_t reserved = 0; reserved < std::min(fills_used.size(), std::size_t(2)); ++reserved)
+        {
+            fills_used[reserved] = true;
+        }
+
         for (auto &impl : format_impls)
         {
-            impl.id = new_id++;
-            
-            if (impl.alignment_id.is_set())
-            {
-                alignment_reference_counts[impl.alignment_id.get()]++;
-            }
-            
-            if (impl.border_id.is_set())
-            {
-                border_reference_counts[impl.border_id.get()]++;
-            }
-            
-            if (impl.fill_id.is_set())
-            {
-                fill_reference_counts[impl.fill_id.get()]++;
-            }
-            
-            if (impl.font_id.is_set())
-            {
-                font_reference_counts[impl.font_id.get()]++;
-            }
-            
-            if (impl.number_format_id.is_set())
-            {
-                number_format_reference_counts[impl.number_format_id.get()]++;
-            }
-            
-            if (impl.protection_id.is_set())
-            {
-                protection_reference_counts[impl.protection_id.get()]++;
-            }
+            mark_used(alignments_used, impl.alignment_id);
+            mark_used(borders_used, impl.border_id);
+            mark_used(fills_used, impl.fill_id);
+            mark_used(fonts_used, impl.font_id);
+            mark_used(protections_used, impl.protection_id);
         }
-        
+
         for (auto &name_impl_pair : style_impls)
         {
             auto &impl = name_impl_pair.second;
-            
-            if (impl.alignment_id.is_set())
-            {
-                alignment_reference_counts[impl.alignment_id.get()]++;
-            }
-            
-            if (impl.border_id.is_set())
-            {
-                border_reference_counts[impl.border_id.get()]++;
-            }
-            
-            if (impl.fill_id.is_set())
-            {
-                fill_reference_counts[impl.fill_id.get()]++;
-            }
-            
-            if (impl.font_id.is_set())
-            {
-                font_reference_counts[impl.font_id.get()]++;
-            }
-            
-            if (impl.number_format_id.is_set())
-            {
-                number_format_reference_counts[impl.number_format_id.get()]++;
-            }
-            
-            if (impl.protection_id.is_set())
-            {
-                protection_reference_counts[impl.protection_id.get()]++;
-            }
+
+            mark_used(alignments_used, impl.alignment_id);
+            mark_used(borders_used, impl.border_id);
+            mark_used(fills_used, impl.fill_id);
+            mark_used(fonts_used, impl.font_id);
+            mark_used(protections_used, impl.protection_id);
+        }
+
+        const auto component_count = alignments.size() + borders.size()
+            + fills.size() + fonts.size() + protections.size();
+
+        auto alignment_id_map = alignments.compact(alignments_used);
+        auto border_id_map = borders.compact(borders_used);
+        auto fill_id_map = fills.compact(fills_used);
+        auto font_id_map = fonts.compact(fonts_used);
+        auto protection_id_map = protections.compact(protections_used);
+
+        if (component_count == alignments.size() + borders.size()
+            + fills.size() + fonts.size() + protections.size())
+        {
+            // every component is still used so no ids changed
+            return;
         }
-        
-        auto alignment_id_map = garbage_collect(alignment_reference_counts, alignments);
-        auto border_id_map = garbage_collect(border_reference_counts, borders);
-        auto fill_id_map = garbage_collect(fill_reference_counts, fills);
-        auto font_id_map = garbage_collect(font_reference_counts, fonts);
-        auto protection_id_map = garbage_collect(protection_reference_counts, protections);
 
         for (auto &impl : format_impls)
         {
-            if (impl.alignment_id.is_set())
-            {
-                impl.alignment_id = alignment_id_map[impl.alignment_id.get()];
-            }
-            
-            if (impl.border_id.is_set())
-            {
-                impl.border_id = border_id_map[impl.border_id.get()];
-            }
-            
-            if (impl.fill_id.is_set())
-            {
-                impl.fill_id = fill_id_map[impl.fill_id.get()];
-            }
-            
-            if (impl.font_id.is_set())
-            {
-                impl.font_id = font_id_map[impl.font_id.get()];
-            }
-            
-            if (impl.protection_id.is_set())
-            {
-                impl.protection_id = protection_id_map[impl.protection_id.get()];
-            }
+            remap(impl.alignment_id, alignment_id_map);
+            remap(impl.border_id, border_id_map);
+            remap(impl.fill_id, fill_id_map);
+            remap(impl.font_id, font_id_map);
+            remap(impl.protection_id, protection_id_map);
         }
 
         for (auto &name_impl : style_impls)
         {
             auto &impl = name_impl.second;
 
-            if (impl.alignment_id.is_set())
-            {
-                impl.alignment_id = alignment_id_map[impl.alignment_id.get()];
-            }
-            
-            if (impl.border_id.is_set())
-            {
-                impl.border_id = border_id_map[impl.border_id.get()];
-            }
-            
-            if (impl.fill_id.is_set())
-            {
-                impl.fill_id = fill_id_map[impl.fill_id.get()];
-            }
-            
-            if (impl.font_id.is_set())
-            {
-                impl.font_id = font_id_map[impl.font_id.get()];
-            }
-            
-            if (impl.protection_id.is_set())
-            {
-                impl.protection_id = protection_id_map[impl.protection_id.get()];
-            }
+            remap(impl.alignment_id, alignment_id_map);
+            remap(impl.border_id, border_id_map);
+            remap(impl.fill_id, fill_id_map);
+            remap(impl.font_id, font_id_map);
+            remap(impl.protection_id, protection_id_map);
         }
+
+        // formats are hashed by their component ids
+        rehash_formats();
     }
 
     format_impl *find_or_create(format_impl &pattern)
     {
-        auto iter = format_impls.begin();
-        bool added = false;
-        auto id = find_or_add(format_impls, pattern, &added);
-        std::advance(iter, static_cast<std::list<format_impl>::difference_type>(id));
-        
-        auto &result = *iter;
-
-        if (added)
-        {
-            result.references = 0;
-        }
+        auto match = find_format(pattern);
+        auto &result = match != nullptr ? *match : add_format_impl(pattern);
 
-        result.parent = this;
-        result.id = id;
         result.references++;
-        
-        if (id != pattern.id)
+
+        // a number format may have been added for the new format
+        classify_formats();
+
+        if (result.id != pattern.id)
         {
             pattern.references -= pattern.references > 0 ? 1 : 0;
             garbage_collect();
@@ -496,10 +709,51 @@ struct stylesheet
 	    std::find(style_names.begin(), style_names.end(), name)));
     }
     
+    /// <summary>
+    /// Suspends garbage collection until the matching end_edit_session.
+    /// Sessions may be nested.
+    /// </summary>
+    void begin_edit_session()
+    {
+        ++edits.sessions;
+    }
+
+    /// <summary>
+    /// Ends a session started by begin_edit_session. When the outermost
+    /// session ends, the collections skipped while it was open are replaced
+    /// by a single pass.
+    /// </summary>
+    void end_edit_session()
+    {
+        if (edits.sessions == 0) return;
+
+        if (--edits.sessions == 0)
+        {
+            collect_pending_garbage();
+        }
+    }
+
+    /// <summary>
+    /// Runs a garbage collection that was deferred by an edit session, even
+    /// if the session is still open. Used before the stylesheet is written.
+    /// </summary>
+    void collect_pending_garbage()
+    {
+        if (!edits.garbage_pending) return;
+
+        const auto sessions = edits.sessions;
+        edits.sessions = 0;
+        garbage_collect();
+        edits.sessions = sessions;
+    }
+
     void clear()
     {
 		conditional_format_impls.clear();
         format_impls.clear();
+        formats.by_id.clear();
+        formats.by_hash.clear();
+        format_kinds.clear();
         
         style_impls.clear();
         style_names.clear();
@@ -509,9 +763,13 @@ struct stylesheet
         fills.clear();
         fonts.clear();
         number_formats.clear();
+        number_format_positions.clear();
+        number_format_positions_size = 0;
+        next_number_format_id = 164;
         protections.clear();
         
         colors.clear();
+        edits.garbage_pending = false;
     }
 
 	conditional_format add_conditional_format_rule(worksheet_impl *ws, const range_reference &ref, const condition &when)
@@ -532,17 +790,37 @@ struct stylesheet
     
     bool garbage_collection_enabled = true;
 
+    /// <summary>
+    /// The open style edit sessions, during which garbage collection is deferred.
+    /// </summary>
+    edit_session_state edits;
+
 	std::list<conditional_format_impl> conditional_format_impls;
     std::list<format_impl> format_impls;
     std::unordered_map<std::string, style_impl> style_impls;
     std::vector<std::string> style_names;
 
-	std::vector<alignment> alignments;
-    std::vector<border> borders;
-    std::vector<fill> fills;
-    std::vector<font> fonts;
-    std::vector<number_format> number_formats;
-	std::vector<protection> protections;
+    format_lookup formats;
+
+    /// <summary>
+    /// The number format kind of each format by id, kept up to date by classify_formats.
+    /// </summary>
+    std::vector<number_format_kind> format_kinds;
+
+	style_pool<alignment> alignments;
+    style_pool<border> borders;
+    style_pool<fill> fills;
+    style_pool<font> fonts;
+    style_pool<number_format> number_formats;
+	style_pool<protection> protections;
+
+    /// <summary>
+    /// Positions in number_formats by number format id, covering the first
+    /// number_format_positions_size number formats.
+    /// </summary>
+    std::unordered_map<std::size_t, std::size_t> number_format_positions;
+    std::size_t number_format_positions_size = 0;
+    std::size_t next_number_format_id = 164;
     
     std::vector<color> colors;
 };
@@ -23,6 +23,8 @@
 #pragma once
 
 #include <list>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -42,11 +44,13 @@
 namespace xlnt {
 namespace detail {
 
+struct deferred_parts;
+class shared_string_arena;
 struct worksheet_impl;
 
 struct workbook_impl
 {
-	workbook_impl() : base_date_(calendar::windows_1900)
+	workbook_impl() : shared_strings_indexed_(0), base_date_(calendar::windows_1900)
 	{
 	}
 
@@ -54,6 +58,9 @@ struct workbook_impl
         : active_sheet_index_(other.active_sheet_index_),
           worksheets_(other.worksheets_),
           shared_strings_(other.shared_strings_),
+          shared_strings_ids_(other.shared_strings_ids_),
+          shared_strings_indexed_(other.shared_strings_indexed_),
+          shared_string_arena_(other.shared_string_arena_),
           stylesheet_(other.stylesheet_),
           manifest_(other.manifest_),
           theme_(other.theme_),
@@ -73,6 +80,12 @@ struct workbook_impl
         std::copy(other.worksheets_.begin(), other.worksheets_.end(), back_inserter(worksheets_));
         shared_strings_.clear();
         std::copy(other.shared_strings_.begin(), other.shared_strings_.end(), std::back_inserter(shared_strings_));
+        shared_strings_ids_ = other.shared_strings_ids_;
+        shared_strings_indexed_ = other.shared_strings_indexed_;
+        shared_string_arena_ = other.shared_string_arena_;
+        // deferred parts belong to the worksheets of other, which a workbook
+        // reads before it is copied, so they are never shared
+        deferred_parts_.reset();
 		theme_ = other.theme_;
         manifest_ = other.manifest_;
 
@@ -93,6 +106,34 @@ struct workbook_impl
     std::list<worksheet_impl> worksheets_;
     std::vector<rich_text> shared_strings_;
 
+    /// <summary>
+    /// Maps each string in shared_strings_ to the index of its first occurrence.
+    /// Only the first shared_strings_indexed_ strings are covered. The mutable
+    /// workbook::shared_strings() accessor resets both since the table may be
+    /// changed arbitrarily through it (e.g. while loading).
+    /// </summary>
+    std::unordered_map<rich_text, std::size_t> shared_strings_ids_;
+    std::size_t shared_strings_indexed_;
+
+    /// <summary>
+    /// The shared string table of a workbook opened by streaming_workbook_reader,
+    /// which replaces shared_strings_. It is never modified once read so copies
+    /// of the workbook share it.
+    /// </summary>
+    std::shared_ptr<shared_string_arena> shared_string_arena_;
+
+    /// <summary>
+    /// The parts left to be read on demand by a workbook loaded with
+    /// load_options::lazy_parts. Null once all of them have been read.
+    /// </summary>
+    std::shared_ptr<deferred_parts> deferred_parts_;
+
+    /// <summary>
+    /// Serializes reading deferred_parts_ from const accessors. It is recursive
+    /// since reading a worksheet can reach other worksheets through the workbook.
+    /// </summary>
+    std::recursive_mutex deferred_parts_mutex_;
+
     optional<stylesheet> stylesheet_;
 
     calendar base_date_;
@@ -28,6 +28,8 @@
 #include <vector>
 
 #include <detail/implementations/cell_impl.hpp>
+#include <detail/implementations/cell_store.hpp>
+#include <xlnt/cell/comment.hpp>
 #include <xlnt/workbook/named_range.hpp>
 #include <xlnt/worksheet/range.hpp>
 #include <xlnt/worksheet/range_reference.hpp>
@@ -66,13 +68,7 @@ struct worksheet_impl
         row_properties_ = other.row_properties_;
         cell_map_ = other.cell_map_;
 
-        for (auto &row : cell_map_)
-        {
-            for (auto &cell : row.second)
-            {
-                cell.second.parent_ = this;
-            }
-        }
+        cell_map_.for_each([this](cell_impl &cell) { cell.parent_ = this; });
 
         page_setup_ = other.page_setup_;
         auto_filter_ = other.auto_filter_;
@@ -86,6 +82,7 @@ struct worksheet_impl
         views_ = other.views_;
         column_breaks_ = other.column_breaks_;
         row_breaks_ = other.row_breaks_;
+        comments_ = other.comments_;
     }
 
     workbook *parent_;
@@ -96,7 +93,7 @@ struct worksheet_impl
     std::unordered_map<column_t, column_properties> column_properties_;
     std::unordered_map<row_t, row_properties> row_properties_;
 
-    std::unordered_map<row_t, std::unordered_map<column_t, cell_impl>> cell_map_;
+    cell_store cell_map_;
 
     optional<page_setup> page_setup_;
     optional<range_reference> auto_filter_;
@@ -24,6 +24,7 @@
 #include <algorithm>
 #include <cctype>
 #include <cmath>
+#include <mutex>
 
 #include <detail/default_case.hpp>
 #include <detail/number_format/number_formatter.hpp>
@@ -1079,38 +1080,103 @@ std::pair<format_locale, std::string> number_format_parser::locale_from_string(c
     throw xlnt::exception("unknown country code: " + country_code_string);
 }
 
+number_format_program::number_format_program(const std::string &format_string)
+{
+    number_format_parser parser(format_string);
+    parser.parse();
+    codes = parser.result();
+
+    bool any_datetime = false;
+    bool any_timedelta = false;
+
+    for (const auto &section : codes)
+    {
+        any_datetime = any_datetime || section.is_datetime;
+        any_timedelta = any_timedelta || section.is_timedelta;
+    }
+
+    is_date_format = any_datetime && !any_timedelta;
+    is_timedelta_format = any_timedelta;
+}
+
+std::shared_ptr<const number_format_program> number_format_program::compile(const std::string &format_string)
+{
+    // workbooks rarely use more than a few dozen distinct formats so the
+    // cache is simply dropped if something generates formats in bulk
+    const std::size_t max_cached_programs = 4096;
+
+    static std::mutex *cache_mutex = new std::mutex();
+    static auto *cache = new std::unordered_map<std::string, std::shared_ptr<const number_format_program>>();
+
+    {
+        std::lock_guard<std::mutex> lock(*cache_mutex);
+        auto match = cache->find(format_string);
+
+        if (match != cache->end())
+        {
+            return match->second;
+        }
+    }
+
+    auto program = std::make_shared<const number_format_program>(format_string);
+
+    std::lock_guard<std::mutex> lock(*cache_mutex);
+
+    if (cache->size() >= max_cached_programs)
+    {
+        cache->clear();
+    }
+
+    cache->emplace(format_string, program);
+
+    return program;
+}
+
 number_formatter::number_formatter(const std::string &format_string, xlnt::calendar calendar)
-    : parser_(format_string), calendar_(calendar)
+    : number_formatter(std::make_shared<const number_format_program>(format_string), calendar)
+{
+}
+
+number_formatter::number_formatter(std::shared_ptr<const number_format_program> program, xlnt::calendar calendar)
+    : program_(std::move(program)), format_(program_->codes), calendar_(calendar)
 {
-    parser_.parse();
-    format_ = parser_.result();
 }
 
 std::string number_formatter::format_number(double number)
+{
+    std::string result;
+    format_number(number, result);
+
+    return result;
+}
+
+void number_formatter::format_number(double number, std::string &result)
 {
     if (format_[0].has_condition)
     {
         if (format_[0].condition.satisfied_by(number))
         {
-            return format_number(format_[0], number);
+            return format_number(format_[0], number, result);
         }
 
         if (format_.size() == 1)
         {
-            return std::string(11, '#');
+            result.assign(11, '#');
+            return;
         }
 
         if (!format_[1].has_condition || format_[1].condition.satisfied_by(number))
         {
-            return format_number(format_[1], number);
+            return format_number(format_[1], number, result);
         }
 
         if (format_.size() == 2)
         {
-            return std::string(11, '#');
+            result.assign(11, '#');
+            return;
         }
 
-        return format_number(format_[2], number);
+        return format_number(format_[2], number, result);
     }
 
     // no conditions, format based on sign:
@@ -1118,18 +1184,18 @@ std::string number_formatter::format_number(double number)
     // 1 section, use for all
     if (format_.size() == 1)
     {
-        return format_number(format_[0], number);
+        return format_number(format_[0], number, result);
     }
     // 2 sections, first for positive and zero, second for negative
     else if (format_.size() == 2)
     {
         if (number >= 0)
         {
-            return format_number(format_[0], number);
+            return format_number(format_[0], number, result);
         }
         else
         {
-            return format_number(format_[1], std::fabs(number));
+            return format_number(format_[1], std::fabs(number), result);
         }
     }
     // 3+ sections, first for positive, second for negative, third for zero
@@ -1137,15 +1203,15 @@ std::string number_formatter::format_number(double number)
     {
         if (number > 0)
         {
-            return format_number(format_[0], number);
+            return format_number(format_[0], number, result);
         }
         else if (number < 0)
         {
-            return format_number(format_[1], std::fabs(number));
+            return format_number(format_[1], std::fabs(number), result);
         }
         else
         {
-            return format_number(format_[2], number);
+            return format_number(format_[2], number, result);
         }
     }
 }
@@ -1361,7 +1427,7 @@ std::string number_formatter::fill_fraction_placeholders(const format_placeholde
     return std::to_string(numerator_rounded) + "/" + std::to_string(best_denominator);
 }
 
-std::string number_formatter::format_number(const format_code &format, double number)
+void number_formatter::format_number(const format_code &format, double number, std::string &result)
 {
     static const std::vector<std::string> *month_names = new std::vector<std::string>{"January", "February", "March",
         "April", "May", "June", "July", "August", "September", "October", "November", "December"};
@@ -1369,7 +1435,7 @@ std::string number_formatter::format_number(const format_code &format, double nu
     static const std::vector<std::string> *day_names =
         new std::vector<std::string>{"Sunday", "Monday", "Tuesday", "Wednesday", "Thursday", "Friday", "Saturday"};
 
-    std::string result;
+    result.clear();
 
     if (number < 0)
     {
@@ -1377,7 +1443,8 @@ std::string number_formatter::format_number(const format_code &format, double nu
 
         if (format.is_datetime)
         {
-            return std::string(11, '#');
+            result.assign(11, '#');
+            return;
         }
     }
 
@@ -1691,13 +1758,9 @@ std::string number_formatter::format_number(const format_code &format, double nu
     {
         auto remaining = width - result.size();
 
-        std::string fill_string(remaining, fill_character.front());
         // TODO: A UTF-8 character could be multiple bytes
-
-        result = result.substr(0, fill_index) + fill_string + result.substr(fill_index);
+        result.insert(fill_index, remaining, fill_character.front());
     }
-
-    return result;
 }
 
 std::string number_formatter::format_text(const format_code &format, const std::string &text)
@@ -23,6 +23,7 @@
 
 #pragma once
 
+#include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -348,11 +349,44 @@ private:
     std::vector<format_code> codes_;
 };
 
+/// <summary>
+/// A number format string parsed into its sections. Programs are immutable
+/// once compiled so a single program is shared by every number_format with
+/// the same format string.
+/// </summary>
+struct number_format_program
+{
+    /// <summary>
+    /// Parses format_string. Throws if it isn't a valid number format.
+    /// </summary>
+    explicit number_format_program(const std::string &format_string);
+
+    /// <summary>
+    /// Returns the program for format_string, parsing it only if no program
+    /// for the same string has been compiled recently.
+    /// </summary>
+    static std::shared_ptr<const number_format_program> compile(const std::string &format_string);
+
+    std::vector<format_code> codes;
+
+    /// <summary>
+    /// True if any section formats a date or time and none an elapsed time.
+    /// </summary>
+    bool is_date_format = false;
+
+    /// <summary>
+    /// True if any section formats an elapsed time.
+    /// </summary>
+    bool is_timedelta_format = false;
+};
+
 class XLNT_API number_formatter
 {
 public:
     number_formatter(const std::string &format_string, xlnt::calendar calendar);
+    number_formatter(std::shared_ptr<const number_format_program> program, xlnt::calendar calendar);
     std::string format_number(double number);
+    void format_number(double number, std::string &result);
     std::string format_text(const std::string &text);
 
 private:
@@ -362,11 +396,11 @@ private:
     std::string fill_scientific_placeholders(const format_placeholders &integer_part,
         const format_placeholders &fractional_part, const format_placeholders &exponent_part,
         double number);
-    std::string format_number(const format_code &format, double number);
+    void format_number(const format_code &format, double number, std::string &result);
     std::string format_text(const format_code &format, const std::string &text);
 
-    number_format_parser parser_;
-    std::vector<format_code> format_;
+    std::shared_ptr<const number_format_program> program_;
+    const std::vector<format_code> &format_;
     xlnt::calendar calendar_;
 };
 
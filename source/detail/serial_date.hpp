@@ -0,0 +1,162 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// The number of days between day 0 of the 1900 date system, 1899-12-31,
+/// and day 0 of the 1904 date system, 1904-01-01.
+/// </summary>
+const int mac_1904_offset = 1462;
+
+/// <summary>
+/// The serial number of 1970-01-01 in the 1900 date system.
+/// </summary>
+const int unix_epoch_1900 = 25569;
+
+/// <summary>
+/// The serial number of 1900-03-01, the first day after Excel's fictitious
+/// 29 February 1900, in the 1900 date system.
+/// </summary>
+const int first_serial_after_leap_bug = 61;
+
+const std::int64_t microseconds_per_day = 86400000000LL;
+
+// The functions below contain no branches so that loops over arrays which
+// call them can be unrolled and vectorized by the compiler. Conditions are
+// turned into 0 or 1 and folded into the arithmetic instead.
+
+/// <summary>
+/// Converts a number of days since 1899-12-31 into a year, month and day
+/// using the Fliegel-Van Flandern algorithm. Serial 60 becomes Excel's
+/// 29 February 1900 and earlier serials are shifted by a day to match.
+/// </summary>
+inline void date_from_serial(int serial, int &year, int &month, int &day)
+{
+    const int leap_bug = serial == 60;
+    serial += serial < 60;
+
+    int l = serial + 68569 + 2415019;
+    const int n = (4 * l) / 146097;
+    l = l - (146097 * n + 3) / 4;
+    const int i = (4000 * (l + 1)) / 1461001;
+    l = l - (1461 * i) / 4 + 31;
+    const int j = (80 * l) / 2447;
+    day = l - (2447 * j) / 80 + leap_bug;
+    l = j / 11;
+    month = j + 2 - 12 * l;
+    year = 100 * (n - 49) + i + l;
+}
+
+/// <summary>
+/// The inverse of date_from_serial, less offset days. 29 February 1900 always
+/// becomes serial 60 and earlier dates are shifted by a day to match.
+/// </summary>
+inline int serial_from_date(int year, int month, int day, int offset)
+{
+    const int leap_bug = (day == 29) & (month == 2) & (year == 1900);
+    const int m = (month - 14) / 12;
+
+    int serial = (1461 * (year + 4800 + m)) / 4
+        + (367 * (month - 2 - 12 * m)) / 12
+        - (3 * ((year + 4900 + m) / 100)) / 4 + day - 2415019 - 32075;
+    serial -= (serial <= 60) + offset;
+
+    return serial + leap_bug * (60 - serial);
+}
+
+/// <summary>
+/// Splits the fractional part of number, a fraction of a day, into a time of
+/// day. A microsecond count that rounds up to the next second is carried
+/// into the second, minute and hour.
+/// </summary>
+inline void time_from_fraction(double number, int &hour, int &minute, int &second, int &microsecond)
+{
+    double fraction = (number - std::trunc(number)) * 24;
+    hour = static_cast<int>(fraction);
+    fraction = 60 * (fraction - hour);
+    minute = static_cast<int>(fraction);
+    fraction = 60 * (fraction - minute);
+    second = static_cast<int>(fraction);
+    fraction = 1000000 * (fraction - second);
+    microsecond = static_cast<int>(fraction);
+
+    const int carry = (microsecond == 999999) & (fraction - microsecond > 0.5);
+    microsecond -= carry * 999999;
+    second += carry;
+
+    const int second_carry = second == 60;
+    second -= second_carry * 60;
+    minute += second_carry;
+
+    const int minute_carry = minute == 60;
+    minute -= minute_carry * 60;
+    hour += minute_carry;
+}
+
+/// <summary>
+/// Returns the fraction of a day represented by the given time of day,
+/// rounded to 11 decimal places.
+/// </summary>
+inline double fraction_from_time(int hour, int minute, int second, int microsecond)
+{
+    const auto microseconds_per_hour = static_cast<std::uint64_t>(1e6) * 60 * 60;
+
+    auto microseconds = static_cast<std::uint64_t>(microsecond);
+    microseconds += static_cast<std::uint64_t>(second * 1e6);
+    microseconds += static_cast<std::uint64_t>(minute * 1e6 * 60);
+    microseconds += static_cast<std::uint64_t>(hour) * microseconds_per_hour;
+
+    const auto number = microseconds / (24.0 * microseconds_per_hour);
+    const auto hundred_billion = static_cast<std::uint64_t>(1e9) * 100;
+
+    return std::floor(number * hundred_billion + 0.5) / hundred_billion;
+}
+
+/// <summary>
+/// Returns the number of days since 1970-01-01 of the day with the given
+/// serial number in the 1900 date system. Serial 60, the fictitious
+/// 29 February 1900, becomes 1 March 1900.
+/// </summary>
+inline std::int64_t unix_day_from_serial(std::int64_t serial)
+{
+    return serial - unix_epoch_1900 + (serial < first_serial_after_leap_bug);
+}
+
+/// <summary>
+/// The inverse of unix_day_from_serial.
+/// </summary>
+inline std::int64_t serial_from_unix_day(std::int64_t day)
+{
+    return day + unix_epoch_1900 - (day < first_serial_after_leap_bug - unix_epoch_1900);
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,86 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <xlnt/utils/path.hpp>
+#include <xlnt/workbook/load_options.hpp>
+
+namespace xlnt {
+namespace detail {
+
+class izstream;
+struct worksheet_impl;
+
+/// <summary>
+/// The parts of a workbook loaded with load_options::lazy_parts which haven't
+/// been read yet, along with the archive they are read from.
+/// </summary>
+struct deferred_parts
+{
+    /// <summary>
+    /// A copy of the package when it was loaded from a stream, which archive
+    /// reads in place. Empty when archive reads a mapped file.
+    /// </summary>
+    std::vector<std::uint8_t> package;
+
+    std::shared_ptr<izstream> archive;
+
+    load_options options;
+
+    /// <summary>
+    /// The worksheets whose parts haven't been read. Their relationships are
+    /// looked up by title when they are read since removing a worksheet
+    /// renumbers the relationships of the others.
+    /// </summary>
+    std::unordered_set<const worksheet_impl *> worksheets;
+
+    /// <summary>
+    /// The worksheets whose parts couldn't be read, with the error that is
+    /// raised again each time one of them is reached.
+    /// </summary>
+    std::unordered_map<const worksheet_impl *, std::exception_ptr> failed_worksheets;
+
+    /// <summary>
+    /// The images which haven't been read into workbook_impl::images_.
+    /// </summary>
+    std::vector<path> images;
+
+    /// <summary>
+    /// Returns true once every part has been read successfully.
+    /// </summary>
+    bool empty() const
+    {
+        return worksheets.empty() && failed_worksheets.empty() && images.empty();
+    }
+};
+
+} // namespace detail
+} // namespace xlnt
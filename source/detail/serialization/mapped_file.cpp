@@ -0,0 +1,154 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <detail/serialization/mapped_file.hpp>
+#include <xlnt/utils/exceptions.hpp>
+#include <xlnt/utils/path.hpp>
+
+namespace xlnt {
+namespace detail {
+
+#ifdef _WIN32
+mapped_file::mapped_file(const path &filename)
+    : data_(nullptr),
+      size_(0),
+      file_(INVALID_HANDLE_VALUE),
+      mapping_(nullptr)
+{
+#ifdef _MSC_VER
+    file_ = CreateFileW(filename.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+#else
+    file_ = CreateFileA(filename.string().c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+#endif
+
+    if (file_ == INVALID_HANDLE_VALUE)
+    {
+        throw xlnt::exception("file not found " + filename.string());
+    }
+
+    LARGE_INTEGER file_size;
+
+    if (!GetFileSizeEx(file_, &file_size))
+    {
+        CloseHandle(file_);
+        throw xlnt::exception("couldn't read size of " + filename.string());
+    }
+
+    size_ = static_cast<std::size_t>(file_size.QuadPart);
+
+    // empty files can't be mapped
+    if (size_ == 0) return;
+
+    mapping_ = CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    const auto view = mapping_ == nullptr ? nullptr : MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+
+    if (view == nullptr)
+    {
+        if (mapping_ != nullptr) CloseHandle(mapping_);
+        CloseHandle(file_);
+        throw xlnt::exception("couldn't map " + filename.string());
+    }
+
+    data_ = static_cast<const std::uint8_t *>(view);
+}
+
+mapped_file::~mapped_file()
+{
+    if (data_ != nullptr) UnmapViewOfFile(data_);
+    if (mapping_ != nullptr) CloseHandle(mapping_);
+    CloseHandle(file_);
+}
+#else
+mapped_file::mapped_file(const path &filename)
+    : data_(nullptr),
+      size_(0)
+{
+    const auto descriptor = ::open(filename.string().c_str(), O_RDONLY);
+
+    if (descriptor < 0)
+    {
+        throw xlnt::exception("file not found " + filename.string());
+    }
+
+    struct stat status;
+
+    if (fstat(descriptor, &status) != 0)
+    {
+        close(descriptor);
+        throw xlnt::exception("couldn't read size of " + filename.string());
+    }
+
+    size_ = static_cast<std::size_t>(status.st_size);
+
+    // empty files can't be mapped
+    if (size_ != 0)
+    {
+        const auto view = mmap(nullptr, size_, PROT_READ, MAP_SHARED, descriptor, 0);
+
+        if (view == MAP_FAILED)
+        {
+            close(descriptor);
+            throw xlnt::exception("couldn't map " + filename.string());
+        }
+
+        data_ = static_cast<const std::uint8_t *>(view);
+    }
+
+    // the mapping keeps its own reference to the file
+    close(descriptor);
+}
+
+mapped_file::~mapped_file()
+{
+    if (data_ != nullptr)
+    {
+        munmap(const_cast<std::uint8_t *>(data_), size_);
+    }
+}
+#endif
+
+const std::uint8_t *mapped_file::data() const
+{
+    return data_;
+}
+
+std::size_t mapped_file::size() const
+{
+    return size_;
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,81 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace xlnt {
+
+class path;
+
+namespace detail {
+
+/// <summary>
+/// A read-only view of a whole file mapped into memory. Pages are read from
+/// the operating system's page cache on demand rather than copied into the
+/// process so other processes reading the same file share them.
+/// </summary>
+class mapped_file
+{
+public:
+    /// <summary>
+    /// Maps the file at filename. Throws xlnt::exception if it can't be opened.
+    /// </summary>
+    explicit mapped_file(const path &filename);
+
+    mapped_file(const mapped_file &) = delete;
+
+    mapped_file &operator=(const mapped_file &) = delete;
+
+    /// <summary>
+    /// Unmaps the file. Pointers returned by data() are invalid afterwards.
+    /// </summary>
+    ~mapped_file();
+
+    /// <summary>
+    /// Returns the first byte of the file or nullptr if the file is empty.
+    /// </summary>
+    const std::uint8_t *data() const;
+
+    /// <summary>
+    /// Returns the size of the file in bytes.
+    /// </summary>
+    std::size_t size() const;
+
+private:
+    const std::uint8_t *data_;
+
+    std::size_t size_;
+
+#ifdef _WIN32
+    void *file_;
+
+    void *mapping_;
+#endif
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,275 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <cfloat>
+#include <clocale>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <locale>
+#include <sstream>
+#include <string>
+
+#if defined(__APPLE__) || defined(__FreeBSD__)
+#include <xlocale.h>
+#endif
+
+#include <detail/serialization/number_parser.hpp>
+#include <xlnt/utils/exceptions.hpp>
+
+namespace {
+
+// Every power of ten up to 1e22 is exactly representable as a double.
+const double exact_powers_of_ten[] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+    1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+const int max_exact_power = 22;
+
+// Every integer up to 2^53 is exactly representable as a double.
+const std::uint64_t max_exact_integer = std::uint64_t(1) << 53;
+
+// Any 19 digit decimal fits in 64 bits.
+const int max_mantissa_digits = 19;
+
+bool is_digit(char c)
+{
+    return c >= '0' && c <= '9';
+}
+
+/// <summary>
+/// Converts the number in [first, last) with the C library, which rounds
+/// correctly, in the "C" locale so that '.' is the decimal point whatever
+/// the current locale is. Where strtod_l isn't available, a stream imbued
+/// with the classic locale is used instead.
+/// </summary>
+double parse_with_classic_locale(const char *first, const char *last)
+{
+    const auto length = static_cast<std::size_t>(last - first);
+    char buffer[128];
+    std::string long_number;
+    auto text = buffer;
+
+    if (length < sizeof(buffer))
+    {
+        std::memcpy(buffer, first, length);
+        buffer[length] = '\0';
+    }
+    else
+    {
+        long_number.assign(first, last);
+        text = &long_number[0];
+    }
+
+#if defined(_MSC_VER)
+    static const auto c_locale = _create_locale(LC_NUMERIC, "C");
+    return _strtod_l(text, nullptr, c_locale);
+#elif defined(__GLIBC__) || defined(__APPLE__) || defined(__FreeBSD__)
+    static const auto c_locale = newlocale(LC_NUMERIC_MASK, "C", locale_t(0));
+    return strtod_l(text, nullptr, c_locale);
+#else
+    std::istringstream stream(text);
+    stream.imbue(std::locale::classic());
+
+    auto result = 0.0;
+    stream >> result;
+
+    // out of range values are clamped to the largest double rather than infinity
+    if (stream.fail() && std::fabs(result) == std::numeric_limits<double>::max())
+    {
+        result = std::copysign(std::numeric_limits<double>::infinity(), result);
+    }
+
+    return result;
+#endif
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+const char *parse_double(const char *first, const char *last, double &result)
+{
+    result = 0.0;
+
+    auto position = first;
+    auto negative = false;
+
+    if (position != last && (*position == '-' || *position == '+'))
+    {
+        negative = *position == '-';
+        ++position;
+    }
+
+    // the significant digits are accumulated in mantissa and the value is
+    // mantissa * 10^exponent, ignoring any digits beyond the first 19
+    std::uint64_t mantissa = 0;
+    auto mantissa_digits = 0;
+    auto exponent = 0;
+    auto truncated = false;
+    auto any_digits = false;
+
+    for (; position != last && is_digit(*position); ++position)
+    {
+        any_digits = true;
+
+        if (mantissa_digits < max_mantissa_digits)
+        {
+            mantissa = mantissa * 10 + static_cast<std::uint64_t>(*position - '0');
+            mantissa_digits += mantissa != 0 ? 1 : 0;
+        }
+        else
+        {
+            truncated = truncated || *position != '0';
+            ++exponent;
+        }
+    }
+
+    if (position != last && *position == '.')
+    {
+        ++position;
+
+        for (; position != last && is_digit(*position); ++position)
+        {
+            any_digits = true;
+
+            if (mantissa_digits < max_mantissa_digits)
+            {
+                mantissa = mantissa * 10 + static_cast<std::uint64_t>(*position - '0');
+                mantissa_digits += mantissa != 0 ? 1 : 0;
+                --exponent;
+            }
+            else
+            {
+                truncated = truncated || *position != '0';
+            }
+        }
+    }
+
+    if (!any_digits)
+    {
+        return first;
+    }
+
+    if (position != last && (*position == 'e' || *position == 'E'))
+    {
+        auto exponent_position = position + 1;
+        auto negative_exponent = false;
+
+        if (exponent_position != last && (*exponent_position == '-' || *exponent_position == '+'))
+        {
+            negative_exponent = *exponent_position == '-';
+            ++exponent_position;
+        }
+
+        if (exponent_position != last && is_digit(*exponent_position))
+        {
+            auto written_exponent = 0;
+
+            for (; exponent_position != last && is_digit(*exponent_position); ++exponent_position)
+            {
+                // anything this large is zero or infinite anyway
+                if (written_exponent < 100000)
+                {
+                    written_exponent = written_exponent * 10 + (*exponent_position - '0');
+                }
+            }
+
+            exponent += negative_exponent ? -written_exponent : written_exponent;
+            position = exponent_position;
+        }
+    }
+
+    if (!truncated)
+    {
+        if (mantissa == 0)
+        {
+            result = negative ? -0.0 : 0.0;
+            return position;
+        }
+
+        // converting an integer rounds correctly and when both the mantissa
+        // and the power of ten are exact, so is a single multiplication or
+        // division (as long as it isn't carried out in extended precision)
+        if (exponent == 0)
+        {
+            result = static_cast<double>(mantissa);
+            result = negative ? -result : result;
+            return position;
+        }
+
+#if defined(FLT_EVAL_METHOD) && (FLT_EVAL_METHOD == 0 || FLT_EVAL_METHOD == 1)
+        if (mantissa <= max_exact_integer && exponent >= -max_exact_power && exponent <= max_exact_power)
+        {
+            result = static_cast<double>(mantissa);
+            result = exponent < 0
+                ? result / exact_powers_of_ten[-exponent]
+                : result * exact_powers_of_ten[exponent];
+            result = negative ? -result : result;
+            return position;
+        }
+#endif
+    }
+
+    result = parse_with_classic_locale(first, position);
+
+    return position;
+}
+
+double parse_double(const std::string &s)
+{
+    double result = 0.0;
+    parse_double(s.data(), s.data() + s.size(), result);
+
+    return result;
+}
+
+std::uint64_t parse_unsigned(const std::string &s)
+{
+    const auto max_value = std::numeric_limits<std::uint64_t>::max();
+    std::uint64_t result = 0;
+
+    for (auto c : s)
+    {
+        const auto digit = static_cast<std::uint64_t>(c - '0');
+
+        if (!is_digit(c) || result > (max_value - digit) / 10)
+        {
+            throw xlnt::exception("expected an unsigned integer, found \"" + s + "\"");
+        }
+
+        result = result * 10 + digit;
+    }
+
+    if (s.empty())
+    {
+        throw xlnt::exception("expected an unsigned integer, found an empty string");
+    }
+
+    return result;
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,56 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// Parses the decimal number at the start of [first, last) as written in
+/// SpreadsheetML (an optional sign, digits with an optional '.' and an
+/// optional exponent) regardless of the current locale. The result is the
+/// closest double to the decimal value. Returns a pointer past the last
+/// character used or first, with result set to 0, if there is no number.
+/// </summary>
+XLNT_API const char *parse_double(const char *first, const char *last, double &result);
+
+/// <summary>
+/// Returns the number at the start of s or 0 if s doesn't start with one.
+/// </summary>
+XLNT_API double parse_double(const std::string &s);
+
+/// <summary>
+/// Returns the non-negative integer s. Throws xlnt::exception if s isn't
+/// entirely made of decimal digits or doesn't fit in 64 bits.
+/// </summary>
+XLNT_API std::uint64_t parse_unsigned(const std::string &s);
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,159 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <algorithm>
+
+#include <detail/serialization/shared_string_arena.hpp>
+#include <detail/serialization/spill_file.hpp>
+#include <detail/serialization/xlsx_consumer.hpp>
+#include <xlnt/cell/rich_text.hpp>
+#include <xlnt/utils/exceptions.hpp>
+
+namespace {
+
+const std::size_t block_size = 64 * 1024;
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+shared_string_arena::shared_string_arena(std::size_t memory_limit)
+    : offsets_(1, 0),
+      memory_limit_(memory_limit),
+      block_offset_(0)
+{
+}
+
+shared_string_arena::~shared_string_arena()
+{
+}
+
+void shared_string_arena::append_text(const std::string &text)
+{
+    append(text.data(), text.size());
+    markup_.push_back(false);
+}
+
+void shared_string_arena::append_markup(const std::string &markup)
+{
+    append(markup.data(), markup.size());
+    markup_.push_back(true);
+}
+
+void shared_string_arena::append(const char *data, std::size_t size)
+{
+    if (!file_ && memory_.size() + size > memory_limit_)
+    {
+        // the strings already held are copied to the file before it replaces memory_
+        std::unique_ptr<spill_file> file(new spill_file());
+
+        if (file->sputn(memory_.data(), static_cast<std::streamsize>(memory_.size()))
+            != static_cast<std::streamsize>(memory_.size()))
+        {
+            throw xlnt::exception("unable to write temporary file");
+        }
+
+        file_ = std::move(file);
+        std::vector<char>().swap(memory_);
+    }
+
+    if (file_)
+    {
+        if (file_->sputn(data, static_cast<std::streamsize>(size)) != static_cast<std::streamsize>(size))
+        {
+            throw xlnt::exception("unable to write temporary file");
+        }
+    }
+    else
+    {
+        memory_.insert(memory_.end(), data, data + size);
+    }
+
+    offsets_.push_back(offsets_.back() + size);
+}
+
+std::size_t shared_string_arena::size() const
+{
+    return markup_.size();
+}
+
+bool shared_string_arena::spilled() const
+{
+    return file_ != nullptr;
+}
+
+std::string shared_string_arena::bytes(std::size_t index) const
+{
+    if (index >= size())
+    {
+        throw invalid_parameter();
+    }
+
+    const auto begin = offsets_[index];
+    const auto length = static_cast<std::size_t>(offsets_[index + 1] - begin);
+
+    if (!file_)
+    {
+        return std::string(memory_.data() + begin, length);
+    }
+
+    std::string result(length, '\0');
+
+    if (length == 0) return result;
+
+    if (length > block_size)
+    {
+        file_->read(begin, &result[0], length);
+        return result;
+    }
+
+    if (begin < block_offset_ || begin + length > block_offset_ + block_.size())
+    {
+        block_offset_ = begin;
+        block_.resize(static_cast<std::size_t>(std::min<std::uint64_t>(block_size, file_->size() - begin)));
+        file_->read(block_offset_, block_.data(), block_.size());
+    }
+
+    const auto start = block_.data() + (begin - block_offset_);
+    std::copy(start, start + length, result.begin());
+
+    return result;
+}
+
+rich_text shared_string_arena::at(std::size_t index) const
+{
+    auto stored = bytes(index);
+
+    return markup_[index] ? xlsx_consumer::decode_rich_text(stored) : rich_text(stored);
+}
+
+std::string shared_string_arena::text(std::size_t index) const
+{
+    auto stored = bytes(index);
+
+    return markup_[index] ? xlsx_consumer::decode_rich_text(stored).plain_text() : stored;
+}
+
+} // namespace detail
+} // namespace xlnt
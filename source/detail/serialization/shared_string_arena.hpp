@@ -0,0 +1,136 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+
+class rich_text;
+
+namespace detail {
+
+class spill_file;
+
+/// <summary>
+/// The shared string table of a workbook being read as a stream. Strings are
+/// stored back to back as UTF-8 with one offset per string, so the table takes
+/// about as much memory as sharedStrings.xml itself rather than one rich_text
+/// per string. Strings with more than a single unformatted run are stored as
+/// their markup and only decoded into runs when they are requested. Once the
+/// table exceeds its memory limit, it is moved to a temporary file.
+/// </summary>
+class XLNT_API shared_string_arena
+{
+public:
+    /// <summary>
+    /// Constructs an empty table which keeps up to memory_limit bytes of
+    /// strings in memory.
+    /// </summary>
+    explicit shared_string_arena(std::size_t memory_limit);
+
+    shared_string_arena(const shared_string_arena &) = delete;
+    shared_string_arena &operator=(const shared_string_arena &) = delete;
+
+    ~shared_string_arena();
+
+    /// <summary>
+    /// Appends a string consisting of a single unformatted run.
+    /// </summary>
+    void append_text(const std::string &text);
+
+    /// <summary>
+    /// Appends a string given as the markup of a CT_Rst element, including its
+    /// start and end tags and a declaration of its namespace.
+    /// </summary>
+    void append_markup(const std::string &markup);
+
+    /// <summary>
+    /// Returns the number of strings in the table.
+    /// </summary>
+    std::size_t size() const;
+
+    /// <summary>
+    /// Returns true if the table has been moved to a temporary file.
+    /// </summary>
+    bool spilled() const;
+
+    /// <summary>
+    /// Returns the string at index, decoding its runs if necessary. Throws
+    /// xlnt::invalid_parameter if index is out of range.
+    /// </summary>
+    rich_text at(std::size_t index) const;
+
+    /// <summary>
+    /// Returns the text of the string at index without its formatting. Only
+    /// strings stored as markup are decoded.
+    /// </summary>
+    std::string text(std::size_t index) const;
+
+private:
+    /// <summary>
+    /// Appends size bytes from data to the memory buffer or the temporary file.
+    /// </summary>
+    void append(const char *data, std::size_t size);
+
+    /// <summary>
+    /// Returns the bytes stored for the string at index.
+    /// </summary>
+    std::string bytes(std::size_t index) const;
+
+    /// <summary>
+    /// The offset of each string followed by the end of the last one.
+    /// </summary>
+    std::vector<std::uint64_t> offsets_;
+
+    /// <summary>
+    /// True for each string which is stored as markup.
+    /// </summary>
+    std::vector<bool> markup_;
+
+    std::size_t memory_limit_;
+
+    /// <summary>
+    /// The strings while the table is smaller than memory_limit_.
+    /// </summary>
+    std::vector<char> memory_;
+
+    std::unique_ptr<spill_file> file_;
+
+    /// <summary>
+    /// The most recently read block of file_, which serves neighbouring
+    /// strings without another read.
+    /// </summary>
+    mutable std::vector<char> block_;
+    mutable std::uint64_t block_offset_;
+};
+
+} // namespace detail
+} // namespace xlnt
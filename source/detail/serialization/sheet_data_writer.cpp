@@ -0,0 +1,287 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <cstring>
+
+#include <detail/external/include_libstudxml.hpp>
+#include <detail/serialization/sheet_data_writer.hpp>
+#include <detail/serialization/shortest_double.hpp>
+#include <xlnt/cell/cell_reference.hpp>
+
+namespace {
+
+// Large enough that a worksheet reaches the zip stream in few writes.
+const std::size_t buffer_size = 64 * 1024;
+
+const std::uint64_t ones = 0x0101010101010101ULL;
+const std::uint64_t high_bits = 0x8080808080808080ULL;
+
+/// <summary>
+/// Returns non-zero if any byte of word is zero.
+/// </summary>
+std::uint64_t has_zero_byte(std::uint64_t word)
+{
+    return (word - ones) & ~word & high_bits;
+}
+
+/// <summary>
+/// Returns non-zero if any of the eight bytes in word is a control character,
+/// part of a multibyte UTF-8 sequence or one of &amp;, &lt; and &gt;. These are
+/// the only bytes which might have to be escaped or rejected.
+/// </summary>
+std::uint64_t needs_escaping(std::uint64_t word)
+{
+    // a byte below 0x20 borrows into its high bit, one above 0x7f already has it set
+    const auto control_or_multibyte = ((word - ones * 0x20) | word) & high_bits;
+
+    return control_or_multibyte
+        | has_zero_byte(word ^ (ones * '&'))
+        | has_zero_byte(word ^ (ones * '<'))
+        | has_zero_byte(word ^ (ones * '>'));
+}
+
+bool needs_escaping(char c)
+{
+    const auto byte = static_cast<unsigned char>(c);
+    return byte < 0x20 || byte > 0x7f || c == '&' || c == '<' || c == '>';
+}
+
+/// <summary>
+/// Decodes the UTF-8 sequence starting at first and advances first past it.
+/// Returns -1 if the sequence is malformed, overlong or truncated.
+/// </summary>
+long decode_utf8(const char *&first, const char *last)
+{
+    const auto lead = static_cast<unsigned char>(*first++);
+
+    if (lead < 0x80) return lead;
+
+    std::size_t continuation_bytes = 0;
+    long code_point = 0;
+    long minimum = 0;
+
+    if ((lead & 0xe0) == 0xc0)
+    {
+        continuation_bytes = 1;
+        code_point = lead & 0x1f;
+        minimum = 0x80;
+    }
+    else if ((lead & 0xf0) == 0xe0)
+    {
+        continuation_bytes = 2;
+        code_point = lead & 0x0f;
+        minimum = 0x800;
+    }
+    else if ((lead & 0xf8) == 0xf0)
+    {
+        continuation_bytes = 3;
+        code_point = lead & 0x07;
+        minimum = 0x10000;
+    }
+    else
+    {
+        return -1;
+    }
+
+    if (static_cast<std::size_t>(last - first) < continuation_bytes) return -1;
+
+    for (std::size_t i = 0; i < continuation_bytes; ++i)
+    {
+        const auto byte = static_cast<unsigned char>(*first++);
+        if ((byte & 0xc0) != 0x80) return -1;
+        code_point = (code_point << 6) | (byte & 0x3f);
+    }
+
+    return code_point < minimum || code_point > 0x10ffff ? -1 : code_point;
+}
+
+/// <summary>
+/// Returns true if code_point is allowed in an XML 1.0 document.
+/// </summary>
+bool is_xml_char(long code_point)
+{
+    return code_point == 0x9 || code_point == 0xa || code_point == 0xd
+        || (code_point >= 0x20 && code_point <= 0xd7ff)
+        || (code_point >= 0xe000 && code_point <= 0xfffd)
+        || (code_point >= 0x10000 && code_point <= 0x10ffff);
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+sheet_data_writer::sheet_data_writer(std::ostream &destination, const std::string &part_name)
+    : destination_(destination),
+      part_name_(part_name),
+      buffer_(buffer_size),
+      size_(0)
+{
+}
+
+char *sheet_data_writer::reserve(std::size_t length)
+{
+    if (buffer_.size() - size_ < length)
+    {
+        flush();
+
+        if (buffer_.size() < length)
+        {
+            buffer_.resize(length);
+        }
+    }
+
+    return buffer_.data() + size_;
+}
+
+void sheet_data_writer::write_raw(const char *data, std::size_t length)
+{
+    std::memcpy(reserve(length), data, length);
+    size_ += length;
+}
+
+void sheet_data_writer::write_number(std::uint64_t value)
+{
+    char digits[20];
+    auto first = digits + sizeof(digits);
+
+    do
+    {
+        *--first = static_cast<char>('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+
+    write_raw(first, static_cast<std::size_t>(digits + sizeof(digits) - first));
+}
+
+void sheet_data_writer::write_number(std::int64_t value)
+{
+    if (value < 0)
+    {
+        write_markup("-");
+        // negate as unsigned so that the minimum value doesn't overflow
+        write_number(std::uint64_t(0) - static_cast<std::uint64_t>(value));
+    }
+    else
+    {
+        write_number(static_cast<std::uint64_t>(value));
+    }
+}
+
+void sheet_data_writer::write_number(double value)
+{
+    size_ += write_shortest_double(value, reserve(max_shortest_double_length));
+}
+
+void sheet_data_writer::write_reference(const cell_reference &reference)
+{
+    size_ += reference.to_chars(reserve(cell_reference::max_string_length));
+}
+
+void sheet_data_writer::write_text(const std::string &text)
+{
+    const auto first = text.data();
+    const auto last = first + text.size();
+    auto current = first;
+
+    // check eight characters at a time for anything which isn't plain ASCII
+    // text, so that most strings are copied without looking at each character
+    while (last - current >= 8)
+    {
+        std::uint64_t word;
+        std::memcpy(&word, current, sizeof(word));
+
+        if (needs_escaping(word)) break;
+
+        current += 8;
+    }
+
+    while (current != last && !needs_escaping(*current))
+    {
+        ++current;
+    }
+
+    write_raw(first, static_cast<std::size_t>(current - first));
+
+    if (current != last)
+    {
+        write_escaped(current, last);
+    }
+}
+
+void sheet_data_writer::write_escaped(const char *first, const char *last)
+{
+    // characters which don't need an entity are copied in runs
+    auto run = first;
+
+    while (first != last)
+    {
+        const auto sequence = first;
+        const auto code_point = decode_utf8(first, last);
+
+        if (code_point == -1)
+        {
+            throw xml::serialization(part_name_, "Bad UTF8");
+        }
+
+        if (!is_xml_char(code_point))
+        {
+            throw xml::serialization(part_name_, "Non XML Character");
+        }
+
+        if (code_point != '<' && code_point != '>' && code_point != '&' && code_point != 0xd)
+        {
+            continue;
+        }
+
+        write_raw(run, static_cast<std::size_t>(sequence - run));
+        run = first;
+
+        switch (code_point)
+        {
+        case '<':
+            write_markup("&lt;");
+            break;
+        case '>':
+            write_markup("&gt;");
+            break;
+        case '&':
+            write_markup("&amp;");
+            break;
+        default:
+            write_markup("&#xD;");
+            break;
+        }
+    }
+
+    write_raw(run, static_cast<std::size_t>(last - run));
+}
+
+void sheet_data_writer::flush()
+{
+    destination_.write(buffer_.data(), static_cast<std::streamsize>(size_));
+    size_ = 0;
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,123 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+
+class cell_reference;
+
+namespace detail {
+
+/// <summary>
+/// Writes the rows and cells of a worksheet's sheetData element straight into
+/// a buffer which is passed to the destination stream in large blocks. Markup
+/// is written as pre-rendered fragments with no indentation. Numbers and cell
+/// references are never escaped and text is only escaped when a fast scan finds
+/// a character which needs it. The xml::serializer writing the rest of the part
+/// must have closed the sheetData start tag, and flush must be called before
+/// it is used again.
+/// </summary>
+class XLNT_API sheet_data_writer
+{
+public:
+    /// <summary>
+    /// Constructs a writer which appends to destination. part_name is used in
+    /// exceptions thrown for text which can't be represented in XML.
+    /// </summary>
+    sheet_data_writer(std::ostream &destination, const std::string &part_name);
+
+    /// <summary>
+    /// Appends a fragment of markup without escaping it.
+    /// </summary>
+    template <std::size_t N>
+    void write_markup(const char (&fragment)[N])
+    {
+        write_raw(fragment, N - 1);
+    }
+
+    /// <summary>
+    /// Appends [data, data + length) without escaping it.
+    /// </summary>
+    void write_raw(const char *data, std::size_t length);
+
+    /// <summary>
+    /// Appends the decimal representation of value.
+    /// </summary>
+    void write_number(std::uint64_t value);
+
+    /// <summary>
+    /// Appends the decimal representation of value.
+    /// </summary>
+    void write_number(std::int64_t value);
+
+    /// <summary>
+    /// Appends a short decimal which reads back as value.
+    /// </summary>
+    void write_number(double value);
+
+    /// <summary>
+    /// Appends a reference such as A1.
+    /// </summary>
+    void write_reference(const cell_reference &reference);
+
+    /// <summary>
+    /// Appends text as character data, replacing &lt;, &gt;, &amp; and carriage
+    /// returns with entities as xml::serializer does. Throws xml::serialization
+    /// if text isn't valid UTF-8 or contains a character not allowed in XML.
+    /// </summary>
+    void write_text(const std::string &text);
+
+    /// <summary>
+    /// Passes everything written so far to the destination stream.
+    /// </summary>
+    void flush();
+
+private:
+    /// <summary>
+    /// Makes room for at least length more characters, flushing if needed,
+    /// and returns where they should be written.
+    /// </summary>
+    char *reserve(std::size_t length);
+
+    /// <summary>
+    /// Escapes [first, last) character by character.
+    /// </summary>
+    void write_escaped(const char *first, const char *last);
+
+    std::ostream &destination_;
+    std::string part_name_;
+    std::vector<char> buffer_;
+    std::size_t size_;
+};
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,458 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include <detail/serialization/shortest_double.hpp>
+
+// The digits are generated with Grisu2 (Florian Loitsch, "Printing
+// Floating-Point Numbers Quickly and Accurately with Integers", PLDI 2010)
+// using the boundary handling from Milo Yip's and Niels Lohmann's
+// implementations. The result always reads back as the original double and
+// is the shortest such decimal for nearly every input.
+
+namespace {
+
+/// <summary>
+/// A floating point number f * 2^e with a 64-bit significand.
+/// </summary>
+struct diy_fp
+{
+    std::uint64_t f;
+    int e;
+};
+
+diy_fp subtract(const diy_fp &x, const diy_fp &y)
+{
+    return {x.f - y.f, x.e};
+}
+
+/// <summary>
+/// Returns x * y rounded to the upper 64 bits of the 128-bit product.
+/// </summary>
+diy_fp multiply(const diy_fp &x, const diy_fp &y)
+{
+    const auto x_lo = x.f & 0xFFFFFFFFu;
+    const auto x_hi = x.f >> 32;
+    const auto y_lo = y.f & 0xFFFFFFFFu;
+    const auto y_hi = y.f >> 32;
+
+    const auto p0 = x_lo * y_lo;
+    const auto p1 = x_lo * y_hi;
+    const auto p2 = x_hi * y_lo;
+    const auto p3 = x_hi * y_hi;
+
+    auto middle = (p0 >> 32) + (p1 & 0xFFFFFFFFu) + (p2 & 0xFFFFFFFFu);
+    middle += std::uint64_t(1) << 31;
+
+    return {p3 + (p1 >> 32) + (p2 >> 32) + (middle >> 32), x.e + y.e + 64};
+}
+
+diy_fp normalize(diy_fp x)
+{
+    while ((x.f >> 63) == 0)
+    {
+        x.f <<= 1;
+        --x.e;
+    }
+
+    return x;
+}
+
+diy_fp normalize_to(const diy_fp &x, int e)
+{
+    return {x.f << (x.e - e), e};
+}
+
+/// <summary>
+/// Computes the normalized value v of a positive finite double along with
+/// the boundaries m- and m+ halfway to its neighbours. m- is scaled to the
+/// exponent of m+.
+/// </summary>
+void compute_boundaries(double value, diy_fp &v, diy_fp &m_minus, diy_fp &m_plus)
+{
+    const auto hidden_bit = std::uint64_t(1) << 52;
+    const auto exponent_bias = 1075;
+
+    std::uint64_t bits = 0;
+    std::memcpy(&bits, &value, sizeof(double));
+
+    const auto biased_exponent = static_cast<int>(bits >> 52);
+    const auto fraction = bits & (hidden_bit - 1);
+
+    const auto w = biased_exponent == 0
+        ? diy_fp{fraction, 1 - exponent_bias}
+        : diy_fp{fraction + hidden_bit, biased_exponent - exponent_bias};
+
+    // the gap to the next lower double is half as large when value is a
+    // power of two since the exponent changes between them
+    const auto lower_is_closer = fraction == 0 && biased_exponent > 1;
+
+    m_plus = normalize({2 * w.f + 1, w.e - 1});
+    m_minus = normalize_to(lower_is_closer ? diy_fp{4 * w.f - 1, w.e - 2} : diy_fp{2 * w.f - 1, w.e - 1}, m_plus.e);
+    v = normalize(w);
+}
+
+/// <summary>
+/// A normalized approximation f * 2^e of 10^k.
+/// </summary>
+struct cached_power
+{
+    std::uint64_t f;
+    int e;
+    int k;
+};
+
+// Products with a cached power land in the binary exponent range
+// [-60, -32] so that their integral part fits in 32 bits.
+const int alpha = -60;
+
+const int cached_powers_min_k = -300;
+const int cached_powers_step = 8;
+
+const cached_power cached_powers[] = {
+    {0xAB70FE17C79AC6CA, -1060, -300},
+    {0xFF77B1FCBEBCDC4F, -1034, -292},
+    {0xBE5691EF416BD60C, -1007, -284},
+    {0x8DD01FAD907FFC3C, -980, -276},
+    {0xD3515C2831559A83, -954, -268},
+    {0x9D71AC8FADA6C9B5, -927, -260},
+    {0xEA9C227723EE8BCB, -901, -252},
+    {0xAECC49914078536D, -874, -244},
+    {0x823C12795DB6CE57, -847, -236},
+    {0xC21094364DFB5637, -821, -228},
+    {0x9096EA6F3848984F, -794, -220},
+    {0xD77485CB25823AC7, -768, -212},
+    {0xA086CFCD97BF97F4, -741, -204},
+    {0xEF340A98172AACE5, -715, -196},
+    {0xB23867FB2A35B28E, -688, -188},
+    {0x84C8D4DFD2C63F3B, -661, -180},
+    {0xC5DD44271AD3CDBA, -635, -172},
+    {0x936B9FCEBB25C996, -608, -164},
+    {0xDBAC6C247D62A584, -582, -156},
+    {0xA3AB66580D5FDAF6, -555, -148},
+    {0xF3E2F893DEC3F126, -529, -140},
+    {0xB5B5ADA8AAFF80B8, -502, -132},
+    {0x87625F056C7C4A8B, -475, -124},
+    {0xC9BCFF6034C13053, -449, -116},
+    {0x964E858C91BA2655, -422, -108},
+    {0xDFF9772470297EBD, -396, -100},
+    {0xA6DFBD9FB8E5B88F, -369, -92},
+    {0xF8A95FCF88747D94, -343, -84},
+    {0xB94470938FA89BCF, -316, -76},
+    {0x8A08F0F8BF0F156B, -289, -68},
+    {0xCDB02555653131B6, -263, -60},
+    {0x993FE2C6D07B7FAC, -236, -52},
+    {0xE45C10C42A2B3B06, -210, -44},
+    {0xAA242499697392D3, -183, -36},
+    {0xFD87B5F28300CA0E, -157, -28},
+    {0xBCE5086492111AEB, -130, -20},
+    {0x8CBCCC096F5088CC, -103, -12},
+    {0xD1B71758E219652C, -77, -4},
+    {0x9C40000000000000, -50, 4},
+    {0xE8D4A51000000000, -24, 12},
+    {0xAD78EBC5AC620000, 3, 20},
+    {0x813F3978F8940984, 30, 28},
+    {0xC097CE7BC90715B3, 56, 36},
+    {0x8F7E32CE7BEA5C70, 83, 44},
+    {0xD5D238A4ABE98068, 109, 52},
+    {0x9F4F2726179A2245, 136, 60},
+    {0xED63A231D4C4FB27, 162, 68},
+    {0xB0DE65388CC8ADA8, 189, 76},
+    {0x83C7088E1AAB65DB, 216, 84},
+    {0xC45D1DF942711D9A, 242, 92},
+    {0x924D692CA61BE758, 269, 100},
+    {0xDA01EE641A708DEA, 295, 108},
+    {0xA26DA3999AEF774A, 322, 116},
+    {0xF209787BB47D6B85, 348, 124},
+    {0xB454E4A179DD1877, 375, 132},
+    {0x865B86925B9BC5C2, 402, 140},
+    {0xC83553C5C8965D3D, 428, 148},
+    {0x952AB45CFA97A0B3, 455, 156},
+    {0xDE469FBD99A05FE3, 481, 164},
+    {0xA59BC234DB398C25, 508, 172},
+    {0xF6C69A72A3989F5C, 534, 180},
+    {0xB7DCBF5354E9BECE, 561, 188},
+    {0x88FCF317F22241E2, 588, 196},
+    {0xCC20CE9BD35C78A5, 614, 204},
+    {0x98165AF37B2153DF, 641, 212},
+    {0xE2A0B5DC971F303A, 667, 220},
+    {0xA8D9D1535CE3B396, 694, 228},
+    {0xFB9B7CD9A4A7443C, 720, 236},
+    {0xBB764C4CA7A44410, 747, 244},
+    {0x8BAB8EEFB6409C1A, 774, 252},
+    {0xD01FEF10A657842C, 800, 260},
+    {0x9B10A4E5E9913129, 827, 268},
+    {0xE7109BFBA19C0C9D, 853, 276},
+    {0xAC2820D9623BF429, 880, 284},
+    {0x80444B5E7AA7CF85, 907, 292},
+    {0xBF21E44003ACDD2D, 933, 300},
+    {0x8E679C2F5E44FF8F, 960, 308},
+    {0xD433179D9C8CB841, 986, 316},
+    {0x9E19DB92B4E31BA9, 1013, 324},
+};
+
+/// <summary>
+/// Returns the cached power c = 10^-k such that e + c.e + 64 is in [-60, -32].
+/// </summary>
+const cached_power &cached_power_for(int e)
+{
+    // k = ceil((alpha - e - 1) * log10(2)) with log10(2) ~ 78913 / 2^18
+    const auto f = alpha - e - 1;
+    const auto k = (f * 78913) / (1 << 18) + (f > 0 ? 1 : 0);
+    const auto index = (-cached_powers_min_k + k + (cached_powers_step - 1)) / cached_powers_step;
+
+    return cached_powers[index];
+}
+
+/// <summary>
+/// Returns the number of decimal digits in n and sets power to 10^(digits - 1).
+/// </summary>
+int count_digits(std::uint32_t n, std::uint32_t &power)
+{
+    auto digits = 1;
+    power = 1;
+
+    while (digits < 10 && n / power >= 10)
+    {
+        power *= 10;
+        ++digits;
+    }
+
+    return digits;
+}
+
+/// <summary>
+/// Moves the last generated digit towards the exact value while the result
+/// stays within the rounding interval.
+/// </summary>
+void round_last_digit(char *digits, int length, std::uint64_t distance, std::uint64_t delta,
+    std::uint64_t rest, std::uint64_t ten_k)
+{
+    while (rest < distance && delta - rest >= ten_k
+        && (rest + ten_k < distance || distance - rest > rest + ten_k - distance))
+    {
+        --digits[length - 1];
+        rest += ten_k;
+    }
+}
+
+/// <summary>
+/// Generates the shortest digits of a number in the interval (m_minus, m_plus)
+/// closest to w. The value is digits * 10^decimal_exponent afterwards.
+/// </summary>
+void generate_digits(char *digits, int &length, int &decimal_exponent,
+    const diy_fp &m_minus, const diy_fp &w, const diy_fp &m_plus)
+{
+    auto delta = subtract(m_plus, m_minus).f;
+    auto distance = subtract(m_plus, w).f;
+
+    const auto shift = -m_plus.e;
+    const auto one = std::uint64_t(1) << shift;
+
+    auto integral = static_cast<std::uint32_t>(m_plus.f >> shift);
+    auto fractional = m_plus.f & (one - 1);
+
+    std::uint32_t power = 1;
+    auto remaining = count_digits(integral, power);
+
+    while (remaining > 0)
+    {
+        digits[length++] = static_cast<char>('0' + integral / power);
+        integral %= power;
+        --remaining;
+
+        const auto rest = (static_cast<std::uint64_t>(integral) << shift) + fractional;
+
+        if (rest <= delta)
+        {
+            decimal_exponent += remaining;
+            round_last_digit(digits, length, distance, delta, rest, static_cast<std::uint64_t>(power) << shift);
+
+            return;
+        }
+
+        power /= 10;
+    }
+
+    auto fractional_digits = 0;
+
+    while (true)
+    {
+        fractional *= 10;
+        digits[length++] = static_cast<char>('0' + (fractional >> shift));
+        fractional &= one - 1;
+        ++fractional_digits;
+
+        delta *= 10;
+        distance *= 10;
+
+        if (fractional <= delta) break;
+    }
+
+    decimal_exponent -= fractional_digits;
+    round_last_digit(digits, length, distance, delta, fractional, one);
+}
+
+/// <summary>
+/// Generates the digits of a positive finite double.
+/// </summary>
+void grisu2(double value, char *digits, int &length, int &decimal_exponent)
+{
+    diy_fp v, m_minus, m_plus;
+    compute_boundaries(value, v, m_minus, m_plus);
+
+    const auto &power = cached_power_for(m_plus.e);
+    const diy_fp c_minus_k{power.f, power.e};
+
+    const auto w = multiply(v, c_minus_k);
+    const auto w_minus = multiply(m_minus, c_minus_k);
+    const auto w_plus = multiply(m_plus, c_minus_k);
+
+    // the products may be off by one unit so the interval is narrowed to
+    // keep every generated number strictly inside the rounding interval
+    const diy_fp lower{w_minus.f + 1, w_minus.e};
+    const diy_fp upper{w_plus.f - 1, w_plus.e};
+
+    length = 0;
+    decimal_exponent = -power.k;
+    generate_digits(digits, length, decimal_exponent, lower, w, upper);
+}
+
+char *write_exponent(char *out, int exponent)
+{
+    *out++ = 'E';
+    *out++ = exponent < 0 ? '-' : '+';
+
+    auto magnitude = static_cast<unsigned int>(exponent < 0 ? -exponent : exponent);
+
+    if (magnitude >= 100)
+    {
+        *out++ = static_cast<char>('0' + magnitude / 100);
+        magnitude %= 100;
+        *out++ = static_cast<char>('0' + magnitude / 10);
+    }
+    else if (magnitude >= 10)
+    {
+        *out++ = static_cast<char>('0' + magnitude / 10);
+    }
+
+    *out++ = static_cast<char>('0' + magnitude % 10);
+
+    return out;
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+std::size_t write_shortest_double(double value, char *buffer)
+{
+    auto out = buffer;
+
+    if (std::isnan(value))
+    {
+        std::memcpy(out, "NaN", 3);
+        return 3;
+    }
+
+    if (std::signbit(value))
+    {
+        *out++ = '-';
+        value = -value;
+    }
+
+    if (std::isinf(value))
+    {
+        std::memcpy(out, "INF", 3);
+        return static_cast<std::size_t>(out - buffer) + 3;
+    }
+
+    if (value == 0)
+    {
+        *out++ = '0';
+        return static_cast<std::size_t>(out - buffer);
+    }
+
+    char digits[20];
+    auto length = 0;
+    auto decimal_exponent = 0;
+    grisu2(value, digits, length, decimal_exponent);
+
+    // the value is 0.digits * 10^point
+    const auto point = length + decimal_exponent;
+
+    if (length <= point && point <= 21)
+    {
+        std::memcpy(out, digits, static_cast<std::size_t>(length));
+        out += length;
+        std::memset(out, '0', static_cast<std::size_t>(point - length));
+        out += point - length;
+    }
+    else if (0 < point && point <= 21)
+    {
+        std::memcpy(out, digits, static_cast<std::size_t>(point));
+        out += point;
+        *out++ = '.';
+        std::memcpy(out, digits + point, static_cast<std::size_t>(length - point));
+        out += length - point;
+    }
+    else if (-6 < point && point <= 0)
+    {
+        *out++ = '0';
+        *out++ = '.';
+        std::memset(out, '0', static_cast<std::size_t>(-point));
+        out += -point;
+        std::memcpy(out, digits, static_cast<std::size_t>(length));
+        out += length;
+    }
+    else
+    {
+        *out++ = digits[0];
+
+        if (length > 1)
+        {
+            *out++ = '.';
+            std::memcpy(out, digits + 1, static_cast<std::size_t>(length - 1));
+            out += length - 1;
+        }
+
+        out = write_exponent(out, point - 1);
+    }
+
+    return static_cast<std::size_t>(out - buffer);
+}
+
+std::string shortest_double(double value)
+{
+    char buffer[max_shortest_double_length];
+
+    return std::string(buffer, write_shortest_double(value, buffer));
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,58 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// The largest number of characters write_shortest_double writes.
+/// </summary>
+const std::size_t max_shortest_double_length = 32;
+
+/// <summary>
+/// Writes a short decimal representation of value which reads back as exactly
+/// value to buffer and returns the number of characters written without a
+/// terminating null. The digits come from Grisu2, which finds the shortest
+/// such decimal for almost every double but may use one more digit for a
+/// few. Values from 1e-6 up to 1e21 are written in fixed notation, others in
+/// scientific notation such as 1.5E-7. Infinities and NaN are written as INF,
+/// -INF and NaN as in xsd:double.
+/// </summary>
+XLNT_API std::size_t write_shortest_double(double value, char *buffer);
+
+/// <summary>
+/// Returns the decimal representation of value as written by
+/// write_shortest_double.
+/// </summary>
+XLNT_API std::string shortest_double(double value);
+
+} // namespace detail
+} // namespace xlnt
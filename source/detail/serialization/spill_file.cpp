@@ -0,0 +1,139 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#include <algorithm>
+#include <vector>
+
+#include <detail/serialization/spill_file.hpp>
+#include <xlnt/utils/exceptions.hpp>
+
+namespace {
+
+// std::fseek takes a long, which is 32 bits wide on Windows
+int seek(std::FILE *file, std::uint64_t offset)
+{
+#ifdef _MSC_VER
+    return _fseeki64(file, static_cast<__int64>(offset), SEEK_SET);
+#else
+    return fseeko(file, static_cast<off_t>(offset), SEEK_SET);
+#endif
+}
+
+} // namespace
+
+namespace xlnt {
+namespace detail {
+
+spill_file::spill_file()
+    : file_(std::tmpfile()),
+      size_(0)
+{
+    if (file_ == nullptr)
+    {
+        throw xlnt::exception("unable to create temporary file");
+    }
+
+    // nothing is buffered here since the C library buffers the file
+    setp(nullptr, nullptr);
+}
+
+spill_file::~spill_file()
+{
+    std::fclose(file_);
+}
+
+std::uint64_t spill_file::size() const
+{
+    return size_;
+}
+
+spill_file::int_type spill_file::overflow(int_type c)
+{
+    if (traits_type::eq_int_type(c, traits_type::eof()))
+    {
+        return traits_type::not_eof(c);
+    }
+
+    if (std::fputc(c, file_) == EOF)
+    {
+        return traits_type::eof();
+    }
+
+    ++size_;
+
+    return c;
+}
+
+std::streamsize spill_file::xsputn(const char *s, std::streamsize n)
+{
+    const auto written = std::fwrite(s, 1, static_cast<std::size_t>(n), file_);
+    size_ += written;
+
+    return static_cast<std::streamsize>(written);
+}
+
+int spill_file::sync()
+{
+    return std::fflush(file_) == 0 ? 0 : -1;
+}
+
+void spill_file::copy_to(std::ostream &destination)
+{
+    if (std::fflush(file_) != 0 || std::fseek(file_, 0, SEEK_SET) != 0)
+    {
+        throw xlnt::exception("unable to read temporary file");
+    }
+
+    std::vector<char> buffer(64 * 1024);
+    std::uint64_t remaining = size_;
+
+    while (remaining > 0)
+    {
+        const auto length = static_cast<std::size_t>(std::min<std::uint64_t>(remaining, buffer.size()));
+
+        if (std::fread(buffer.data(), 1, length, file_) != length)
+        {
+            throw xlnt::exception("unable to read temporary file");
+        }
+
+        destination.write(buffer.data(), static_cast<std::streamsize>(length));
+        remaining -= length;
+    }
+
+    // a read must be followed by a seek before the next write
+    std::fseek(file_, 0, SEEK_END);
+}
+
+void spill_file::read(std::uint64_t offset, char *destination, std::size_t count)
+{
+    if (offset + count > size_ || std::fflush(file_) != 0 || seek(file_, offset) != 0
+        || std::fread(destination, 1, count, file_) != count)
+    {
+        throw xlnt::exception("unable to read temporary file");
+    }
+
+    std::fseek(file_, 0, SEEK_END);
+}
+
+} // namespace detail
+} // namespace xlnt
@@ -0,0 +1,88 @@
+// Copyright (c) 2014-2017 Thomas Fussell
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in
+// all copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, WRISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+// THE SOFTWARE
+//
+// @license: http://www.opensource.org/licenses/mit-license.php
+// @author: see AUTHORS file
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+
+#include <xlnt/xlnt_config.hpp>
+
+namespace xlnt {
+namespace detail {
+
+/// <summary>
+/// An anonymous temporary file which can be appended to through a std::ostream.
+/// It holds data which would otherwise grow in memory with the size of a
+/// workbook and is deleted when closed, even if the process exits abnormally.
+/// </summary>
+class XLNT_API spill_file : public std::streambuf
+{
+    using int_type = std::streambuf::int_type;
+
+public:
+    /// <summary>
+    /// Creates an empty temporary file. Throws xlnt::exception if it can't be created.
+    /// </summary>
+    spill_file();
+
+    spill_file(const spill_file &) = delete;
+    spill_file &operator=(const spill_file &) = delete;
+
+    /// <summary>
+    /// Closes and deletes the file.
+    /// </summary>
+    ~spill_file();
+
+    /// <summary>
+    /// Returns the number of bytes appended so far.
+    /// </summary>
+    std::uint64_t size() const;
+
+    /// <summary>
+    /// Writes the whole contents of the file to destination. More data can be
+    /// appended afterwards.
+    /// </summary>
+    void copy_to(std::ostream &destination);
+
+    /// <summary>
+    /// Reads count bytes starting at offset into destination. Throws
+    /// xlnt::exception if the range is past the end of the file.
+    /// </summary>
+    void read(std::uint64_t offset, char *destination, std::size_t count);
+
+private:
+    int_type overflow(int_type c = traits_type::eof());
+
+    std::streamsize xsputn(const char *s, std::streamsize n);
+
+    int sync();
+
+    std::FILE *file_;
+    std::uint64_t size_;
+};
+
+} // namespace detail
+} // namespace xlnt
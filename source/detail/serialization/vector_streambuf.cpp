@@ -53,6 +53,17 @@ vector_istreambuf::int_type vector_istreambuf::uflow()
     return traits_type::to_int_type(static_cast<char>(data_[position_++]));
 }
 
+std::streamsize vector_istreambuf::xsgetn(char *s, std::streamsize n)
+{
+    // copy in bulk rather than a character at a time through uflow
+    const auto count = std::min(static_cast<std::size_t>(n), data_.size() - position_);
+    std::copy(data_.begin() + static_cast<std::ptrdiff_t>(position_),
+        data_.begin() + static_cast<std::ptrdiff_t>(position_ + count), s);
+    position_ += count;
+
+    return static_cast<std::streamsize>(count);
+}
+
 std::streamsize vector_istreambuf::showmanyc()
 {
     if (position_ == data_.size())
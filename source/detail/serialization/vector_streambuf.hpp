@@ -50,6 +50,8 @@ private:
 
     int_type uflow();
 
+    std::streamsize xsgetn(char *s, std::streamsize n);
+
     std::streamsize showmanyc();
 
     std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode);
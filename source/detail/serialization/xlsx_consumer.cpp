@@ -21,23 +21,32 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <atomic>
 #include <cctype>
+#include <exception>
 #include <numeric> // for std::accumulate
 #include <sstream>
+#include <thread>
 #include <unordered_map>
 
 #include <detail/constants.hpp>
 #include <detail/header_footer/header_footer_code.hpp>
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/serialization/custom_value_traits.hpp>
+#include <detail/serialization/deferred_parts.hpp>
+#include <detail/serialization/mapped_file.hpp>
+#include <detail/serialization/number_parser.hpp>
+#include <detail/serialization/shared_string_arena.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_consumer.hpp>
 #include <detail/serialization/zstream.hpp>
 #include <xlnt/cell/cell.hpp>
+#include <xlnt/cell/cell_view.hpp>
 #include <xlnt/cell/comment.hpp>
 #include <xlnt/packaging/manifest.hpp>
 #include <xlnt/utils/optional.hpp>
 #include <xlnt/utils/path.hpp>
+#include <xlnt/workbook/read_plan.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/selection.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
@@ -61,20 +70,17 @@ struct hash<xml::qname>
 
 namespace {
 
-xml::qname &qn(const std::string &namespace_, const std::string &name)
-{
-    using qname_map = std::unordered_map<std::string, xml::qname>;
-    static auto &memo = *new std::unordered_map<std::string, qname_map>();
-
-    auto &ns_memo = memo[namespace_];
-
-    if (ns_memo.find(name) == ns_memo.end())
-    {
-        return ns_memo.emplace(name, xml::qname(xlnt::constants::ns(namespace_), name)).first->second;
-    }
-
-    return ns_memo[name];
-}
+/// <summary>
+/// Returns the qualified name called name in the namespace with the given id
+/// (see xlnt::constants::ns). Each use site builds its qname the first time it
+/// is reached and returns that same instance afterwards, so both arguments
+/// must be literals.
+/// </summary>
+#define qn(namespace_, name) \
+    ([]() -> const xml::qname & { \
+        static const xml::qname interned(xlnt::constants::ns(namespace_), name); \
+        return interned; \
+    }())
 
 #ifdef THROW_ON_INVALID_XML
 #define unexpected_element(element) throw xlnt::exception(element.string());
@@ -105,24 +111,79 @@ bool is_true(const std::string &bool_string)
 #endif
 }
 
-struct number_converter
+/// <summary>
+/// Returns the cell_type corresponding to the t attribute of a c element.
+/// </summary>
+xlnt::cell_type parse_cell_type(const std::string &t)
+{
+    if (t == "n") return xlnt::cell_type::number;
+    if (t == "s") return xlnt::cell_type::shared_string;
+    if (t == "b") return xlnt::cell_type::boolean;
+    if (t == "str") return xlnt::cell_type::formula_string;
+    if (t == "inlineStr") return xlnt::cell_type::inline_string;
+    if (t == "d") return xlnt::cell_type::date;
+
+    return xlnt::cell_type::error;
+}
+
+/// <summary>
+/// Skips the content of the element whose start event was just consumed,
+/// including its end event.
+/// </summary>
+void skip_element(xml::parser &p)
 {
-    number_converter()
+    auto depth = 1;
+
+    while (depth > 0)
     {
-        stream.imbue(std::locale("C"));
+        switch (p.next())
+        {
+        case xml::parser::event_type::start_element:
+            p.attribute_map();
+            ++depth;
+            break;
+
+        case xml::parser::event_type::end_element:
+            --depth;
+            break;
+
+        default:
+            break;
+        }
     }
+}
 
-    double stold(const std::string &s)
+/// <summary>
+/// Appends text to markup with the characters that can't appear literally in
+/// element content or attribute values replaced by references.
+/// </summary>
+void append_escaped(std::string &markup, const std::string &text)
+{
+    for (auto c : text)
     {
-        stream.str(s);
-        stream.clear();
-        stream >> result;
-        return result;
+        switch (c)
+        {
+        case '&':
+            markup.append("&amp;");
+            break;
+        case '<':
+            markup.append("&lt;");
+            break;
+        case '>':
+            markup.append("&gt;");
+            break;
+        case '"':
+            markup.append("&quot;");
+            break;
+        case '\r':
+            markup.append("&#xD;");
+            break;
+        default:
+            markup.push_back(c);
+            break;
+        }
     }
-
-    std::istringstream stream;
-    double result;
-};
+}
 
 } // namespace
 
@@ -158,13 +219,67 @@ xlsx_consumer::~xlsx_consumer()
 
 void xlsx_consumer::read(std::istream &source)
 {
-    archive_.reset(new izstream(source));
+    if (options_.lazy_parts)
+    {
+        // parts are read after source may be gone so the archive reads a copy
+        deferred_ = std::make_shared<deferred_parts>();
+        source.seekg(0, std::ios::end);
+        deferred_->package.resize(static_cast<std::size_t>(source.tellg()));
+        source.seekg(0, std::ios::beg);
+        source.read(reinterpret_cast<char *>(deferred_->package.data()),
+            static_cast<std::streamsize>(deferred_->package.size()));
+
+        if (static_cast<std::size_t>(source.gcount()) != deferred_->package.size())
+        {
+            throw xlnt::exception("failed to read package");
+        }
+
+        archive_.reset(new izstream(deferred_->package.data(), deferred_->package.size(), options_.zip_buffer_size));
+        populate_workbook(false);
+
+        return;
+    }
+
+    archive_.reset(new izstream(source, options_.zip_buffer_size));
+    populate_workbook(false);
+}
+
+void xlsx_consumer::read(std::istream &source, const load_options &options)
+{
+    options_ = options;
+    read(source);
+}
+
+void xlsx_consumer::read(const path &source, const load_options &options)
+{
+    options_ = options;
+    archive_.reset(new izstream(std::make_shared<mapped_file>(source), options_.zip_buffer_size));
+
+    if (options_.lazy_parts)
+    {
+        // the archive keeps the mapping alive
+        deferred_ = std::make_shared<deferred_parts>();
+    }
+
     populate_workbook(false);
 }
 
 void xlsx_consumer::open(std::istream &source)
 {
-    archive_.reset(new izstream(source));
+    archive_.reset(new izstream(source, options_.zip_buffer_size));
+    populate_workbook(true);
+}
+
+void xlsx_consumer::open(std::istream &source, const load_options &options)
+{
+    options_ = options;
+    open(source);
+}
+
+void xlsx_consumer::open(const path &source, const load_options &options)
+{
+    options_ = options;
+    archive_.reset(new izstream(std::make_shared<mapped_file>(source), options_.zip_buffer_size));
     populate_workbook(true);
 }
 
@@ -177,41 +292,44 @@ cell xlsx_consumer::read_cell()
 
     auto ws = worksheet(current_worksheet_);
 
-    if (in_element(qn("spreadsheetml", "sheetData")))
+    if (cell_started_)
     {
-        expect_start_element(qn("spreadsheetml", "row"), xml::content::complex); // CT_Row
-        auto row_index = static_cast<row_t>(std::stoul(parser().attribute("r")));
-
-        if (parser().attribute_present("ht"))
+        // next_planned_cell consumed the start tag when has_cell was called
+        cell_started_ = false;
+        push_element(qn("spreadsheetml", "c"));
+    }
+    else
+    {
+        if (in_element(element_token::sheet_data))
         {
-            ws.row_properties(row_index).height = parser().attribute<double>("ht");
+            read_row_begin();
         }
 
-        if (parser().attribute_present("customHeight"))
+        if (!in_element(element_token::row))
         {
-            ws.row_properties(row_index).custom_height = is_true(parser().attribute("customHeight"));
+            return cell(nullptr);
         }
 
-        if (parser().attribute_present("hidden") && is_true(parser().attribute("hidden")))
-        {
-            ws.row_properties(row_index).hidden = true;
-        }
-        skip_attributes({ qn("x14ac", "dyDescent") });
-        skip_attributes({ "customFormat", "s", "customFont",
-            "outlineLevel", "collapsed", "thickTop", "thickBot",
-            "ph", "spans" });
+        expect_start_element(qn("spreadsheetml", "c"), xml::content::complex);
     }
 
-    if (!in_element(qn("spreadsheetml", "row")))
+    auto reference = cell_reference(parser().attribute("r"));
+
+    if (streaming_)
     {
-        return cell(nullptr);
-    }
+        // release what the previous cell registered with its worksheet before reusing it
+        if (streaming_cell_->parent_ != nullptr)
+        {
+            streaming_cell_->clear_text();
+            streaming_cell_->clear_formula();
+            streaming_cell_->clear_hyperlink();
+            streaming_cell_->type(cell_type::empty);
+        }
 
-    expect_start_element(qn("spreadsheetml", "c"), xml::content::complex);
+        *streaming_cell_ = detail::cell_impl();
+    }
 
-    auto cell = streaming_ ? xlnt::cell(streaming_cell_.get())
-        : ws.cell(cell_reference(parser().attribute("r")));
-    auto reference = cell_reference(parser().attribute("r"));
+    auto cell = streaming_ ? xlnt::cell(streaming_cell_.get()) : ws.cell(reference);
     cell.d_->parent_ = current_worksheet_;
     cell.d_->column_ = reference.column_index();
     cell.d_->row_ = reference.row();
@@ -221,7 +339,7 @@ cell xlsx_consumer::read_cell()
 
     if (parser().attribute_present("s"))
     {
-		    cell.format(target_.format(std::stoull(parser().attribute("s"))));
+		    cell.format(target_.format(parse_unsigned(parser().attribute("s"))));
     }
 
     auto has_value = false;
@@ -231,16 +349,16 @@ cell xlsx_consumer::read_cell()
     auto has_shared_formula = false;
     auto formula_value_string = std::string();
 
-    while (in_element(qn("spreadsheetml", "c")))
+    while (in_element(element_token::c))
     {
-        auto current_element = expect_start_element(xml::content::mixed);
+        const auto child = expect_start_token(xml::content::mixed);
 
-        if (current_element == qn("spreadsheetml", "v")) // s:ST_Xstring
+        if (child == element_token::v) // s:ST_Xstring
         {
             has_value = true;
             value_string = read_text();
         }
-        else if (current_element == qn("spreadsheetml", "f")) // CT_CellFormula
+        else if (child == element_token::f) // CT_CellFormula
         {
             has_formula = true;
 
@@ -254,7 +372,7 @@ cell xlsx_consumer::read_cell()
 
             formula_value_string = read_text();
         }
-        else if (current_element == qn("spreadsheetml", "is")) // CT_Rst
+        else if (child == element_token::is) // CT_Rst
         {
             expect_start_element(qn("spreadsheetml", "t"), xml::content::simple);
             value_string = read_text();
@@ -262,36 +380,35 @@ cell xlsx_consumer::read_cell()
         }
         else
         {
-            unexpected_element(current_element);
+            unexpected_element(current_element());
         }
 
-        expect_end_element(current_element);
+        expect_end_element();
     }
 
-    expect_end_element(qn("spreadsheetml", "c"));
+    expect_end_element();
 
     if (has_formula && !has_shared_formula)
     {
         cell.formula(formula_value_string);
     }
 
-    number_converter converter;
 
     if (has_value)
     {
         if (type == "str")
         {
-            cell.d_->value_text_ = value_string;
+            cell.d_->text(value_string);
             cell.data_type(cell::type::formula_string);
         }
         else if (type == "inlineStr")
         {
-            cell.d_->value_text_ = value_string;
+            cell.d_->text(value_string);
             cell.data_type(cell::type::inline_string);
         }
         else if (type == "s")
         {
-            cell.d_->value_numeric_ = converter.stold(value_string);
+            cell.d_->value_numeric_ = static_cast<double>(parse_unsigned(value_string));
             cell.data_type(cell::type::shared_string);
         }
         else if (type == "b") // boolean
@@ -300,7 +417,7 @@ cell xlsx_consumer::read_cell()
         }
         else if (type == "n") // numeric
         {
-            cell.value(converter.stold(value_string));
+            cell.value(parse_double(value_string));
         }
         else if (!value_string.empty() && value_string[0] == '#')
         {
@@ -308,11 +425,11 @@ cell xlsx_consumer::read_cell()
         }
     }
 
-    if (!in_element(qn("spreadsheetml", "row")))
+    if (!in_element(element_token::row))
     {
         expect_end_element(qn("spreadsheetml", "row"));
 
-        if (!in_element(qn("spreadsheetml", "sheetData")))
+        if (!in_element(element_token::sheet_data))
         {
             expect_end_element(qn("spreadsheetml", "sheetData"));
         }
@@ -321,6 +438,237 @@ cell xlsx_consumer::read_cell()
     return cell;
 }
 
+row_t xlsx_consumer::read_row_begin()
+{
+    expect_start_element(qn("spreadsheetml", "row"), xml::content::complex); // CT_Row
+    auto row_index = static_cast<row_t>(parse_unsigned(parser().attribute("r")));
+    read_row_properties(row_index);
+
+    return row_index;
+}
+
+void xlsx_consumer::read_row_properties(row_t row_index)
+{
+    auto ws = worksheet(current_worksheet_);
+
+    if (parser().attribute_present("ht"))
+    {
+        ws.row_properties(row_index).height = parser().attribute<double>("ht");
+    }
+
+    if (parser().attribute_present("customHeight"))
+    {
+        ws.row_properties(row_index).custom_height = is_true(parser().attribute("customHeight"));
+    }
+
+    if (parser().attribute_present("hidden") && is_true(parser().attribute("hidden")))
+    {
+        ws.row_properties(row_index).hidden = true;
+    }
+    skip_attributes({ qn("x14ac", "dyDescent") });
+    skip_attributes({ "customFormat", "s", "customFont",
+        "outlineLevel", "collapsed", "thickTop", "thickBot",
+        "ph", "spans" });
+}
+
+void xlsx_consumer::read_cells(const std::function<void(const cell_view &)> &visitor)
+{
+    const auto &c = qn("spreadsheetml", "c");
+
+    cell_view view;
+    auto current_row = streaming_cell_->row_;
+
+    // number formats were classified when the stylesheet was read
+    const auto stylesheet = target_.d_->stylesheet_.is_set() ? &target_.d_->stylesheet_.get() : nullptr;
+
+    if (planned_)
+    {
+        while (next_planned_cell())
+        {
+            cell_started_ = false;
+            view.row = planned_row_;
+            view.column = planned_column_;
+            read_cell_view(view, stylesheet);
+            visitor(view);
+        }
+
+        return;
+    }
+
+    // Cells are read straight from parser events rather than through
+    // expect_start_element so that no qname is copied onto stack_ per cell.
+    while (has_cell())
+    {
+        if (in_element(element_token::sheet_data))
+        {
+            current_row = read_row_begin();
+        }
+
+        view.column = 0;
+
+        while (in_element(element_token::row))
+        {
+            parser().next_expect(xml::parser::event_type::start_element, c);
+            parser().content(xml::content::complex);
+
+            // r is optional, in which case the cell follows the previous one
+            view.row = current_row;
+            view.column = view.column + 1;
+            read_cell_view(view, stylesheet);
+            visitor(view);
+        }
+
+        expect_end_element();
+
+        if (!in_element(element_token::sheet_data))
+        {
+            expect_end_element();
+        }
+    }
+}
+
+void xlsx_consumer::read_cell_view(cell_view &view, stylesheet *stylesheet)
+{
+    view.type = cell_type::number;
+    view.number = 0;
+    view.shared_string = 0;
+    view.text = nullptr;
+    view.text_length = 0;
+    view.has_format = false;
+    view.format = 0;
+    view.is_date = false;
+    view.is_timedelta = false;
+
+    for (const auto &attribute : parser().attribute_map())
+    {
+        const auto &name = attribute.first.name();
+        const auto &value = attribute.second.value;
+
+        if (name == "r")
+        {
+            const auto reference = cell_reference::from_chars(value.data(), value.data() + value.size());
+            view.column = reference.column_index();
+            view.row = reference.row();
+        }
+        else if (name == "s")
+        {
+            view.has_format = true;
+            view.format = static_cast<std::size_t>(parse_unsigned(value));
+        }
+        else if (name == "t")
+        {
+            view.type = parse_cell_type(value);
+        }
+    }
+
+    auto has_value = false;
+    cell_text_.clear();
+
+    while (parser().peek() == xml::parser::event_type::start_element)
+    {
+        parser().next();
+        parser().attribute_map();
+        const auto &child = parser().name();
+
+        if (child == "v")
+        {
+            has_value = true;
+
+            while (parser().next() == xml::parser::event_type::characters)
+            {
+                cell_text_.append(parser().value());
+            }
+        }
+        else if (child == "is")
+        {
+            // concatenate the text of every run, ignoring phonetic runs
+            has_value = true;
+            auto depth = 1;
+            auto phonetic_depth = 0;
+            auto in_text = false;
+
+            while (depth > 0)
+            {
+                switch (parser().next())
+                {
+                case xml::parser::event_type::start_element:
+                    parser().attribute_map();
+                    ++depth;
+
+                    if (parser().name() == "rPh" && phonetic_depth == 0)
+                    {
+                        phonetic_depth = depth;
+                    }
+
+                    in_text = phonetic_depth == 0 && parser().name() == "t";
+                    break;
+
+                case xml::parser::event_type::end_element:
+                    if (depth == phonetic_depth)
+                    {
+                        phonetic_depth = 0;
+                    }
+
+                    --depth;
+                    in_text = false;
+                    break;
+
+                case xml::parser::event_type::characters:
+                    if (in_text)
+                    {
+                        cell_text_.append(parser().value());
+                    }
+                    break;
+
+                default:
+                    break;
+                }
+            }
+        }
+        else
+        {
+            skip_element(parser());
+        }
+    }
+
+    parser().next_expect(xml::parser::event_type::end_element);
+
+    if (!has_value)
+    {
+        view.type = cell_type::empty;
+    }
+
+    switch (view.type)
+    {
+    case cell_type::number:
+        view.number = parse_double(cell_text_);
+
+        if (view.has_format && stylesheet != nullptr)
+        {
+            const auto kind = stylesheet->format_kind(view.format);
+            view.is_date = kind == number_format_kind::date;
+            view.is_timedelta = kind == number_format_kind::timedelta;
+        }
+        break;
+
+    case cell_type::boolean:
+        view.number = is_true(cell_text_) ? 1 : 0;
+        break;
+
+    case cell_type::shared_string:
+        view.shared_string = static_cast<std::size_t>(parse_unsigned(cell_text_));
+        break;
+
+    case cell_type::empty:
+        break;
+
+    default:
+        view.text = cell_text_.data();
+        view.text_length = cell_text_.size();
+        break;
+    }
+}
+
 void xlsx_consumer::read_worksheet(const std::string &rel_id)
 {
     read_worksheet_begin(rel_id);
@@ -511,8 +859,8 @@ std::string xlsx_consumer::read_worksheet_begin(const std::string &rel_id)
 
                 skip_attributes({ "bestFit", "collapsed", "outlineLevel" });
 
-                auto min = static_cast<column_t::index_t>(std::stoull(parser().attribute("min")));
-                auto max = static_cast<column_t::index_t>(std::stoull(parser().attribute("max")));
+                auto min = static_cast<column_t::index_t>(parse_unsigned(parser().attribute("min")));
+                auto max = static_cast<column_t::index_t>(parse_unsigned(parser().attribute("max")));
 
                 optional<double> width;
 
@@ -570,17 +918,17 @@ void xlsx_consumer::read_worksheet_sheetdata()
 {
     auto ws = worksheet(current_worksheet_);
 
-    if (stack_.back() != qn("spreadsheetml", "sheetData"))
+    if (current_element() != qn("spreadsheetml", "sheetData"))
     {
         return;
     }
 
-    number_converter converter;
 
-    while (in_element(qn("spreadsheetml", "sheetData")))
+    // elements are matched by token rather than by qname from here on
+    while (in_element(element_token::sheet_data))
     {
         expect_start_element(qn("spreadsheetml", "row"), xml::content::complex); // CT_Row
-        auto row_index = parser().attribute<row_t>("r");
+        auto row_index = static_cast<row_t>(parse_unsigned(parser().attribute("r")));
 
         if (parser().attribute_present("ht"))
         {
@@ -602,7 +950,7 @@ void xlsx_consumer::read_worksheet_sheetdata()
             "outlineLevel", "collapsed", "thickTop", "thickBot",
             "ph", "spans" });
 
-        while (in_element(qn("spreadsheetml", "row")))
+        while (in_element(element_token::row))
         {
             expect_start_element(qn("spreadsheetml", "c"), xml::content::complex);
             auto cell = ws.cell(cell_reference(parser().attribute("r")));
@@ -612,7 +960,8 @@ void xlsx_consumer::read_worksheet_sheetdata()
 
             if (parser().attribute_present("s"))
             {
-		            cell.format(target_.format(std::stoull(parser().attribute("s"))));
+                // references are counted here and added to the formats in finish_worksheet
+                cell.d_->format_ = cell_format(parse_unsigned(parser().attribute("s")));
             }
 
             auto has_value = false;
@@ -622,16 +971,16 @@ void xlsx_consumer::read_worksheet_sheetdata()
             auto has_shared_formula = false;
             auto formula_value_string = std::string();
 
-            while (in_element(qn("spreadsheetml", "c")))
+            while (in_element(element_token::c))
             {
-                auto current_element = expect_start_element(xml::content::mixed);
+                const auto child = expect_start_token(xml::content::mixed);
 
-                if (current_element == qn("spreadsheetml", "v")) // s:ST_Xstring
+                if (child == element_token::v) // s:ST_Xstring
                 {
                     has_value = true;
                     value_string = read_text();
                 }
-                else if (current_element == qn("spreadsheetml", "f")) // CT_CellFormula
+                else if (child == element_token::f) // CT_CellFormula
                 {
                     has_formula = true;
 
@@ -645,7 +994,7 @@ void xlsx_consumer::read_worksheet_sheetdata()
 
                     formula_value_string = read_text();
                 }
-                else if (current_element == qn("spreadsheetml", "is")) // CT_Rst
+                else if (child == element_token::is) // CT_Rst
                 {
                     expect_start_element(qn("spreadsheetml", "t"), xml::content::simple);
                     value_string = read_text();
@@ -653,34 +1002,38 @@ void xlsx_consumer::read_worksheet_sheetdata()
                 }
                 else
                 {
-                    unexpected_element(current_element);
+                    unexpected_element(current_element());
                 }
 
-                expect_end_element(current_element);
+                expect_end_element();
             }
 
-            expect_end_element(qn("spreadsheetml", "c"));
+            expect_end_element();
 
-            if (has_formula && !has_shared_formula)
+            if (has_formula && !has_shared_formula && !formula_value_string.empty())
             {
-                cell.formula(formula_value_string);
+                // the calculation chain is registered once in finish_worksheet
+                cell.d_->formula(formula_value_string[0] == '='
+                    ? formula_value_string.substr(1) : formula_value_string);
+                cell.data_type(cell::type::number);
+                has_formulae_ = true;
             }
 
             if (has_value)
             {
                 if (type == "str")
                 {
-                    cell.d_->value_text_ = value_string;
+                    cell.d_->text(value_string);
                     cell.data_type(cell::type::formula_string);
                 }
                 else if (type == "inlineStr")
                 {
-                    cell.d_->value_text_ = value_string;
+                    cell.d_->text(value_string);
                     cell.data_type(cell::type::inline_string);
                 }
                 else if (type == "s")
                 {
-                    cell.d_->value_numeric_ = converter.stold(value_string);
+                    cell.d_->value_numeric_ = static_cast<double>(parse_unsigned(value_string));
                     cell.data_type(cell::type::shared_string);
                 }
                 else if (type == "b") // boolean
@@ -689,7 +1042,7 @@ void xlsx_consumer::read_worksheet_sheetdata()
                 }
                 else if (type == "n") // numeric
                 {
-                    cell.value(converter.stold(value_string));
+                    cell.value(parse_double(value_string));
                 }
                 else if (!value_string.empty() && value_string[0] == '#')
                 {
@@ -699,10 +1052,10 @@ void xlsx_consumer::read_worksheet_sheetdata()
 
         }
 
-        expect_end_element(qn("spreadsheetml", "row"));
+        expect_end_element();
     }
 
-    expect_end_element(qn("spreadsheetml", "sheetData"));
+    expect_end_element();
 }
 
 worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
@@ -716,6 +1069,46 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
 
     auto ws = worksheet(current_worksheet_);
 
+    // a cell found by next_planned_cell which wasn't read
+    if (cell_started_)
+    {
+        parser().attribute_map();
+        skip_element(parser());
+        cell_started_ = false;
+    }
+
+    // once a plan has passed its last row, the rest of the part isn't read
+    if (plan_exhausted_)
+    {
+        plan_exhausted_ = false;
+        stack_depth_ = 0;
+
+        if (!defer_workbook_updates_)
+        {
+            finish_worksheet(rel_id);
+        }
+
+        return ws;
+    }
+
+    // skip any cells that weren't read, which also closes an empty sheetData
+    for (const auto &element : { qn("spreadsheetml", "row"), qn("spreadsheetml", "sheetData") })
+    {
+        if (current_element() == element)
+        {
+            parser().attribute_map();
+
+            while (parser().peek() == xml::parser::event_type::start_element)
+            {
+                parser().next();
+                parser().attribute_map();
+                skip_element(parser());
+            }
+
+            expect_end_element(element);
+        }
+    }
+
     while (in_element(qn("spreadsheetml", "worksheet")))
     {
         auto current_worksheet_element = expect_start_element(xml::content::complex);
@@ -756,12 +1149,12 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
         }
         else if (current_worksheet_element == qn("spreadsheetml", "mergeCells")) // CT_MergeCells 0-1
         {
-            auto count = std::stoull(parser().attribute("count"));
+            auto count = parse_unsigned(parser().attribute("count"));
 
             while (in_element(qn("spreadsheetml", "mergeCells")))
             {
                 expect_start_element(qn("spreadsheetml", "mergeCell"), xml::content::simple);
-                ws.merge_cells(range_reference(parser().attribute("ref")));
+                merged_ranges_.push_back(range_reference(parser().attribute("ref")));
                 expect_end_element(qn("spreadsheetml", "mergeCell"));
 
                 count--;
@@ -1015,6 +1408,45 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
 
     expect_end_element(qn("spreadsheetml", "worksheet"));
 
+    if (!defer_workbook_updates_)
+    {
+        finish_worksheet(rel_id);
+    }
+
+    return ws;
+}
+
+void xlsx_consumer::finish_worksheet(const std::string &rel_id)
+{
+    auto &manifest = target_.manifest();
+
+    const auto workbook_rel = manifest.relationship(path("/"), relationship_type::office_document);
+    const auto sheet_rel = manifest.relationship(workbook_rel.target().path(), rel_id);
+    path sheet_path(sheet_rel.source().path().parent().append(sheet_rel.target().path()));
+
+    auto ws = worksheet(current_worksheet_);
+
+    for (std::size_t index = 0; index < format_references_.size(); ++index)
+    {
+        formats_[index]->references += format_references_[index];
+    }
+
+    format_references_.clear();
+
+    if (has_formulae_)
+    {
+        ws.register_calc_chain_in_manifest();
+        has_formulae_ = false;
+    }
+
+    // merging clears the covered cells which can update shared strings and formulae
+    for (const auto &merged_range : merged_ranges_)
+    {
+        ws.merge_cells(merged_range);
+    }
+
+    merged_ranges_.clear();
+
     if (manifest.has_relationship(sheet_path, xlnt::relationship_type::comments))
     {
         auto comments_part = manifest.canonicalize({ workbook_rel, sheet_rel,
@@ -1033,27 +1465,152 @@ worksheet xlsx_consumer::read_worksheet_end(const std::string &rel_id)
             auto vml_drawings_part = manifest.canonicalize({ workbook_rel, sheet_rel,
                 manifest.relationship(sheet_path, xlnt::relationship_type::vml_drawing) });
 
-            auto vml_drawings_part_streambuf = archive_->open(comments_part);
-            std::istream vml_drawings_part_stream(comments_part_streambuf.get());
-            xml::parser vml_parser(vml_drawings_part_stream, vml_drawings_part.string(), receive);
-            parser_ = &vml_parser;
+            auto vml_drawings_part_streambuf = archive_->open(comments_part);
+            std::istream vml_drawings_part_stream(comments_part_streambuf.get());
+            xml::parser vml_parser(vml_drawings_part_stream, vml_drawings_part.string(), receive);
+            parser_ = &vml_parser;
+
+            read_vml_drawings(ws);
+        }
+    }
+}
+
+format_impl *xlsx_consumer::cell_format(std::size_t index)
+{
+    if (formats_.empty())
+    {
+        for (auto &impl : target_.d_->stylesheet_.get().format_impls)
+        {
+            formats_.push_back(&impl);
+        }
+    }
+
+    if (index >= formats_.size())
+    {
+        throw xlnt::exception("cell format index out of range");
+    }
+
+    if (format_references_.size() <= index)
+    {
+        format_references_.resize(formats_.size(), 0);
+    }
+
+    ++format_references_[index];
+
+    return formats_[index];
+}
+
+xml::parser &xlsx_consumer::parser()
+{
+    return *parser_;
+}
+
+bool xlsx_consumer::has_cell()
+{
+    if (planned_)
+    {
+        return next_planned_cell();
+    }
+
+    return in_element(element_token::row)
+        || in_element(element_token::sheet_data);
+}
+
+void xlsx_consumer::plan(const read_plan &plan)
+{
+    planned_ = !plan.reads_everything();
+    first_planned_row_ = plan.first_row;
+    last_planned_row_ = plan.last_row;
+    plan_exhausted_ = false;
+    cell_started_ = false;
+    planned_row_ = 0;
+    planned_column_ = 0;
+    planned_columns_.clear();
+
+    for (const auto &column : plan.columns)
+    {
+        if (column.index >= planned_columns_.size())
+        {
+            planned_columns_.resize(column.index + 1, false);
+        }
+
+        planned_columns_[column.index] = true;
+    }
+}
+
+bool xlsx_consumer::next_planned_cell()
+{
+    static const auto &c = qn("spreadsheetml", "c");
+
+    while (!cell_started_ && !plan_exhausted_ && stack_depth_ > 0)
+    {
+        const auto token = stack_[stack_depth_ - 1].token;
+        const auto at_end = parser().peek() == xml::parser::event_type::end_element;
+
+        if (token == element_token::row)
+        {
+            if (at_end)
+            {
+                expect_end_element();
+                continue;
+            }
+
+            parser().next_expect(xml::parser::event_type::start_element, c);
+            parser().content(xml::content::complex);
+
+            // r is optional, in which case the cell follows the previous one
+            ++planned_column_;
+
+            if (parser().attribute_present("r"))
+            {
+                const auto &r = parser().attribute("r");
+                planned_column_ = cell_reference::from_chars(r.data(), r.data() + r.size()).column_index();
+            }
+
+            if (planned_columns_.empty()
+                || (planned_column_ < planned_columns_.size() && planned_columns_[planned_column_]))
+            {
+                cell_started_ = true;
+            }
+            else
+            {
+                parser().attribute_map();
+                skip_element(parser());
+            }
+        }
+        else if (token == element_token::sheet_data)
+        {
+            if (at_end)
+            {
+                expect_end_element();
+                break;
+            }
+
+            expect_start_element(qn("spreadsheetml", "row"), xml::content::complex);
+            planned_row_ = static_cast<row_t>(parse_unsigned(parser().attribute("r")));
+            planned_column_ = 0;
+
+            if (planned_row_ < first_planned_row_ || planned_row_ > last_planned_row_)
+            {
+                // rows are in ascending order so none of the remaining rows are planned
+                plan_exhausted_ = planned_row_ > last_planned_row_;
 
-            read_vml_drawings(ws);
+                parser().attribute_map();
+                skip_element(parser());
+                --stack_depth_;
+            }
+            else
+            {
+                read_row_properties(planned_row_);
+            }
+        }
+        else
+        {
+            break;
         }
     }
 
-    return ws;
-}
-
-xml::parser &xlsx_consumer::parser()
-{
-    return *parser_;
-}
-
-bool xlsx_consumer::has_cell()
-{
-    return in_element(qn("spreadsheetml", "row"))
-        || in_element(qn("spreadsheetml", "sheetData"));
+    return cell_started_;
 }
 
 std::vector<relationship> xlsx_consumer::read_relationships(const path &part)
@@ -1240,6 +1797,13 @@ void xlsx_consumer::populate_workbook(bool streaming)
 
     target_.clear();
 
+    if (deferred_ != nullptr)
+    {
+        deferred_->archive = archive_;
+        deferred_->options = options_;
+        target_.d_->deferred_parts_ = deferred_;
+    }
+
     read_content_types();
     const auto root_path = path("/");
 
@@ -1269,6 +1833,11 @@ void xlsx_consumer::populate_workbook(bool streaming)
 
     read_part({ manifest().relationship(root_path,
         relationship_type::office_document) });
+
+    if (deferred_ != nullptr && deferred_->empty())
+    {
+        target_.d_->deferred_parts_.reset();
+    }
 }
 
 // Package Parts
@@ -1601,6 +2170,8 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
                 relationship_type::theme)});
     }
 
+    std::vector<std::pair<worksheet_impl *, relationship>> worksheets;
+
     for (auto worksheet_rel : manifest().relationships(workbook_path, relationship_type::worksheet))
     {
         auto title = std::find_if(target_.d_->sheet_title_rel_id_map_.begin(),
@@ -1619,12 +2190,255 @@ void xlsx_consumer::read_office_document(const std::string &content_type) // CT_
         }
 
         current_worksheet_ = &*target_.d_->worksheets_.emplace(insertion_iter, &target_, id, title);
+        worksheets.emplace_back(current_worksheet_, worksheet_rel);
+    }
+
+    if (streaming_) return;
+
+    if (deferred_ != nullptr)
+    {
+        for (const auto &worksheet : worksheets)
+        {
+            deferred_->worksheets.insert(worksheet.first);
+        }
+
+        return;
+    }
+
+    if (options_.worksheet_threads != 1 && worksheets.size() > 1)
+    {
+        for (const auto &error : read_worksheets_parallel(workbook_rel, worksheets))
+        {
+            if (error)
+            {
+                std::rethrow_exception(error);
+            }
+        }
+
+        return;
+    }
+
+    for (const auto &worksheet : worksheets)
+    {
+        current_worksheet_ = worksheet.first;
+        read_part({ workbook_rel, worksheet.second });
+    }
+}
+
+std::vector<std::exception_ptr> xlsx_consumer::read_worksheets_parallel(const relationship &workbook_rel,
+    const std::vector<std::pair<worksheet_impl *, relationship>> &worksheets)
+{
+    // Workers only touch their own worksheet_impl. Everything shared (the
+    // manifest, format reference counts, merged cells, comments) is deferred to
+    // finish_worksheet which runs on this thread once all workers are done.
+    if (formats_.empty() && target_.d_->stylesheet_.is_set())
+    {
+        for (auto &impl : target_.d_->stylesheet_.get().format_impls)
+        {
+            formats_.push_back(&impl);
+        }
+    }
+
+    std::vector<std::unique_ptr<xlsx_consumer>> workers;
+    std::vector<path> part_paths;
+
+    for (const auto &worksheet : worksheets)
+    {
+        workers.emplace_back(new xlsx_consumer(target_));
+        auto &worker = *workers.back();
+
+        worker.archive_ = archive_;
+        worker.formats_ = formats_;
+        worker.current_worksheet_ = worksheet.first;
+        worker.defer_workbook_updates_ = true;
+
+        part_paths.push_back(manifest().canonicalize({ workbook_rel, worksheet.second }));
+    }
+
+    std::atomic<std::size_t> next_worksheet(0);
+    std::vector<std::exception_ptr> errors(worksheets.size());
+
+    auto read_worksheets = [&]() {
+        for (auto index = next_worksheet++; index < worksheets.size(); index = next_worksheet++)
+        {
+            try
+            {
+                auto part_streambuf = archive_->open_detached(part_paths[index]);
+                std::istream part_stream(part_streambuf.get());
+                xml::parser parser(part_stream, part_paths[index].string());
+                workers[index]->parser_ = &parser;
+                workers[index]->read_worksheet(worksheets[index].second.id());
+                workers[index]->parser_ = nullptr;
+            }
+            catch (...)
+            {
+                errors[index] = std::current_exception();
+            }
+        }
+    };
+
+    std::size_t thread_count = options_.worksheet_threads == 0
+        ? std::thread::hardware_concurrency()
+        : options_.worksheet_threads;
+    thread_count = std::max(std::size_t(1), std::min(thread_count, worksheets.size()));
+
+    // this thread reads worksheets too
+    std::vector<std::thread> threads;
+
+    for (std::size_t i = 1; i < thread_count; ++i)
+    {
+        threads.emplace_back(read_worksheets);
+    }
+
+    read_worksheets();
+
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    for (std::size_t index = 0; index < worksheets.size(); ++index)
+    {
+        if (errors[index]) continue;
+
+        try
+        {
+            workers[index]->finish_worksheet(worksheets[index].second.id());
+        }
+        catch (...)
+        {
+            errors[index] = std::current_exception();
+        }
+    }
+
+    return errors;
+}
+
+void xlsx_consumer::read_deferred_worksheet(worksheet_impl *ws)
+{
+    // keeps the archive alive even if the last part is read
+    auto parts = target_.d_->deferred_parts_;
+    if (parts == nullptr) return;
+
+    // a worksheet that couldn't be read keeps failing rather than exposing what was read of it
+    const auto failed = parts->failed_worksheets.find(ws);
+
+    if (failed != parts->failed_worksheets.end())
+    {
+        std::rethrow_exception(failed->second);
+    }
+
+    // forgotten before reading so that the worksheet is never read twice
+    // even if it is reached again through the workbook while being read
+    if (parts->worksheets.erase(ws) == 0) return;
+
+    archive_ = parts->archive;
+    options_ = parts->options;
+    current_worksheet_ = ws;
+
+    try
+    {
+        const auto workbook_rel = manifest().relationship(path("/"), relationship_type::office_document);
+        const auto &rel_id = target_.d_->sheet_title_rel_id_map_.at(ws->title_);
+        read_part({ workbook_rel, manifest().relationship(workbook_rel.target().path(), rel_id) });
+    }
+    catch (...)
+    {
+        parts->failed_worksheets[ws] = std::current_exception();
+        throw;
+    }
+
+    if (parts->empty() && target_.d_->deferred_parts_ == parts)
+    {
+        target_.d_->deferred_parts_.reset();
+    }
+}
+
+void xlsx_consumer::read_deferred_images()
+{
+    auto parts = target_.d_->deferred_parts_;
+    if (parts == nullptr) return;
+
+    auto images = std::move(parts->images);
+    parts->images.clear();
+
+    if (parts->empty())
+    {
+        target_.d_->deferred_parts_.reset();
+    }
+
+    archive_ = parts->archive;
+
+    for (const auto &image_path : images)
+    {
+        read_image(image_path);
+    }
+}
+
+void xlsx_consumer::read_deferred_parts()
+{
+    auto parts = target_.d_->deferred_parts_;
+    if (parts == nullptr) return;
+
+    read_deferred_images();
+
+    // the remaining worksheets are read in workbook order, as load would have
+    std::vector<worksheet_impl *> remaining;
+
+    for (auto &impl : target_.d_->worksheets_)
+    {
+        if (parts->failed_worksheets.count(&impl) != 0 || parts->worksheets.count(&impl) != 0)
+        {
+            remaining.push_back(&impl);
+        }
+    }
+
+    if (parts->options.worksheet_threads == 1 || remaining.size() < 2 || !parts->failed_worksheets.empty())
+    {
+        // rethrows the error of a worksheet which already failed
+        for (auto impl : remaining)
+        {
+            read_deferred_worksheet(impl);
+        }
+
+        return;
+    }
+
+    const auto workbook_rel = manifest().relationship(path("/"), relationship_type::office_document);
+    std::vector<std::pair<worksheet_impl *, relationship>> worksheets;
+
+    for (auto impl : remaining)
+    {
+        const auto &rel_id = target_.d_->sheet_title_rel_id_map_.at(impl->title_);
+        worksheets.emplace_back(impl, manifest().relationship(workbook_rel.target().path(), rel_id));
+        parts->worksheets.erase(impl);
+    }
+
+    archive_ = parts->archive;
+    options_ = parts->options;
+
+    const auto errors = read_worksheets_parallel(workbook_rel, worksheets);
+
+    for (std::size_t index = 0; index < worksheets.size(); ++index)
+    {
+        if (errors[index])
+        {
+            parts->failed_worksheets[worksheets[index].first] = errors[index];
+        }
+    }
 
-        if (!streaming_)
+    for (const auto &error : errors)
+    {
+        if (error)
         {
-            read_part({ workbook_rel, worksheet_rel });
+            std::rethrow_exception(error);
         }
     }
+
+    if (parts->empty())
+    {
+        target_.d_->deferred_parts_.reset();
+    }
 }
 
 // Write Workbook Relationship Target Parts
@@ -1677,16 +2491,36 @@ void xlsx_consumer::read_shared_string_table()
 
     auto &strings = target_.shared_strings();
 
+    // a streamed workbook keeps the table compact and decodes runs on demand
+    if (streaming_)
+    {
+        target_.d_->shared_string_arena_ = std::make_shared<shared_string_arena>(
+            options_.shared_string_memory_limit);
+    }
+
+    const auto arena = target_.d_->shared_string_arena_.get();
+
     while (in_element(qn("spreadsheetml", "sst")))
     {
         expect_start_element(qn("spreadsheetml", "si"), xml::content::complex);
-        strings.push_back(read_rich_text(qn("spreadsheetml", "si")));
+
+        if (arena != nullptr)
+        {
+            read_shared_string_markup(*arena);
+        }
+        else
+        {
+            strings.push_back(read_rich_text(qn("spreadsheetml", "si")));
+        }
+
         expect_end_element(qn("spreadsheetml", "si"));
     }
 
     expect_end_element(qn("spreadsheetml", "sst"));
 
-    if (has_unique_count && unique_count != strings.size())
+    const auto count = arena != nullptr ? arena->size() : strings.size();
+
+    if (has_unique_count && unique_count != count)
     {
         throw invalid_file("sizes don't match");
     }
@@ -1727,8 +2561,7 @@ void xlsx_consumer::read_stylesheet()
 
             while (in_element(qn("spreadsheetml", "borders")))
             {
-                borders.push_back(xlnt::border());
-                auto &border = borders.back();
+                xlnt::border border;
 
                 expect_start_element(qn("spreadsheetml", "border"), xml::content::complex);
 
@@ -1774,6 +2607,7 @@ void xlsx_consumer::read_stylesheet()
                 }
 
                 expect_end_element(qn("spreadsheetml", "border"));
+                borders.push_back(border);
             }
 
             if (count != borders.size())
@@ -1788,8 +2622,7 @@ void xlsx_consumer::read_stylesheet()
 
             while (in_element(qn("spreadsheetml", "fills")))
             {
-                fills.push_back(xlnt::fill());
-                auto &new_fill = fills.back();
+                xlnt::fill new_fill;
 
                 expect_start_element(qn("spreadsheetml", "fill"), xml::content::complex);
                 auto fill_element = expect_start_element(xml::content::complex);
@@ -1859,6 +2692,7 @@ void xlsx_consumer::read_stylesheet()
 
                 expect_end_element(fill_element);
                 expect_end_element(qn("spreadsheetml", "fill"));
+                fills.push_back(new_fill);
             }
 
             if (count != fills.size())
@@ -1874,8 +2708,7 @@ void xlsx_consumer::read_stylesheet()
 
             while (in_element(qn("spreadsheetml", "fonts")))
             {
-                fonts.push_back(xlnt::font());
-                auto &new_font = stylesheet.fonts.back();
+                xlnt::font new_font;
 
                 expect_start_element(qn("spreadsheetml", "font"), xml::content::complex);
 
@@ -1989,6 +2822,7 @@ void xlsx_consumer::read_stylesheet()
                 }
 
                 expect_end_element(qn("spreadsheetml", "font"));
+                fonts.push_back(new_font);
             }
 
             if (count != stylesheet.fonts.size())
@@ -2121,8 +2955,7 @@ void xlsx_consumer::read_stylesheet()
 
                     if (xf_child_element == qn("spreadsheetml", "alignment"))
                     {
-                        record.first.alignment_id = stylesheet.alignments.size();
-                        auto &alignment = *stylesheet.alignments.emplace(stylesheet.alignments.end());
+                        xlnt::alignment alignment;
 
                         if (parser().attribute_present("wrapText"))
                         {
@@ -2158,16 +2991,21 @@ void xlsx_consumer::read_stylesheet()
                         {
                             parser().attribute<int>("readingOrder");
                         }
+
+                        record.first.alignment_id = stylesheet.alignments.size();
+                        stylesheet.alignments.push_back(alignment);
                     }
                     else if (xf_child_element == qn("spreadsheetml", "protection"))
                     {
-                        record.first.protection_id = stylesheet.protections.size();
-                        auto &protection = *stylesheet.protections.emplace(stylesheet.protections.end());
+                        xlnt::protection protection;
 
                         protection.locked(parser().attribute_present("locked")
                             && is_true(parser().attribute("locked")));
                         protection.hidden(parser().attribute_present("hidden")
                             && is_true(parser().attribute("hidden")));
+
+                        record.first.protection_id = stylesheet.protections.size();
+                        stylesheet.protections.push_back(protection);
                     }
                     else
                     {
@@ -2328,6 +3166,8 @@ void xlsx_consumer::read_stylesheet()
 
         new_format.style = styles.at(record.second).first.name;
     }
+
+    stylesheet.classify_formats();
 }
 
 void xlsx_consumer::read_theme()
@@ -2421,6 +3261,12 @@ void xlsx_consumer::read_unknown_relationships()
 
 void xlsx_consumer::read_image(const xlnt::path &image_path)
 {
+    if (deferred_ != nullptr)
+    {
+        deferred_->images.push_back(image_path);
+        return;
+    }
+
     auto image_streambuf = archive_->open(image_path);
     vector_ostreambuf buffer(target_.d_->images_[image_path.string()]);
     std::ostream out_stream(&buffer);
@@ -2444,7 +3290,7 @@ variant xlsx_consumer::read_variant()
 {
     auto value = variant(read_text());
 
-    if (in_element(stack_.back()))
+    if (in_element(current_element()))
     {
         auto element = expect_start_element(xml::content::mixed);
         auto text = read_text();
@@ -2557,28 +3403,41 @@ void xlsx_consumer::skip_remaining_content(const xml::qname &name)
 bool xlsx_consumer::in_element(const xml::qname &name)
 {
     return parser().peek() != xml::parser::event_type::end_element
-        && stack_.back() == name;
+        && current_element() == name;
+}
+
+bool xlsx_consumer::in_element(element_token token)
+{
+    return parser().peek() != xml::parser::event_type::end_element
+        && stack_[stack_depth_ - 1].token == token;
 }
 
 xml::qname xlsx_consumer::expect_start_element(xml::content content)
+{
+    expect_start_token(content);
+
+    return current_element();
+}
+
+xlsx_consumer::element_token xlsx_consumer::expect_start_token(xml::content content)
 {
     parser().next_expect(xml::parser::event_type::start_element);
     parser().content(content);
-    stack_.push_back(parser().qname());
+    push_element(parser().qname());
 
-    const auto xml_space = qn("xml", "space");
+    const auto &xml_space = qn("xml", "space");
     preserve_space_ = parser().attribute_present(xml_space) ? parser().attribute(xml_space) == "preserve" : false;
 
-    return stack_.back();
+    return stack_[stack_depth_ - 1].token;
 }
 
 void xlsx_consumer::expect_start_element(const xml::qname &name, xml::content content)
 {
     parser().next_expect(xml::parser::event_type::start_element, name);
     parser().content(content);
-    stack_.push_back(name);
+    push_element(name);
 
-    const auto xml_space = qn("xml", "space");
+    const auto &xml_space = qn("xml", "space");
     preserve_space_ = parser().attribute_present(xml_space) ? parser().attribute(xml_space) == "preserve" : false;
 }
 
@@ -2586,7 +3445,90 @@ void xlsx_consumer::expect_end_element(const xml::qname &name)
 {
     parser().attribute_map();
     parser().next_expect(xml::parser::event_type::end_element, name);
-    stack_.pop_back();
+    --stack_depth_;
+}
+
+void xlsx_consumer::expect_end_element()
+{
+    // the parser has already checked that the end tag matches its start tag
+    parser().attribute_map();
+    parser().next_expect(xml::parser::event_type::end_element);
+    --stack_depth_;
+}
+
+void xlsx_consumer::push_element(const xml::qname &name)
+{
+    if (stack_depth_ == stack_.size())
+    {
+        stack_.push_back({name, tokenize(name)});
+    }
+    else
+    {
+        auto &entry = stack_[stack_depth_];
+        entry.name = name;
+        entry.token = tokenize(name);
+    }
+
+    ++stack_depth_;
+}
+
+const xml::qname &xlsx_consumer::current_element() const
+{
+    return stack_[stack_depth_ - 1].name;
+}
+
+xlsx_consumer::element_token xlsx_consumer::tokenize(const xml::qname &name)
+{
+    static const auto &spreadsheetml = constants::ns("spreadsheetml");
+
+    const auto &local = name.name();
+    auto token = element_token::other;
+
+    switch (local.size())
+    {
+    case 1:
+        switch (local[0])
+        {
+        case 'c':
+            token = element_token::c;
+            break;
+        case 'v':
+            token = element_token::v;
+            break;
+        case 'f':
+            token = element_token::f;
+            break;
+        case 't':
+            token = element_token::t;
+            break;
+        default:
+            break;
+        }
+        break;
+
+    case 2:
+        token = local == "is" ? element_token::is : element_token::other;
+        break;
+
+    case 3:
+        token = local == "row" ? element_token::row : element_token::other;
+        break;
+
+    case 9:
+        token = local == "sheetData" ? element_token::sheet_data : element_token::other;
+        break;
+
+    default:
+        break;
+    }
+
+    // only names that could be tokens pay for the namespace comparison
+    if (token == element_token::other || name.namespace_() != spreadsheetml)
+    {
+        return element_token::other;
+    }
+
+    return token;
 }
 
 rich_text xlsx_consumer::read_rich_text(const xml::qname &parent)
@@ -2711,6 +3653,106 @@ rich_text xlsx_consumer::read_rich_text(const xml::qname &parent)
     return t;
 }
 
+void xlsx_consumer::read_shared_string_markup(shared_string_arena &strings)
+{
+    static const auto &xmlns = constants::ns("spreadsheetml");
+    static const auto &xmlns_xml = constants::ns("xml");
+
+    auto markup = std::string("<si xmlns=\"") + xmlns + "\">";
+    auto text = std::string();
+    auto elements = std::size_t(0);
+    auto plain = true;
+
+    // the namespace of each open element so that a change can be declared
+    auto namespaces = std::vector<std::string>{xmlns};
+
+    while (parser().peek() != xml::parser::event_type::end_element || namespaces.size() > 1)
+    {
+        switch (parser().next())
+        {
+        case xml::parser::event_type::start_element:
+        {
+            parser().content(xml::content::mixed);
+            const auto &name = parser().qname();
+
+            // only <si><t>text</t></si> can be stored as text
+            plain = plain && ++elements == 1 && namespaces.size() == 1 && name == qn("spreadsheetml", "t");
+
+            markup.push_back('<');
+            markup.append(name.name());
+
+            if (name.namespace_() != namespaces.back())
+            {
+                markup.append(" xmlns=\"");
+                append_escaped(markup, name.namespace_());
+                markup.push_back('"');
+            }
+
+            namespaces.push_back(name.namespace_());
+
+            for (const auto &attribute : parser().attribute_map())
+            {
+                const auto &attribute_name = attribute.first;
+
+                if (!attribute_name.namespace_().empty() && attribute_name.namespace_() != xmlns_xml) continue;
+
+                markup.push_back(' ');
+                markup.append(attribute_name.namespace_().empty() ? "" : "xml:");
+                markup.append(attribute_name.name());
+                markup.append("=\"");
+                append_escaped(markup, attribute.second.value);
+                markup.push_back('"');
+            }
+
+            markup.push_back('>');
+            break;
+        }
+
+        case xml::parser::event_type::end_element:
+            markup.append("</");
+            markup.append(parser().qname().name());
+            markup.push_back('>');
+            namespaces.pop_back();
+            break;
+
+        case xml::parser::event_type::characters:
+            text.append(parser().value());
+            append_escaped(markup, parser().value());
+            break;
+
+        default:
+            break;
+        }
+    }
+
+    if (plain && elements == 1)
+    {
+        strings.append_text(text);
+    }
+    else
+    {
+        markup.append("</si>");
+        strings.append_markup(markup);
+    }
+}
+
+rich_text xlsx_consumer::decode_rich_text(const std::string &markup)
+{
+    std::istringstream stream(markup);
+    xml::parser parser(stream, "sharedStrings.xml");
+
+    // the decoder only uses its parser so it isn't given a workbook
+    workbook unused(nullptr);
+    xlsx_consumer decoder(unused);
+    decoder.parser_ = &parser;
+
+    decoder.expect_start_element(qn("spreadsheetml", "si"), xml::content::complex);
+    auto text = decoder.read_rich_text(qn("spreadsheetml", "si"));
+    decoder.expect_end_element(qn("spreadsheetml", "si"));
+
+    return text;
+}
+
 xlnt::color xlsx_consumer::read_color()
 {
     xlnt::color result;
@@ -25,25 +25,32 @@
 #pragma once
 
 #include <cstdint>
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <detail/external/include_libstudxml.hpp>
 #include <detail/serialization/zstream.hpp>
+#include <xlnt/cell/index_types.hpp>
+#include <xlnt/worksheet/range_reference.hpp>
+#include <xlnt/workbook/load_options.hpp>
 
 namespace xlnt {
 
 class cell;
+struct cell_view;
 class color;
 class rich_text;
 class manifest;
 template<typename T>
 class optional;
 class path;
+class read_plan;
 class relationship;
 class streaming_workbook_reader;
 class variant;
@@ -54,6 +61,10 @@ namespace detail {
 
 class izstream;
 struct cell_impl;
+struct deferred_parts;
+struct format_impl;
+class shared_string_arena;
+struct stylesheet;
 struct worksheet_impl;
 
 /// <summary>
@@ -68,15 +79,67 @@ public:
 
 	void read(std::istream &source);
 
+	void read(std::istream &source, const load_options &options);
+
+	/// <summary>
+	/// Maps the file at source into memory and reads the workbook from the mapping.
+	/// </summary>
+	void read(const path &source, const load_options &options);
+
 	void read(std::istream &source, const std::string &password);
 
+    /// <summary>
+    /// Parses markup captured from a shared string table by read_shared_string_markup
+    /// and returns its runs.
+    /// </summary>
+    static rich_text decode_rich_text(const std::string &markup);
+
+    /// <summary>
+    /// Reads the part of the worksheet ws if load_options::lazy_parts left it
+    /// unread. Does nothing otherwise.
+    /// </summary>
+    void read_deferred_worksheet(worksheet_impl *ws);
+
+    /// <summary>
+    /// Reads the images that load_options::lazy_parts left unread.
+    /// </summary>
+    void read_deferred_images();
+
+    /// <summary>
+    /// Reads every part that load_options::lazy_parts left unread.
+    /// </summary>
+    void read_deferred_parts();
+
 private:
     friend class xlnt::streaming_workbook_reader;
 
     void open(std::istream &source);
 
+    void open(std::istream &source, const load_options &options);
+
+    void open(const path &source, const load_options &options);
+
     bool has_cell();
 
+    /// <summary>
+    /// Restricts the cells read from the next worksheet to those in plan.
+    /// </summary>
+    void plan(const read_plan &plan);
+
+    /// <summary>
+    /// Skips the rows and cells outside the read plan until the start tag of a
+    /// cell in it has been consumed, which sets cell_started_. Returns false
+    /// if no cell of the plan remains in the current worksheet.
+    /// </summary>
+    bool next_planned_cell();
+
+    /// <summary>
+    /// Reads the cell whose start tag was just consumed into view, including
+    /// its end tag. view.row and view.column are overridden by its reference
+    /// if it has one.
+    /// </summary>
+    void read_cell_view(cell_view &view, stylesheet *stylesheet);
+
     /// <summary>
     /// Reads the next cell in the current worksheet and optionally returns it if
     /// the last cell in the sheet has not yet been read. An exception will be thrown
@@ -84,6 +147,24 @@ private:
     /// </summary>
     cell read_cell();
 
+    /// <summary>
+    /// Reads the remaining cells of the current worksheet without creating any
+    /// xlnt::cell, calling visitor with a view of each one in document order.
+    /// </summary>
+    void read_cells(const std::function<void(const cell_view &)> &visitor);
+
+    /// <summary>
+    /// Starts the next row element of sheetData, reads its properties into
+    /// the current worksheet and returns its index.
+    /// </summary>
+    row_t read_row_begin();
+
+    /// <summary>
+    /// Reads the properties of the row whose start tag was just consumed into
+    /// the current worksheet.
+    /// </summary>
+    void read_row_properties(row_t row_index);
+
 	/// <summary>
 	/// Read all the files needed from the XLSX archive and initialize all of
 	/// the data in the workbook to match.
@@ -202,6 +283,15 @@ private:
 	/// </summary>
 	void read_worksheet(const std::string &rel_id);
 
+    /// <summary>
+    /// Reads each of the given worksheets on its own thread using a separate
+    /// consumer and a detached archive stream, then applies the workbook-level
+    /// updates of each one in order on the calling thread. Returns the error
+    /// raised while reading each worksheet, or null for those that were read.
+    /// </summary>
+    std::vector<std::exception_ptr> read_worksheets_parallel(const relationship &workbook_rel,
+        const std::vector<std::pair<worksheet_impl *, relationship>> &worksheets);
+
     /// <summary>
     /// xl/sheets/*.xml
     /// </summary>
@@ -217,6 +307,17 @@ private:
     /// </summary>
     worksheet read_worksheet_end(const std::string &rel_id);
 
+    /// <summary>
+    /// Applies the changes to shared workbook state that reading the worksheet
+    /// part implies: format reference counts, the calculation chain and comments.
+    /// </summary>
+    void finish_worksheet(const std::string &rel_id);
+
+    /// <summary>
+    /// Returns the cell format with the given index from formats_.
+    /// </summary>
+    format_impl *cell_format(std::size_t index);
+
 	// Sheet Relationship Target Parts
 
 	/// <summary>
@@ -269,6 +370,13 @@ private:
     /// </summary>
     rich_text read_rich_text(const xml::qname &parent);
 
+    /// <summary>
+    /// Reads the content of the current CT_Rst element into strings without
+    /// decoding its runs. Strings with a single unformatted run are appended as
+    /// text and any others as markup that decode_rich_text can parse later.
+    /// </summary>
+    void read_shared_string_markup(shared_string_arena &strings);
+
     /// <summary>
     /// Returns true if the givent document type represents an XLSX file.
     /// </summary>
@@ -357,6 +465,56 @@ private:
     /// </summary>
     bool in_element(const xml::qname &name);
 
+    /// <summary>
+    /// Identifies the spreadsheetml elements that make up sheetData so that
+    /// the cell loops compare integers instead of qualified names.
+    /// </summary>
+    enum class element_token
+    {
+        other,
+        sheet_data,
+        row,
+        c,
+        v,
+        f,
+        is,
+        t
+    };
+
+    /// <summary>
+    /// Returns the token of the element called name.
+    /// </summary>
+    static element_token tokenize(const xml::qname &name);
+
+    /// <summary>
+    /// Handles the next event in the XML parser like expect_start_element(content)
+    /// but returns the token of the element rather than a copy of its name.
+    /// </summary>
+    element_token expect_start_token(xml::content content);
+
+    /// <summary>
+    /// Returns true if the top of the parsing stack has the given token and
+    /// the end of that element hasn't been reached in the XML document.
+    /// </summary>
+    bool in_element(element_token token);
+
+    /// <summary>
+    /// Throws an exception if the next event in the XML parser is not the end
+    /// of the element on top of the parsing stack.
+    /// </summary>
+    void expect_end_element();
+
+    /// <summary>
+    /// Pushes name onto the parsing stack, reusing the storage of a previously
+    /// popped entry where there is one.
+    /// </summary>
+    void push_element(const xml::qname &name);
+
+    /// <summary>
+    /// Returns the name of the element on top of the parsing stack.
+    /// </summary>
+    const xml::qname &current_element() const;
+
     // Properties
 
 	/// <summary>
@@ -373,7 +531,7 @@ private:
 	/// <summary>
 	/// The ZIP file containing the files that make up the OOXML package.
 	/// </summary>
-	std::unique_ptr<izstream> archive_;
+	std::shared_ptr<izstream> archive_;
 
 	/// <summary>
 	/// Map of sheet titles to relationship IDs.
@@ -398,17 +556,111 @@ private:
 	/// </summary>
 	xml::parser *parser_;
 
-    std::vector<xml::qname> stack_;
+    /// <summary>
+    /// An element of the parsing stack along with its token.
+    /// </summary>
+    struct stack_entry
+    {
+        xml::qname name;
+        element_token token;
+    };
+
+    /// <summary>
+    /// The elements from the document root to the current element. Entries
+    /// past stack_depth_ are kept when popped so that their strings can be
+    /// reused by the next push. A deque keeps references to entries valid
+    /// while deeper elements are pushed.
+    /// </summary>
+    std::deque<stack_entry> stack_;
+
+    std::size_t stack_depth_ = 0;
 
     bool preserve_space_ = false;
 
     bool streaming_ = false;
 
+    /// <summary>
+    /// The parts to be left unread by populate_workbook when loading with
+    /// load_options::lazy_parts, otherwise null.
+    /// </summary>
+    std::shared_ptr<deferred_parts> deferred_;
+
     std::unique_ptr<detail::cell_impl> streaming_cell_;
 
+    /// <summary>
+    /// Holds the text of the cell passed to the read_cells visitor so that its
+    /// capacity is reused from one cell to the next.
+    /// </summary>
+    std::string cell_text_;
+
+    /// <summary>
+    /// True while a read_plan other than the default one applies to the
+    /// current worksheet, in which case cells are found by next_planned_cell.
+    /// </summary>
+    bool planned_ = false;
+
+    /// <summary>
+    /// True for each column index in the plan. Empty if every column is read.
+    /// </summary>
+    std::vector<bool> planned_columns_;
+
+    row_t first_planned_row_ = 0;
+
+    row_t last_planned_row_ = 0;
+
+    /// <summary>
+    /// Set once a row after the plan has been reached.
+    /// </summary>
+    bool plan_exhausted_ = false;
+
+    /// <summary>
+    /// Set by next_planned_cell when it has consumed the start tag of the next
+    /// cell to be read.
+    /// </summary>
+    bool cell_started_ = false;
+
+    /// <summary>
+    /// The position of the cell most recently found by next_planned_cell.
+    /// </summary>
+    row_t planned_row_ = 0;
+
+    column_t::index_t planned_column_ = 0;
+
     detail::cell_impl *current_cell_;
 
     detail::worksheet_impl *current_worksheet_;
+
+    /// <summary>
+    /// Options passed to read.
+    /// </summary>
+    load_options options_;
+
+    /// <summary>
+    /// The stylesheet's cell formats by index, built on first use so that
+    /// sheetData lookups don't walk the stylesheet's list.
+    /// </summary>
+    std::vector<format_impl *> formats_;
+
+    /// <summary>
+    /// The number of cells read from the current worksheet that use each entry of formats_.
+    /// </summary>
+    std::vector<std::size_t> format_references_;
+
+    /// <summary>
+    /// True if a cell with a formula was read from the current worksheet.
+    /// </summary>
+    bool has_formulae_ = false;
+
+    /// <summary>
+    /// The merged cell ranges read from the current worksheet, merged in finish_worksheet.
+    /// </summary>
+    std::vector<range_reference> merged_ranges_;
+
+    /// <summary>
+    /// When true, read_worksheet_end leaves finish_worksheet to the caller.
+    /// Set on the consumers used by read_worksheets_parallel.
+    /// </summary>
+    bool defer_workbook_updates_ = false;
 };
 
 } // namespace detail
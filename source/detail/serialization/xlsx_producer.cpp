@@ -21,6 +21,7 @@
 // @license: http://www.opensource.org/licenses/mit-license.php
 // @author: see AUTHORS file
 
+#include <algorithm>
 #include <cmath>
 #include <numeric> // for std::accumulate
 #include <string>
@@ -30,11 +31,16 @@
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/header_footer/header_footer_code.hpp>
 #include <detail/serialization/custom_value_traits.hpp>
+#include <detail/serialization/sheet_data_writer.hpp>
+#include <detail/serialization/shortest_double.hpp>
+#include <detail/serialization/spill_file.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_producer.hpp>
 #include <detail/serialization/zstream.hpp>
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/packaging/manifest.hpp>
+#include <xlnt/styles/format.hpp>
+#include <xlnt/utils/exceptions.hpp>
 #include <xlnt/utils/path.hpp>
 #include <xlnt/utils/scoped_enum_hash.hpp>
 #include <xlnt/workbook/workbook.hpp>
@@ -98,28 +104,310 @@ xlsx_producer::~xlsx_producer()
 
 void xlsx_producer::write(std::ostream &destination)
 {
-    archive_.reset(new ozstream(destination));
+    archive_.reset(new ozstream(destination, options_));
     populate_archive(false);
+
+    // errors compressing parts are only reported by flush, not by the destructor
+    archive_->flush();
+    archive_.reset();
+}
+
+void xlsx_producer::write(std::ostream &destination, const save_options &options)
+{
+    options_ = options;
+    write(destination);
 }
 
 void xlsx_producer::open(std::ostream &destination)
 {
-    archive_.reset(new ozstream(destination));
+    // entries compressed on a pool are held in memory until they are closed,
+    // which would defeat streaming a worksheet
+    options_.compression_threads = 1;
+
+    archive_.reset(new ozstream(destination, options_));
+    streaming_ = true;
+
+    // cells refer to formats by id as they are written so formats must keep
+    // their ids even if nothing else refers to them
+    auto &stylesheet = const_cast<workbook &>(source_).impl().stylesheet_;
+
+    if (stylesheet.is_set())
+    {
+        stylesheet.get().garbage_collection_enabled = false;
+    }
+
+    streaming_cell_.reset(new cell_impl());
+    current_cell_ = streaming_cell_.get();
+}
+
+void xlsx_producer::open(std::ostream &destination, const save_options &options)
+{
+    options_ = options;
+    open(destination);
+}
+
+void xlsx_producer::close()
+{
+    // the part being written when a cell failed is incomplete so the package
+    // isn't finished and whatever was written is left as it is
+    if (failed_)
+    {
+        end_part();
+        archive_.reset();
+        throw_if_failed();
+    }
+
+    // a package needs at least one worksheet
+    if (streamed_worksheets_ == 0)
+    {
+        add_worksheet(source_.sheet_by_index(0).title());
+    }
+
+    end_streamed_worksheet();
     populate_archive(true);
+    archive_->flush();
+    archive_.reset();
 }
 
 cell xlsx_producer::add_cell(const cell_reference &ref)
 {
+    write_pending_cell();
+    throw_if_failed();
+
+    if (current_worksheet_ == nullptr)
+    {
+        add_worksheet(source_.sheet_by_index(0).title());
+    }
+
+    if (ref.row() < last_row_ || (ref.row() == last_row_ && ref.column_index() <= last_column_))
+    {
+        throw invalid_parameter();
+    }
+
+    if (!streamed_sheet_data_)
+    {
+        begin_streamed_worksheet();
+    }
+
+    last_row_ = ref.row();
+    last_column_ = ref.column_index();
+
     current_cell_->column_ = ref.column();
     current_cell_->row_ = ref.row();
+    cell_pending_ = true;
 
     return cell(current_cell_);
 }
 
+void xlsx_producer::add_number_cell(const cell_reference &ref, std::size_t format_id, double value)
+{
+    add_cell(ref).value(value);
+    apply_format(format_id);
+    write_pending_cell();
+}
+
+void xlsx_producer::add_boolean_cell(const cell_reference &ref, std::size_t format_id, bool value)
+{
+    add_cell(ref).value(value);
+    apply_format(format_id);
+    write_pending_cell();
+}
+
+void xlsx_producer::add_string_cell(const cell_reference &ref, std::size_t format_id, const std::string &text)
+{
+    add_cell(ref);
+    apply_format(format_id);
+    current_cell_->type(cell_type::shared_string);
+    current_cell_->value_numeric_ = static_cast<double>(add_streamed_string(text));
+    write_pending_cell();
+}
+
+void xlsx_producer::add_formula_cell(const cell_reference &ref, std::size_t format_id, const std::string &formula)
+{
+    add_cell(ref).formula(formula);
+    apply_format(format_id);
+    write_pending_cell();
+}
+
 worksheet xlsx_producer::add_worksheet(const std::string &title)
 {
-    current_worksheet_->title_ = title;
-    return worksheet(current_worksheet_);
+    throw_if_failed();
+    end_streamed_worksheet();
+
+    // the streaming writer owns the workbook, which starts with one worksheet
+    auto &wb = const_cast<workbook &>(source_);
+    auto ws = streamed_worksheets_++ == 0 ? wb.sheet_by_index(0) : wb.create_sheet();
+
+    if (ws.title() != title)
+    {
+        ws.title(title);
+    }
+
+    current_worksheet_ = ws.d_;
+    current_cell_->parent_ = current_worksheet_;
+    last_row_ = 0;
+    last_column_ = 0;
+
+    return ws;
+}
+
+std::size_t xlsx_producer::format_id(const format &format) const
+{
+    if (!source_.d_->stylesheet_.is_set() || format.d_->parent != &source_.d_->stylesheet_.get())
+    {
+        throw invalid_parameter();
+    }
+
+    return format.d_->id;
+}
+
+path xlsx_producer::streamed_worksheet_part() const
+{
+    const auto workbook_part = source_.manifest().relationship(path("/"), relationship_type::office_document).target().path();
+    const auto sheet_rel = source_.manifest().relationship(workbook_part,
+        source_.d_->sheet_title_rel_id_map_.at(current_worksheet_->title_));
+
+    return sheet_rel.source().path().parent().append(sheet_rel.target().path());
+}
+
+void xlsx_producer::begin_streamed_worksheet()
+{
+    const auto worksheet_part = streamed_worksheet_part();
+
+    begin_part(worksheet_part);
+    write_worksheet_start(worksheet(current_worksheet_));
+    streamed_sheet_data_.reset(new sheet_data_writer(current_part_stream_, worksheet_part.string()));
+}
+
+void xlsx_producer::end_streamed_worksheet()
+{
+    if (current_worksheet_ == nullptr) return;
+
+    write_pending_cell();
+
+    // a worksheet without cells still needs a part
+    if (!streamed_sheet_data_)
+    {
+        begin_streamed_worksheet();
+    }
+
+    if (open_row_ != 0)
+    {
+        streamed_sheet_data_->write_markup("</row>");
+        open_row_ = 0;
+    }
+
+    streamed_sheet_data_->flush();
+    streamed_sheet_data_.reset();
+
+    write_worksheet_end(worksheet(current_worksheet_), streamed_worksheet_part(), {}, {});
+    end_part();
+
+    current_worksheet_ = nullptr;
+}
+
+void xlsx_producer::apply_format(std::size_t format_id)
+{
+    // formats are never collected while streaming so no reference is counted
+    current_cell_->format_ = format_id == 0 ? nullptr : source_.format(format_id).d_;
+}
+
+void xlsx_producer::write_pending_cell()
+{
+    if (!cell_pending_) return;
+
+    // cleared first so that a cell which fails to be written isn't retried
+    cell_pending_ = false;
+
+    try
+    {
+        write_streamed_cell();
+    }
+    catch (...)
+    {
+        failed_ = true;
+        throw;
+    }
+}
+
+void xlsx_producer::throw_if_failed() const
+{
+    if (failed_)
+    {
+        throw xlnt::exception("streamed workbook is incomplete after an earlier error");
+    }
+}
+
+void xlsx_producer::write_streamed_cell()
+{
+    // strings set through the cell API are added to the in-memory table, which
+    // is moved to disk after every cell so that it never grows
+    auto &strings = source_.d_->shared_strings_;
+
+    if (!strings.empty())
+    {
+        if (current_cell_->type_ == cell_type::shared_string)
+        {
+            const auto &text = strings.at(static_cast<std::size_t>(current_cell_->value_numeric_));
+            current_cell_->value_numeric_ = static_cast<double>(add_streamed_string(text.plain_text()));
+        }
+
+        strings.clear();
+        source_.d_->shared_strings_ids_.clear();
+        source_.d_->shared_strings_indexed_ = 0;
+    }
+
+    auto &sheet_data = *streamed_sheet_data_;
+
+    if (current_cell_->row_ != open_row_)
+    {
+        if (open_row_ != 0)
+        {
+            sheet_data.write_markup("</row>");
+        }
+
+        sheet_data.write_markup("<row r=\"");
+        sheet_data.write_number(std::uint64_t(current_cell_->row_));
+        sheet_data.write_markup("\">");
+        open_row_ = current_cell_->row_;
+    }
+
+    write_cell(sheet_data, cell(current_cell_));
+
+    // remove the side table entries of the cell so that they don't accumulate
+    current_cell_->clear_formula();
+    current_cell_->clear_hyperlink();
+    current_cell_->clear_text();
+    current_cell_->type(cell_type::empty);
+    current_cell_->value_numeric_ = 0;
+    current_cell_->format_ = nullptr;
+}
+
+std::size_t xlsx_producer::add_streamed_string(const std::string &text)
+{
+    if (!streamed_strings_)
+    {
+        streamed_strings_.reset(new spill_file());
+        streamed_strings_stream_.reset(new std::ostream(streamed_strings_.get()));
+        streamed_strings_writer_.reset(new sheet_data_writer(*streamed_strings_stream_, "xl/sharedStrings.xml"));
+        const_cast<workbook &>(source_).register_workbook_part(relationship_type::shared_string_table);
+    }
+
+    auto &writer = *streamed_strings_writer_;
+
+    if (!text.empty() && (text.front() == ' ' || text.back() == ' '))
+    {
+        writer.write_markup("<si><t xml:space=\"preserve\">");
+    }
+    else
+    {
+        writer.write_markup("<si><t>");
+    }
+
+    writer.write_text(text);
+    writer.write_markup("</t></si>");
+
+    return streamed_string_count_++;
 }
 
 // Part Writing Methods
@@ -128,6 +416,15 @@ void xlsx_producer::populate_archive(bool streaming)
 {
     streaming_ = streaming;
 
+    // cells are written with the format ids assigned by garbage collection so
+    // any collection deferred by an open style_edit_session has to happen now
+    auto &stylesheet = const_cast<workbook &>(source_).impl().stylesheet_;
+
+    if (stylesheet.is_set())
+    {
+        stylesheet.get().collect_pending_garbage();
+    }
+
     write_content_types();
 
     const auto root_rels = source_.manifest().relationships(path("/"));
@@ -642,6 +939,9 @@ void xlsx_producer::write_workbook(const relationship &rel)
     {
         if (child_rel.type() == relationship_type::calculation_chain) continue;
 
+        // streamed worksheets were written as their cells were added
+        if (streaming_ && child_rel.type() == relationship_type::worksheet) continue;
+
         path archive_path(child_rel.source().path().parent().append(child_rel.target().path()));
         begin_part(archive_path);
 
@@ -788,34 +1088,32 @@ void xlsx_producer::write_shared_string_table(const relationship & /*rel*/)
     write_start_element(xmlns, "sst");
     write_namespace(xmlns, "");
 
-    // todo: is there a more elegant way to get this number?
-    std::size_t string_count = 0;
-
-#pragma clang diagnostic push
-#pragma clang diagnostic ignored "-Wrange-loop-analysis"
-    for (const auto ws : source_)
+    if (streaming_)
     {
-        auto dimension = ws.calculate_dimension();
-        auto current_cell = dimension.top_left();
+        write_attribute("count", streamed_string_count_);
+        write_attribute("uniqueCount", streamed_string_count_);
 
-        while (current_cell.row() <= dimension.bottom_right().row())
+        // closes the start tag so that the spilled strings can be copied after it
+        write_characters("");
+
+        if (streamed_strings_)
         {
-            while (current_cell.column() <= dimension.bottom_right().column())
-            {
-                if (ws.has_cell(current_cell)
-                    && ws.cell(current_cell).data_type() == cell::type::shared_string)
-                {
-                    ++string_count;
-                }
+            streamed_strings_writer_->flush();
+            streamed_strings_stream_->flush();
+            streamed_strings_->copy_to(current_part_stream_);
+        }
 
-                current_cell.column_index(current_cell.column_index() + 1);
-            }
+        write_end_element(xmlns, "sst");
 
-            current_cell.row(current_cell.row() + 1);
-            current_cell.column_index(dimension.top_left().column_index());
-        }
+        return;
+    }
+
+    std::size_t string_count = 0;
+
+    for (const auto &ws : source_.impl().worksheets_)
+    {
+        string_count += ws.cell_map_.shared_string_count();
     }
-#pragma clang diagnostic pop
 
     write_attribute("count", string_count);
     write_attribute("uniqueCount", source_.shared_strings().size());
@@ -1995,11 +2293,7 @@ void xlsx_producer::write_volatile_dependencies(const relationship & /*rel*/)
 
 void xlsx_producer::write_worksheet(const relationship &rel)
 {
-    static const auto &xmlns = constants::ns("spreadsheetml");
-    static const auto &xmlns_r = constants::ns("r");
-
     auto worksheet_part = rel.source().path().parent().append(rel.target().path());
-    auto worksheet_rels = source_.manifest().relationships(worksheet_part);
 
     auto title = std::find_if(source_.d_->sheet_title_rel_id_map_.begin(), source_.d_->sheet_title_rel_id_map_.end(),
         [&](const std::pair<std::string, std::string> &p) {
@@ -2008,6 +2302,137 @@ void xlsx_producer::write_worksheet(const relationship &rel)
 
     auto ws = source_.sheet_by_title(title);
 
+    write_worksheet_start(ws);
+
+    std::unordered_map<std::string, std::string> reverse_hyperlink_references;
+
+    for (auto hyperlink_rel : source_.manifest().relationships(worksheet_part, relationship_type::hyperlink))
+    {
+        reverse_hyperlink_references[hyperlink_rel.target().path().string()] = rel.id();
+    }
+
+    std::unordered_map<std::string, std::string> hyperlink_references;
+    std::vector<cell_reference> cells_with_comments;
+
+    // rows and cells are the bulk of a worksheet so they bypass the serializer
+    // and are appended to the part stream directly until the writer is flushed
+    sheet_data_writer sheet_data(current_part_stream_, worksheet_part.string());
+
+    // visit only populated rows and rows with properties, in ascending order
+    const auto &cell_map = ws.d_->cell_map_;
+    auto rows = cell_map.rows();
+
+    if (!ws.d_->row_properties_.empty())
+    {
+        for (const auto &row_props : ws.d_->row_properties_)
+        {
+            rows.push_back(row_props.first);
+        }
+
+        std::sort(rows.begin(), rows.end());
+        rows.erase(std::unique(rows.begin(), rows.end()), rows.end());
+    }
+
+    for (auto row : rows)
+    {
+        const auto row_cells = cell_map.row(row);
+        bool any_non_null = false;
+
+        if (row_cells != nullptr)
+        {
+            any_non_null = std::any_of(row_cells->begin(), row_cells->end(),
+                [](const detail::cell_store::entry &e) { return !xlnt::cell(e.cell).garbage_collectible(); });
+        }
+
+        if (!any_non_null && !ws.has_row_properties(row)) continue;
+
+        sheet_data.write_markup("<row r=\"");
+        sheet_data.write_number(std::uint64_t(row));
+        sheet_data.write_markup("\"");
+
+        if (any_non_null)
+        {
+            sheet_data.write_markup(" spans=\"");
+            sheet_data.write_number(std::uint64_t(row_cells->front().column));
+            sheet_data.write_markup(":");
+            sheet_data.write_number(std::uint64_t(row_cells->back().column));
+            sheet_data.write_markup("\"");
+        }
+
+        if (ws.has_row_properties(row))
+        {
+            const auto &props = ws.row_properties(row);
+
+            if (props.custom_height)
+            {
+                sheet_data.write_markup(" customHeight=\"1\"");
+            }
+
+            if (props.height.is_set())
+            {
+                auto height = props.height.get();
+                sheet_data.write_markup(" ht=\"");
+
+                if (std::fabs(height - std::floor(height)) == 0.0)
+                {
+                    sheet_data.write_number(static_cast<std::int64_t>(height));
+                    sheet_data.write_markup(".0");
+                }
+                else
+                {
+                    sheet_data.write_number(height);
+                }
+
+                sheet_data.write_markup("\"");
+            }
+
+            if (props.hidden)
+            {
+                sheet_data.write_markup(" hidden=\"1\"");
+            }
+        }
+
+        if (!any_non_null)
+        {
+            sheet_data.write_markup("/>");
+            continue;
+        }
+
+        sheet_data.write_markup(">");
+
+        for (const auto &row_cell : *row_cells)
+        {
+            auto cell = xlnt::cell(row_cell.cell);
+
+            if (cell.garbage_collectible()) continue;
+
+            // record data about the cell needed later
+
+            if (cell.has_comment())
+            {
+                cells_with_comments.push_back(cell.reference());
+            }
+
+            if (cell.has_hyperlink())
+            {
+                hyperlink_references[cell.reference().to_string()] = reverse_hyperlink_references[cell.hyperlink()];
+            }
+
+            write_cell(sheet_data, cell);
+        }
+
+        sheet_data.write_markup("</row>");
+    }
+
+    sheet_data.flush();
+    write_worksheet_end(ws, worksheet_part, hyperlink_references, cells_with_comments);
+}
+
+void xlsx_producer::write_worksheet_start(worksheet ws)
+{
+    static const auto &xmlns = constants::ns("spreadsheetml");
+    static const auto &xmlns_r = constants::ns("r");
+
     write_start_element(xmlns, "worksheet");
     write_namespace(xmlns, "");
     write_namespace(xmlns_r, "r");
@@ -2028,12 +2453,16 @@ void xlsx_producer::write_worksheet(const relationship &rel)
         write_end_element(xmlns, "sheetPr");
     }
 
-    write_start_element(xmlns, "dimension");
-    const auto dimension = ws.calculate_dimension();
-    write_attribute("ref", dimension.is_single_cell()
-        ? dimension.top_left().to_string()
-        : dimension.to_string());
-    write_end_element(xmlns, "dimension");
+    // the cells of a streamed worksheet aren't known yet and dimension is optional
+    if (!streaming_)
+    {
+        write_start_element(xmlns, "dimension");
+        const auto dimension = ws.calculate_dimension();
+        write_attribute("ref", dimension.is_single_cell()
+            ? dimension.top_left().to_string()
+            : dimension.to_string());
+        write_end_element(xmlns, "dimension");
+    }
 
     if (ws.has_view())
     {
@@ -2109,25 +2538,33 @@ void xlsx_producer::write_worksheet(const relationship &rel)
     write_attribute("defaultRowHeight", "16");
     write_end_element(xmlns, "sheetFormatPr");
 
-    bool has_column_properties = false;
+    std::vector<column_t> property_columns;
+    property_columns.reserve(ws.d_->column_properties_.size());
 
-    for (auto column = ws.lowest_column(); column <= ws.highest_column(); column++)
+    for (const auto &column_props : ws.d_->column_properties_)
     {
-        if (ws.has_column_properties(column))
-        {
-            has_column_properties = true;
-            break;
-        }
+        property_columns.push_back(column_props.first);
+    }
+
+    std::sort(property_columns.begin(), property_columns.end());
+
+    bool has_column_properties = streaming_ && !property_columns.empty();
+
+    if (!property_columns.empty() && !ws.d_->cell_map_.empty())
+    {
+        const auto lowest_column = ws.lowest_column();
+        const auto highest_column = ws.highest_column();
+
+        has_column_properties = std::any_of(property_columns.begin(), property_columns.end(),
+            [&](column_t column) { return column >= lowest_column && column <= highest_column; });
     }
 
     if (has_column_properties)
     {
         write_start_element(xmlns, "cols");
 
-        for (auto column = ws.lowest_column_or_props(); column <= ws.highest_column_or_props(); column++)
+        for (auto column : property_columns)
         {
-            if (!ws.has_column_properties(column)) continue;
-
             const auto &props = ws.column_properties(column);
 
             write_start_element(xmlns, "col");
@@ -2160,216 +2597,21 @@ void xlsx_producer::write_worksheet(const relationship &rel)
         write_end_element(xmlns, "cols");
     }
 
-    const auto hyperlink_rels = source_.manifest().relationships(worksheet_part, relationship_type::hyperlink);
-    std::unordered_map<std::string, std::string> reverse_hyperlink_references;
-
-    for (auto hyperlink_rel : hyperlink_rels)
-    {
-        reverse_hyperlink_references[hyperlink_rel.target().path().string()] = rel.id();
-    }
-
-    std::unordered_map<std::string, std::string> hyperlink_references;
-    std::vector<cell_reference> cells_with_comments;
-
     write_start_element(xmlns, "sheetData");
 
-    for (auto row = ws.lowest_row_or_props(); row <= ws.highest_row_or_props(); ++row)
-    {
-        auto first_column = constants::max_column();
-        auto last_column = constants::min_column();
-
-        bool any_non_null = false;
-
-        for (auto column = dimension.top_left().column(); column <= dimension.bottom_right().column(); ++column)
-        {
-            if (!ws.has_cell(cell_reference(column, row))) continue;
-
-            auto cell = ws.cell(cell_reference(column, row));
-
-            first_column = std::min(first_column, cell.column());
-            last_column = std::max(last_column, cell.column());
-
-            if (!cell.garbage_collectible())
-            {
-                any_non_null = true;
-            }
-        }
-
-        if (!any_non_null && !ws.has_row_properties(row)) continue;
-
-        write_start_element(xmlns, "row");
-        write_attribute("r", row);
-
-        if (any_non_null)
-        {
-            auto span_string = std::to_string(first_column.index) + ":" + std::to_string(last_column.index);
-            write_attribute("spans", span_string);
-        }
-
-        if (ws.has_row_properties(row))
-        {
-            const auto &props = ws.row_properties(row);
-
-            if (props.custom_height)
-            {
-                write_attribute("customHeight", write_bool(true));
-            }
-
-            if (props.height.is_set())
-            {
-                auto height = props.height.get();
-
-                if (std::fabs(height - std::floor(height)) == 0.0)
-                {
-                    write_attribute("ht", std::to_string(static_cast<int>(height)) + ".0");
-                }
-                else
-                {
-                    write_attribute("ht", height);
-                }
-            }
-
-            if (props.hidden)
-            {
-                write_attribute("hidden", write_bool(true));
-            }
-        }
-
-        if (any_non_null)
-        {
-            for (auto column = dimension.top_left().column(); column <= dimension.bottom_right().column(); ++column)
-            {
-                if (!ws.has_cell(cell_reference(column, row))) continue;
-
-                auto cell = ws.cell(cell_reference(column, row));
-
-                if (cell.garbage_collectible()) continue;
-
-                // record data about the cell needed later
-
-                if (cell.has_comment())
-                {
-                    cells_with_comments.push_back(cell.reference());
-                }
-
-                if (cell.has_hyperlink())
-                {
-                    hyperlink_references[cell.reference().to_string()] = reverse_hyperlink_references[cell.hyperlink()];
-                }
-
-                write_start_element(xmlns, "c");
-
-                // begin cell attributes
-
-                write_attribute("r", cell.reference().to_string());
-
-                if (cell.has_format())
-                {
-                    write_attribute("s", cell.format().d_->id);
-                }
-
-                switch (cell.data_type())
-                {
-                case cell::type::empty:
-                    break;
-
-                case cell::type::boolean:
-                    write_attribute("t", "b");
-                    break;
-
-                case cell::type::date:
-                    write_attribute("t", "d");
-                    break;
-
-                case cell::type::error:
-                    write_attribute("t", "e");
-                    break;
-
-                case cell::type::inline_string:
-                    write_attribute("t", "inlineStr");
-                    break;
-
-                case cell::type::number:
-                    write_attribute("t", "n");
-                    break;
-
-                case cell::type::shared_string:
-                    write_attribute("t", "s");
-                    break;
-
-                case cell::type::formula_string:
-                    write_attribute("t", "str");
-                    break;
-                }
-
-                //write_attribute("cm", "");
-                //write_attribute("vm", "");
-                //write_attribute("ph", "");
-
-                // begin child elements
-
-                if (cell.has_formula())
-                {
-                    write_element(xmlns, "f", cell.formula());
-                }
-
-                switch (cell.data_type())
-                {
-                case cell::type::empty:
-                    break;
-
-                case cell::type::boolean:
-                    write_element(xmlns, "v", write_bool(cell.value<bool>()));
-                    break;
-
-                case cell::type::date:
-                    write_element(xmlns, "v", cell.value<std::string>());
-                    break;
-
-                case cell::type::error:
-                    write_element(xmlns, "v", cell.value<std::string>());
-                    break;
-
-                case cell::type::inline_string:
-                    write_start_element(xmlns, "is");
-                    // TODO: make a write_rich_text method and use that here
-                    write_element(xmlns, "t", cell.value<std::string>());
-                    write_end_element(xmlns, "is");
-                    break;
-
-                case cell::type::number:
-                    write_start_element(xmlns, "v");
-
-                    if (is_integral(cell.value<double>()))
-                    {
-                        write_characters(static_cast<std::int64_t>(cell.value<double>()));
-                    }
-                    else
-                    {
-                        std::stringstream ss;
-                        ss.precision(20);
-                        ss << cell.value<double>();
-                        write_characters(ss.str());
-                    }
-
-                    write_end_element(xmlns, "v");
-                    break;
-
-                case cell::type::shared_string:
-                    write_element(xmlns, "v", static_cast<std::size_t>(cell.d_->value_numeric_));
-                    break;
-
-                case cell::type::formula_string:
-                    write_element(xmlns, "v", cell.value<std::string>());
-                    break;
-                }
+    // closes the start tag so that rows can be written without the serializer
+    write_characters("");
+}
 
-                write_end_element(xmlns, "c");
-            }
-        }
+void xlsx_producer::write_worksheet_end(worksheet ws, const path &worksheet_part,
+    const std::unordered_map<std::string, std::string> &hyperlink_references,
+    const std::vector<cell_reference> &cells_with_comments)
+{
+    static const auto &xmlns = constants::ns("spreadsheetml");
+    static const auto &xmlns_r = constants::ns("r");
 
-        write_end_element(xmlns, "row");
-    }
+    const auto worksheet_rels = source_.manifest().relationships(worksheet_part);
+    const auto hyperlink_rels = source_.manifest().relationships(worksheet_part, relationship_type::hyperlink);
 
     write_end_element(xmlns, "sheetData");
 
@@ -2466,32 +2708,12 @@ void xlsx_producer::write_worksheet(const relationship &rel)
         write_start_element(xmlns, "pageMargins");
 
         // TODO: there must be a better way to do this
-        auto remove_trailing_zeros = [](const std::string &n) -> std::string {
-            auto decimal = n.find('.');
-
-            if (decimal == std::string::npos) return n;
-
-            auto index = n.size() - 1;
-
-            while (index >= decimal && n[index] == '0')
-            {
-                index--;
-            }
-
-            if (index == decimal)
-            {
-                return n.substr(0, decimal);
-            }
-
-            return n.substr(0, index + 1);
-        };
-
-        write_attribute("left", remove_trailing_zeros(std::to_string(ws.page_margins().left())));
-        write_attribute("right", remove_trailing_zeros(std::to_string(ws.page_margins().right())));
-        write_attribute("top", remove_trailing_zeros(std::to_string(ws.page_margins().top())));
-        write_attribute("bottom", remove_trailing_zeros(std::to_string(ws.page_margins().bottom())));
-        write_attribute("header", remove_trailing_zeros(std::to_string(ws.page_margins().header())));
-        write_attribute("footer", remove_trailing_zeros(std::to_string(ws.page_margins().footer())));
+        write_attribute("left", ws.page_margins().left());
+        write_attribute("right", ws.page_margins().right());
+        write_attribute("top", ws.page_margins().top());
+        write_attribute("bottom", ws.page_margins().bottom());
+        write_attribute("header", ws.page_margins().header());
+        write_attribute("footer", ws.page_margins().footer());
 
         write_end_element(xmlns, "pageMargins");
     }
@@ -2702,6 +2924,121 @@ void xlsx_producer::write_worksheet(const relationship &rel)
     }
 }
 
+void xlsx_producer::write_cell(sheet_data_writer &sheet_data, const xlnt::cell &cell)
+{
+    sheet_data.write_markup("<c r=\"");
+    sheet_data.write_reference(cell.reference());
+    sheet_data.write_markup("\"");
+
+    if (cell.has_format())
+    {
+        sheet_data.write_markup(" s=\"");
+        sheet_data.write_number(std::uint64_t(cell.format().d_->id));
+        sheet_data.write_markup("\"");
+    }
+
+    switch (cell.data_type())
+    {
+    case cell::type::empty:
+        break;
+
+    case cell::type::boolean:
+        sheet_data.write_markup(" t=\"b\"");
+        break;
+
+    case cell::type::date:
+        sheet_data.write_markup(" t=\"d\"");
+        break;
+
+    case cell::type::error:
+        sheet_data.write_markup(" t=\"e\"");
+        break;
+
+    case cell::type::inline_string:
+        sheet_data.write_markup(" t=\"inlineStr\"");
+        break;
+
+    case cell::type::number:
+        sheet_data.write_markup(" t=\"n\"");
+        break;
+
+    case cell::type::shared_string:
+        sheet_data.write_markup(" t=\"s\"");
+        break;
+
+    case cell::type::formula_string:
+        sheet_data.write_markup(" t=\"str\"");
+        break;
+    }
+
+    if (!cell.has_formula() && cell.data_type() == cell::type::empty)
+    {
+        sheet_data.write_markup("/>");
+        return;
+    }
+
+    sheet_data.write_markup(">");
+
+    // begin child elements
+
+    if (cell.has_formula())
+    {
+        sheet_data.write_markup("<f>");
+        sheet_data.write_text(cell.formula());
+        sheet_data.write_markup("</f>");
+    }
+
+    switch (cell.data_type())
+    {
+    case cell::type::empty:
+        break;
+
+    case cell::type::boolean:
+        sheet_data.write_markup("<v>");
+        sheet_data.write_text(write_bool(cell.value<bool>()));
+        sheet_data.write_markup("</v>");
+        break;
+
+    case cell::type::date:
+    case cell::type::error:
+    case cell::type::formula_string:
+        sheet_data.write_markup("<v>");
+        sheet_data.write_text(cell.value<std::string>());
+        sheet_data.write_markup("</v>");
+        break;
+
+    case cell::type::inline_string:
+        // TODO: make a write_rich_text method and use that here
+        sheet_data.write_markup("<is><t>");
+        sheet_data.write_text(cell.value<std::string>());
+        sheet_data.write_markup("</t></is>");
+        break;
+
+    case cell::type::number:
+        sheet_data.write_markup("<v>");
+
+        if (is_integral(cell.d_->value_numeric_))
+        {
+            sheet_data.write_number(static_cast<std::int64_t>(cell.d_->value_numeric_));
+        }
+        else
+        {
+            sheet_data.write_number(cell.d_->value_numeric_);
+        }
+
+        sheet_data.write_markup("</v>");
+        break;
+
+    case cell::type::shared_string:
+        sheet_data.write_markup("<v>");
+        sheet_data.write_number(static_cast<std::uint64_t>(cell.d_->value_numeric_));
+        sheet_data.write_markup("</v>");
+        break;
+    }
+
+    sheet_data.write_markup("</c>");
+}
+
 // Sheet Relationship Target Parts
 
 void xlsx_producer::write_comments(const relationship & /*rel*/, worksheet ws, const std::vector<cell_reference> &cells)
@@ -3070,5 +3407,36 @@ void xlsx_producer::write_namespace(const std::string &ns, const std::string &pr
     current_part_serializer_->namespace_decl(ns, prefix);
 }
 
+const std::string &xlsx_producer::format_double(double value)
+{
+    char buffer[max_shortest_double_length];
+    format_buffer_.assign(buffer, write_shortest_double(value, buffer));
+
+    return format_buffer_;
+}
+
+const std::string &xlsx_producer::format_reference(const cell_reference &reference)
+{
+    char buffer[cell_reference::max_string_length];
+    format_buffer_.assign(buffer, reference.to_chars(buffer));
+
+    return format_buffer_;
+}
+
+void xlsx_producer::write_attribute(const std::string &name, double value)
+{
+    current_part_serializer_->attribute(name, format_double(value));
+}
+
+void xlsx_producer::write_attribute(const xml::qname &name, double value)
+{
+    current_part_serializer_->attribute(name, format_double(value));
+}
+
+void xlsx_producer::write_characters(double value)
+{
+    current_part_serializer_->characters(format_double(value));
+}
+
 } // namespace detail
 } // namepsace xlnt
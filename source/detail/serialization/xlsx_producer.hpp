@@ -26,10 +26,14 @@
 #include <cstdint>
 #include <iostream>
 #include <memory>
+#include <string>
+#include <unordered_map>
 #include <vector>
 
 #include <detail/constants.hpp>
 #include <detail/external/include_libstudxml.hpp>
+#include <xlnt/cell/index_types.hpp>
+#include <xlnt/workbook/save_options.hpp>
 
 namespace xml {
 class serializer;
@@ -43,6 +47,7 @@ class cell_reference;
 class color;
 class fill;
 class font;
+class format;
 class path;
 class relationship;
 class streaming_workbook_writer;
@@ -53,6 +58,8 @@ class worksheet;
 namespace detail {
 
 class ozstream;
+class sheet_data_writer;
+class spill_file;
 struct cell_impl;
 struct worksheet_impl;
 
@@ -70,15 +77,64 @@ public:
 
     void write(std::ostream &destination, const std::string &password);
 
+    void write(std::ostream &destination, const save_options &options);
+
 private:
     friend class xlnt::streaming_workbook_writer;
 
+    /// <summary>
+    /// Begins streaming the workbook to destination. Worksheets are then
+    /// written one at a time as cells are added and the remaining parts are
+    /// written by close.
+    /// </summary>
     void open(std::ostream &destination);
 
+    void open(std::ostream &destination, const save_options &options);
+
+    /// <summary>
+    /// Ends the streamed worksheet and writes every other part of the package.
+    /// </summary>
+    void close();
+
+    /// <summary>
+    /// Begins a cell at ref in the streamed worksheet. It is written once the
+    /// caller has set it up, when the next cell is added or the worksheet ends.
+    /// Throws invalid_parameter if ref isn't after the previous cell.
+    /// </summary>
     cell add_cell(const cell_reference &ref);
 
+    /// <summary>
+    /// Writes a number cell at ref with the format with id format_id.
+    /// </summary>
+    void add_number_cell(const cell_reference &ref, std::size_t format_id, double value);
+
+    /// <summary>
+    /// Writes a boolean cell at ref with the format with id format_id.
+    /// </summary>
+    void add_boolean_cell(const cell_reference &ref, std::size_t format_id, bool value);
+
+    /// <summary>
+    /// Writes a shared string cell at ref with the format with id format_id
+    /// without adding text to the workbook's shared strings.
+    /// </summary>
+    void add_string_cell(const cell_reference &ref, std::size_t format_id, const std::string &text);
+
+    /// <summary>
+    /// Writes a cell at ref containing formula with the format with id format_id.
+    /// </summary>
+    void add_formula_cell(const cell_reference &ref, std::size_t format_id, const std::string &formula);
+
+    /// <summary>
+    /// Ends the streamed worksheet and begins a new one with the given title.
+    /// The first call renames the worksheet every new workbook starts with.
+    /// </summary>
     worksheet add_worksheet(const std::string &title);
 
+    /// <summary>
+    /// Returns the id of format, which must belong to the streamed workbook.
+    /// </summary>
+    std::size_t format_id(const format &format) const;
+
 	/// <summary>
 	/// Write all files needed to create a valid XLSX file which represents all
 	/// data contained in workbook.
@@ -119,6 +175,67 @@ private:
 	void write_dialogsheet(const relationship &rel);
 	void write_worksheet(const relationship &rel);
 
+    /// <summary>
+    /// Writes everything in the worksheet part of ws up to the sheetData start
+    /// tag, which is closed so that rows can be written by a sheet_data_writer.
+    /// </summary>
+    void write_worksheet_start(worksheet ws);
+
+    /// <summary>
+    /// Ends sheetData and writes the rest of the worksheet part of ws and the
+    /// parts related to it.
+    /// </summary>
+    void write_worksheet_end(worksheet ws, const path &worksheet_part,
+        const std::unordered_map<std::string, std::string> &hyperlink_references,
+        const std::vector<cell_reference> &cells_with_comments);
+
+    /// <summary>
+    /// Writes the c element of cell.
+    /// </summary>
+    void write_cell(sheet_data_writer &sheet_data, const cell &cell);
+
+    // Streaming
+
+    /// <summary>
+    /// Returns the path of the part of the streamed worksheet.
+    /// </summary>
+    path streamed_worksheet_part() const;
+
+    /// <summary>
+    /// Opens the part of the streamed worksheet and writes everything before its rows.
+    /// </summary>
+    void begin_streamed_worksheet();
+
+    /// <summary>
+    /// Writes the rest of the streamed worksheet, if any, and closes its part.
+    /// </summary>
+    void end_streamed_worksheet();
+
+    /// <summary>
+    /// Gives the cell begun by add_cell the format with id format_id.
+    /// </summary>
+    void apply_format(std::size_t format_id);
+
+    /// <summary>
+    /// Writes the cell begun by add_cell, if any, and resets it for the next one.
+    /// </summary>
+    void write_pending_cell();
+
+    /// <summary>
+    /// Serializes current_cell_ to the streamed worksheet and resets it for the next one.
+    /// </summary>
+    void write_streamed_cell();
+
+    /// <summary>
+    /// Throws xlnt::exception if writing a streamed cell has failed.
+    /// </summary>
+    void throw_if_failed() const;
+
+    /// <summary>
+    /// Appends text to the shared strings spilled to disk and returns its index.
+    /// </summary>
+    std::size_t add_streamed_string(const std::string &text);
+
 	// Sheet Relationship Target Parts
 
 	void write_comments(const relationship &rel, worksheet ws, const std::vector<cell_reference> &cells);
@@ -188,6 +305,31 @@ private:
         current_part_serializer_->characters(characters);
     }
 
+    /// <summary>
+    /// Writes value as a short decimal which reads back as the same double.
+    /// </summary>
+    void write_attribute(const std::string &name, double value);
+
+    /// <summary>
+    /// Writes value as a short decimal which reads back as the same double.
+    /// </summary>
+    void write_attribute(const xml::qname &name, double value);
+
+    /// <summary>
+    /// Writes value as a short decimal which reads back as the same double.
+    /// </summary>
+    void write_characters(double value);
+
+    /// <summary>
+    /// Formats value into format_buffer_ and returns it.
+    /// </summary>
+    const std::string &format_double(double value);
+
+    /// <summary>
+    /// Formats reference into format_buffer_ and returns it.
+    /// </summary>
+    const std::string &format_reference(const cell_reference &reference);
+
 	/// <summary>
 	/// A reference to the workbook which is the object of read/write operations.
 	/// </summary>
@@ -198,13 +340,66 @@ private:
     std::unique_ptr<std::streambuf> current_part_streambuf_;
     std::ostream current_part_stream_;
 
+    /// <summary>
+    /// Options passed to write.
+    /// </summary>
+    save_options options_;
+
     bool streaming_ = false;
 
-    std::unique_ptr<detail::cell_impl> streaming_cell_;
+    /// <summary>
+    /// Reused for formatting numbers and cell references so that writing
+    /// one doesn't allocate.
+    /// </summary>
+    std::string format_buffer_;
 
-    detail::cell_impl *current_cell_;
+    std::unique_ptr<detail::cell_impl> streaming_cell_;
 
-    detail::worksheet_impl *current_worksheet_;
+    detail::cell_impl *current_cell_ = nullptr;
+
+    detail::worksheet_impl *current_worksheet_ = nullptr;
+
+    /// <summary>
+    /// The number of worksheets begun by add_worksheet.
+    /// </summary>
+    std::size_t streamed_worksheets_ = 0;
+
+    /// <summary>
+    /// True if current_cell_ has been begun by add_cell but not yet written.
+    /// </summary>
+    bool cell_pending_ = false;
+
+    /// <summary>
+    /// True if writing a streamed cell threw, after which the streamed worksheet
+    /// is incomplete and the package is never finished.
+    /// </summary>
+    bool failed_ = false;
+
+    /// <summary>
+    /// The position of the last cell added to the streamed worksheet, used to
+    /// check that cells are added in order.
+    /// </summary>
+    row_t last_row_ = 0;
+    column_t::index_t last_column_ = 0;
+
+    /// <summary>
+    /// The row element which is open in the streamed worksheet or 0 if none is.
+    /// </summary>
+    row_t open_row_ = 0;
+
+    /// <summary>
+    /// Writes the rows of the streamed worksheet once its part has been begun.
+    /// </summary>
+    std::unique_ptr<sheet_data_writer> streamed_sheet_data_;
+
+    /// <summary>
+    /// The si elements of the shared string table when streaming. Every string
+    /// is appended so that nothing about them has to be kept in memory.
+    /// </summary>
+    std::unique_ptr<spill_file> streamed_strings_;
+    std::unique_ptr<std::ostream> streamed_strings_stream_;
+    std::unique_ptr<sheet_data_writer> streamed_strings_writer_;
+    std::size_t streamed_string_count_ = 0;
 };
 
 } // namespace detail
@@ -34,17 +34,22 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 */
 
 #include <algorithm>
-#include <array>
 #include <cassert>
+#include <condition_variable>
 #include <cstring>
+#include <exception>
 #include <fstream>
+#include <functional>
 #include <iomanip>
 #include <iostream>
 #include <iterator> // for std::back_inserter
+#include <limits>
 #include <stdexcept>
 #include <string>
+#include <thread>
 
 #include <xlnt/utils/exceptions.hpp>
+#include <detail/serialization/mapped_file.hpp>
 #include <detail/serialization/miniz.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/zstream.hpp>
@@ -66,6 +71,64 @@ void write_int(std::ostream &stream, T value)
     stream.write(reinterpret_cast<char *>(&value), sizeof(T));
 }
 
+// Sizes and offsets which don't fit below this value and entry counts which
+// don't fit below zip64_entry_limit are stored in ZIP64 records instead.
+const std::uint64_t zip64_limit = 0xffffffff;
+const std::uint64_t zip64_entry_limit = 0xffff;
+
+// The version needed to extract an entry with ZIP64 records.
+const std::uint16_t zip64_version = 45;
+
+const std::uint16_t zip64_extra_id = 0x0001;
+
+// Local headers written before the size of their entry is known reserve this
+// many bytes of extra field so that a ZIP64 extra field can be put there later.
+const std::uint16_t reserved_extra_size = 20;
+
+// The reserved space is filled with an Open Packaging growth hint, which is
+// how Office pads extra fields, when the entry turns out not to need ZIP64.
+const std::uint16_t growth_hint_id = 0xa220;
+const std::uint16_t growth_hint_signature = 0xa028;
+
+/// <summary>
+/// Replaces the sizes and offset of header which are stored as 0xffffffff with
+/// their values from the ZIP64 extra field, if there is one.
+/// </summary>
+void read_zip64_extra(xlnt::detail::zheader &header, const bool global)
+{
+    const auto &extra = header.extra;
+    std::size_t position = 0;
+
+    while (position + 4 <= extra.size())
+    {
+        const auto id = static_cast<std::uint16_t>(extra[position] | (extra[position + 1] << 8));
+        const auto size = static_cast<std::size_t>(extra[position + 2] | (extra[position + 3] << 8));
+        position += 4;
+
+        if (position + size > extra.size()) return;
+
+        if (id == zip64_extra_id)
+        {
+            // only the fields which overflowed are present, in this order
+            auto field = position;
+            const auto field_end = position + size;
+
+            for (auto value : {&header.uncompressed_size, &header.compressed_size, global ? &header.header_offset : nullptr})
+            {
+                if (value == nullptr || *value != zip64_limit) continue;
+                if (field + 8 > field_end) break;
+
+                std::memcpy(value, extra.data() + field, 8);
+                field += 8;
+            }
+
+            return;
+        }
+
+        position += size;
+    }
+}
+
 xlnt::detail::zheader read_header(std::istream &istream, const bool global)
 {
     xlnt::detail::zheader header;
@@ -123,31 +186,64 @@ xlnt::detail::zheader read_header(std::istream &istream, const bool global)
         istream.read(&header.comment[0], comment_length);
     }
 
+    read_zip64_extra(header, global);
+
     return header;
 }
 
-void write_header(const xlnt::detail::zheader &header, std::ostream &ostream, const bool global)
+/// <summary>
+/// Writes the local or central header of an entry. The sizes and offset are
+/// moved into a ZIP64 extra field when they don't fit in 32 bits. If reserve
+/// is true, the local header has an extra field of reserved_extra_size bytes
+/// whether or not it needs ZIP64 so that it can be rewritten in place once
+/// the sizes are known.
+/// </summary>
+void write_header(const xlnt::detail::zheader &header, std::ostream &ostream, const bool global, const bool reserve = false)
 {
+    // local headers have both sizes in the ZIP64 extra field or neither of them
+    const auto sizes_overflow = header.uncompressed_size >= zip64_limit || header.compressed_size >= zip64_limit;
+    std::vector<std::uint64_t> zip64_fields;
+
+    if (global)
+    {
+        if (header.uncompressed_size >= zip64_limit) zip64_fields.push_back(header.uncompressed_size);
+        if (header.compressed_size >= zip64_limit) zip64_fields.push_back(header.compressed_size);
+        if (header.header_offset >= zip64_limit) zip64_fields.push_back(header.header_offset);
+    }
+    else if (sizes_overflow)
+    {
+        zip64_fields.push_back(header.uncompressed_size);
+        zip64_fields.push_back(header.compressed_size);
+    }
+
+    const auto zip64 = !zip64_fields.empty();
+    const auto version = zip64 ? std::max(header.version, zip64_version) : header.version;
+    const auto zip64_extra_size = zip64 ? static_cast<std::uint16_t>(4 + 8 * zip64_fields.size()) : std::uint16_t(0);
+    const auto extra_size = reserve ? reserved_extra_size : zip64_extra_size;
+    const auto stored_size = [sizes_overflow, global](std::uint64_t value) {
+        return static_cast<std::uint32_t>(value >= zip64_limit || (!global && sizes_overflow) ? zip64_limit : value);
+    };
+
     if (global)
     {
         write_int(ostream, static_cast<std::uint32_t>(0x02014b50)); // header sig
-        write_int(ostream, static_cast<std::uint16_t>(20)); // version made by
+        write_int(ostream, std::max(std::uint16_t(20), version)); // version made by
     }
     else
     {
         write_int(ostream, static_cast<std::uint32_t>(0x04034b50));
     }
 
-    write_int(ostream, header.version);
+    write_int(ostream, version);
     write_int(ostream, header.flags);
     write_int(ostream, header.compression_type);
     write_int(ostream, header.stamp_date);
     write_int(ostream, header.stamp_time);
     write_int(ostream, header.crc);
-    write_int(ostream, header.compressed_size);
-    write_int(ostream, header.uncompressed_size);
+    write_int(ostream, stored_size(header.compressed_size));
+    write_int(ostream, stored_size(header.uncompressed_size));
     write_int(ostream, static_cast<std::uint16_t>(header.filename.length()));
-    write_int(ostream, static_cast<std::uint16_t>(0)); // extra lengthx
+    write_int(ostream, extra_size); // extra length
 
     if (global)
     {
@@ -155,13 +251,40 @@ void write_header(const xlnt::detail::zheader &header, std::ostream &ostream, co
         write_int(ostream, static_cast<std::uint16_t>(0)); // disk# start
         write_int(ostream, static_cast<std::uint16_t>(0)); // internal file
         write_int(ostream, static_cast<std::uint32_t>(0)); // ext final
-        write_int(ostream, static_cast<std::uint32_t>(header.header_offset)); // rel offset
+        write_int(ostream, stored_size(header.header_offset)); // rel offset
     }
 
     for (auto c : header.filename)
     {
         write_int(ostream, c);
     }
+
+    if (zip64)
+    {
+        write_int(ostream, zip64_extra_id);
+        write_int(ostream, static_cast<std::uint16_t>(zip64_extra_size - 4));
+
+        for (auto field : zip64_fields)
+        {
+            write_int(ostream, field);
+        }
+    }
+
+    if (extra_size > zip64_extra_size)
+    {
+        // pad the rest of the reserved space with a growth hint
+        const auto padding = static_cast<std::uint16_t>(extra_size - zip64_extra_size - 8);
+
+        write_int(ostream, growth_hint_id);
+        write_int(ostream, static_cast<std::uint16_t>(padding + 4));
+        write_int(ostream, growth_hint_signature);
+        write_int(ostream, padding);
+
+        for (std::uint16_t i = 0; i < padding; ++i)
+        {
+            write_int(ostream, '\0');
+        }
+    }
 }
 
 } // namespace
@@ -169,18 +292,122 @@ void write_header(const xlnt::detail::zheader &header, std::ostream &ostream, co
 namespace xlnt {
 namespace detail {
 
-static const std::size_t buffer_size = 512;
+// Streambufs size their buffers from the entry they read or write, within
+// these bounds, unless a fixed size is requested.
+static const std::size_t min_buffer_size = 64 * 1024;
+static const std::size_t max_buffer_size = 1024 * 1024;
+
+// Entries with at most this many compressed bytes are read in one piece by
+// izstream::read so that they can be inflated in a single call.
+static const std::size_t max_single_pass_size = 16 * max_buffer_size;
+
+// Bytes kept at the front of the decompression buffer for putback.
+static const std::size_t putback_size = 4;
+
+/// <summary>
+/// Returns requested_size if it isn't 0, otherwise a size proportional to
+/// entry_size between min_buffer_size and max_buffer_size. Small entries get
+/// a buffer no larger than needed to hold them in one piece.
+/// </summary>
+std::size_t buffer_size_for(std::size_t entry_size, std::size_t requested_size)
+{
+    if (requested_size != 0)
+    {
+        return requested_size;
+    }
+
+    const auto adaptive = std::min(std::max(entry_size / 16, min_buffer_size), max_buffer_size);
+
+    return std::max(std::min(adaptive, entry_size), std::size_t(1));
+}
+
+int zlib_strategy(save_options::compression_strategy strategy)
+{
+    switch (strategy)
+    {
+    case save_options::compression_strategy::filtered:
+        return Z_FILTERED;
+    case save_options::compression_strategy::huffman_only:
+        return Z_HUFFMAN_ONLY;
+    case save_options::compression_strategy::run_length:
+        return Z_RLE;
+    case save_options::compression_strategy::fixed:
+        return Z_FIXED;
+    case save_options::compression_strategy::default_strategy:
+        break;
+    }
+
+    return Z_DEFAULT_STRATEGY;
+}
+
+// Parts larger than this are split into independently deflated blocks when
+// compressing in parallel. miniz can't prime a block with the previous one's
+// window like pigz does so blocks are kept large to limit the loss in ratio.
+static const std::size_t parallel_block_size = 256 * 1024;
+
+/// <summary>
+/// Reads a block of memory in place. The get area spans the whole block so
+/// nothing is ever copied into the streambuf.
+/// </summary>
+class memory_istreambuf : public std::streambuf
+{
+public:
+    memory_istreambuf(const std::uint8_t *data, std::size_t size)
+    {
+        auto begin = reinterpret_cast<char *>(const_cast<std::uint8_t *>(data));
+        setg(begin, begin, begin + size);
+    }
+
+private:
+    std::streampos seekoff(std::streamoff off, std::ios_base::seekdir way, std::ios_base::openmode which)
+    {
+        auto base = std::streamoff(0);
+
+        if (way == std::ios_base::cur)
+        {
+            base = gptr() - eback();
+        }
+        else if (way == std::ios_base::end)
+        {
+            base = egptr() - eback();
+        }
+
+        return seekpos(std::streampos(base + off), which);
+    }
+
+    std::streampos seekpos(std::streampos sp, std::ios_base::openmode)
+    {
+        const auto position = static_cast<std::streamoff>(sp);
+
+        if (position < 0 || position > egptr() - eback())
+        {
+            return std::streampos(std::streamoff(-1));
+        }
+
+        setg(eback(), eback() + position, egptr());
+
+        return sp;
+    }
+
+    int overflow(int)
+    {
+        throw xlnt::exception("writing to read-only buffer");
+    }
+};
 
 class zip_streambuf_decompress : public std::streambuf
 {
-    std::istream &istream;
+    // exactly one of these is set: the stream positioned at the local header
+    // or the compressed data in memory
+    std::istream *istream;
+    const std::uint8_t *source;
 
     z_stream strm;
-    std::array<char, buffer_size> in;
-    std::array<char, buffer_size> out;
+    std::vector<char> in;
+    std::vector<char> out;
     zheader header;
-    std::size_t total_read;
-    std::size_t total_uncompressed;
+    std::uint64_t total_read;
+    std::uint64_t total_uncompressed;
     bool valid;
     bool compressed_data;
 
@@ -188,24 +415,48 @@ class zip_streambuf_decompress : public std::streambuf
     static const unsigned short UNCOMPRESSED = 0;
 
 public:
-    zip_streambuf_decompress(std::istream &stream, zheader central_header)
-        : istream(stream), header(central_header), total_read(0), total_uncompressed(0), valid(true)
+    zip_streambuf_decompress(std::istream &stream, zheader central_header, std::size_t buffer_size = 0)
+        : istream(&stream),
+          source(nullptr),
+          in(buffer_size_for(central_header.compressed_size, buffer_size)),
+          out(buffer_size_for(central_header.uncompressed_size, buffer_size) + putback_size),
+          header(central_header),
+          total_read(0),
+          total_uncompressed(0),
+          valid(true)
     {
-        in.fill(0);
-        out.fill(0);
+        // skip the header
+        read_header(stream, false);
+        start();
+    }
 
+    /// <summary>
+    /// Reads the entry described by central_header from compressed_data, the
+    /// bytes following its local header, without copying them.
+    /// </summary>
+    zip_streambuf_decompress(const std::uint8_t *compressed_data, zheader central_header, std::size_t buffer_size)
+        : istream(nullptr),
+          source(compressed_data),
+          out(buffer_size_for(central_header.uncompressed_size, buffer_size) + putback_size),
+          header(central_header),
+          total_read(0),
+          total_uncompressed(0),
+          valid(true)
+    {
+        start();
+    }
+
+    void start()
+    {
         strm.zalloc = nullptr;
         strm.zfree = nullptr;
         strm.opaque = nullptr;
         strm.avail_in = 0;
         strm.next_in = nullptr;
 
-        setg(in.data(), in.data(), in.data());
+        setg(out.data(), out.data(), out.data());
         setp(nullptr, nullptr);
 
-        // skip the header
-        read_header(istream, false);
-
         if (header.compression_type == DEFLATE)
         {
             compressed_data = true;
@@ -233,8 +484,6 @@ public:
                 throw xlnt::exception("couldn't inflate ZIP, possibly corrupted");
             }
         }
-
-        header = central_header;
     }
 
     virtual ~zip_streambuf_decompress()
@@ -251,17 +500,25 @@ public:
 
         if (compressed_data)
         {
-            strm.avail_out = buffer_size - 4;
-            strm.next_out = reinterpret_cast<Bytef *>(out.data() + 4);
+            strm.avail_out = static_cast<unsigned int>(out.size() - putback_size);
+            strm.next_out = reinterpret_cast<Bytef *>(out.data() + putback_size);
 
             while (strm.avail_out != 0)
             {
-                if (strm.avail_in == 0)
+                if (strm.avail_in == 0 && source != nullptr)
+                {
+                    // inflate straight from memory, at most 4 GiB at a time
+                    strm.next_in = source + total_read;
+                    strm.avail_in = static_cast<unsigned int>(std::min(header.compressed_size - total_read,
+                        static_cast<std::uint64_t>(std::numeric_limits<unsigned int>::max())));
+                    total_read += strm.avail_in;
+                }
+                else if (strm.avail_in == 0)
                 {
                     // buffer empty, read some more from file
-                    istream.read(in.data(),
-                        static_cast<std::streamsize>(std::min(buffer_size, header.compressed_size - total_read)));
-                    strm.avail_in = static_cast<unsigned int>(istream.gcount());
+                    istream->read(in.data(), static_cast<std::streamsize>(
+                        std::min(static_cast<std::uint64_t>(in.size()), header.compressed_size - total_read)));
+                    strm.avail_in = static_cast<unsigned int>(istream->gcount());
                     total_read += strm.avail_in;
                     strm.next_in = reinterpret_cast<Bytef *>(in.data());
                 }
@@ -276,17 +533,27 @@ public:
                 if (ret == Z_STREAM_END) break;
             }
 
-            auto unzip_count = buffer_size - strm.avail_out - 4;
+            auto unzip_count = out.size() - putback_size - strm.avail_out;
             total_uncompressed += unzip_count;
             return static_cast<int>(unzip_count);
         }
 
         // uncompressed, so just read
-        istream.read(out.data() + 4,
-            static_cast<std::streamsize>(std::min(buffer_size - 4, header.uncompressed_size - total_read)));
-        auto count = istream.gcount();
-        total_read += static_cast<std::size_t>(count);
-        return static_cast<int>(count);
+        const auto count = static_cast<std::size_t>(std::min(
+            static_cast<std::uint64_t>(out.size() - putback_size), header.uncompressed_size - total_read));
+
+        if (source != nullptr)
+        {
+            std::memcpy(out.data() + putback_size, source + total_read, count);
+            total_read += count;
+
+            return static_cast<int>(count);
+        }
+
+        istream->read(out.data() + putback_size, static_cast<std::streamsize>(count));
+        const auto read_count = istream->gcount();
+        total_read += static_cast<std::uint64_t>(read_count);
+        return static_cast<int>(read_count);
     }
 
     virtual int underflow()
@@ -294,11 +561,12 @@ public:
         if (gptr() && (gptr() < egptr()))
             return traits_type::to_int_type(*gptr()); // if we already have data just use it
         auto put_back_count = gptr() - eback();
-        if (put_back_count > 4) put_back_count = 4;
-        std::memmove(
-            out.data() + (4 - put_back_count), gptr() - put_back_count, static_cast<std::size_t>(put_back_count));
+        if (put_back_count > static_cast<std::ptrdiff_t>(putback_size)) put_back_count = putback_size;
+        std::memmove(out.data() + (putback_size - static_cast<std::size_t>(put_back_count)),
+            gptr() - put_back_count, static_cast<std::size_t>(put_back_count));
         int num = process();
-        setg(out.data() + 4 - put_back_count, out.data() + 4, out.data() + 4 + num);
+        setg(out.data() + putback_size - put_back_count, out.data() + putback_size,
+            out.data() + putback_size + num);
         if (num <= 0) return EOF;
         return traits_type::to_int_type(*gptr());
     }
@@ -311,48 +579,90 @@ int zip_streambuf_decompress::overflow(int)
     throw xlnt::exception("writing to read-only buffer");
 }
 
+/// <summary>
+/// Owns a private copy of the raw bytes of one archive entry so that it can be
+/// decompressed without touching the stream shared by the archive.
+/// Kept as a separate base so that it is constructed before the decompressor.
+/// </summary>
+struct detached_entry
+{
+    detached_entry(std::vector<std::uint8_t> &&entry_bytes)
+        : bytes(std::move(entry_bytes)), buffer(bytes), stream(&buffer)
+    {
+    }
+
+    std::vector<std::uint8_t> bytes;
+    vector_istreambuf buffer;
+    std::istream stream;
+};
+
+class detached_zip_streambuf : private detached_entry, public zip_streambuf_decompress
+{
+public:
+    detached_zip_streambuf(std::vector<std::uint8_t> &&entry_bytes, zheader central_header, std::size_t buffer_size)
+        : detached_entry(std::move(entry_bytes)),
+          zip_streambuf_decompress(detached_entry::stream, central_header, buffer_size)
+    {
+    }
+};
+
 class zip_streambuf_compress : public std::streambuf
 {
     std::ostream &ostream; // owned when header==0 (when not part of zip file)
 
     z_stream strm;
-    std::array<char, buffer_size> in;
-    std::array<char, buffer_size> out;
+    std::vector<char> in;
+    std::vector<char> out;
 
     zheader *header;
-    std::uint32_t uncompressed_size;
+    std::uint64_t uncompressed_size;
     std::uint32_t crc;
 
     bool valid;
+    bool store;
 
 public:
-    zip_streambuf_compress(zheader *central_header, std::ostream &stream)
-        : ostream(stream), header(central_header), valid(true)
+    zip_streambuf_compress(zheader *central_header, std::ostream &stream, const save_options &options)
+        : ostream(stream),
+          // the size of the entry isn't known up front so the smallest adaptive size is used
+          in(options.zip_buffer_size != 0 ? options.zip_buffer_size : min_buffer_size),
+          out(in.size()),
+          header(central_header),
+          valid(true),
+          store(options.store_only)
     {
         strm.zalloc = nullptr;
         strm.zfree = nullptr;
         strm.opaque = nullptr;
 
+        if (store)
+        {
+            if (header) header->compression_type = 0;
+        }
+        else
+        {
 #pragma clang diagnostic push
 #pragma clang diagnostic ignored "-Wold-style-cast"
-        int ret = deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+            int ret = deflateInit2(&strm, options.compression_level, Z_DEFLATED, -MAX_WBITS, 8,
+                zlib_strategy(options.strategy));
 #pragma clang diagnostic pop
 
-        if (ret != Z_OK)
-        {
-            std::cerr << "libz: failed to deflateInit" << std::endl;
-            valid = false;
-            return;
+            if (ret != Z_OK)
+            {
+                std::cerr << "libz: failed to deflateInit" << std::endl;
+                valid = false;
+                return;
+            }
         }
 
         setg(nullptr, nullptr, nullptr);
-        setp(in.data(), in.data() + buffer_size - 4); // we want to be 4 aligned
+        setp(in.data(), in.data() + in.size() - 4); // we want to be 4 aligned
 
-        // Write appropriate header
+        // Write appropriate header, leaving room for ZIP64 sizes since they aren't known yet
         if (header)
         {
-            header->header_offset = static_cast<std::uint32_t>(stream.tellp());
-            write_header(*header, ostream, false);
+            header->header_offset = static_cast<std::uint64_t>(stream.tellp());
+            write_header(*header, ostream, false, true);
         }
 
         uncompressed_size = crc = 0;
@@ -363,20 +673,20 @@ public:
         if (valid)
         {
             process(true);
-            deflateEnd(&strm);
+            if (!store) deflateEnd(&strm);
             if (header)
             {
                 std::ios::streampos final_position = ostream.tellp();
                 header->uncompressed_size = uncompressed_size;
                 header->crc = crc;
-                ostream.seekp(header->header_offset);
-                write_header(*header, ostream, false);
+                ostream.seekp(static_cast<std::streamoff>(header->header_offset));
+                write_header(*header, ostream, false, true);
                 ostream.seekp(final_position);
             }
             else
             {
                 write_int(ostream, crc);
-                write_int(ostream, uncompressed_size);
+                write_int(ostream, static_cast<std::uint32_t>(uncompressed_size));
             }
         }
         if (!header) delete &ostream;
@@ -390,9 +700,16 @@ protected:
         strm.next_in = reinterpret_cast<Bytef *>(pbase());
         strm.avail_in = static_cast<unsigned int>(pptr() - pbase());
 
-        while (strm.avail_in != 0 || flush)
+        if (store)
+        {
+            ostream.write(pbase(), pptr() - pbase());
+            if (header) header->compressed_size += strm.avail_in;
+            strm.avail_in = 0;
+        }
+
+        while (!store && (strm.avail_in != 0 || flush))
         {
-            strm.avail_out = buffer_size;
+            strm.avail_out = static_cast<unsigned int>(out.size());
             strm.next_out = reinterpret_cast<Bytef *>(out.data());
 
             int ret = deflate(&strm, flush ? Z_FINISH : Z_NO_FLUSH);
@@ -407,7 +724,7 @@ protected:
 
             auto generated_output = static_cast<int>(strm.next_out - reinterpret_cast<std::uint8_t *>(out.data()));
             ostream.write(out.data(), generated_output);
-            if (header) header->compressed_size += static_cast<std::uint32_t>(generated_output);
+            if (header) header->compressed_size += static_cast<std::uint64_t>(generated_output);
             if (ret == Z_STREAM_END) break;
         }
 
@@ -415,7 +732,7 @@ protected:
         auto consumed_input = static_cast<std::uint32_t>(pptr() - pbase());
         uncompressed_size += consumed_input;
         crc = static_cast<std::uint32_t>(crc32(crc, reinterpret_cast<Bytef *>(in.data()), consumed_input));
-        setp(pbase(), pbase() + buffer_size - 4);
+        setp(pbase(), pbase() + in.size() - 4);
 
         return 1;
     }
@@ -445,35 +762,316 @@ int zip_streambuf_compress::overflow(int c)
     return c;
 }
 
+/// <summary>
+/// A fixed number of threads which run queued tasks in order.
+/// </summary>
+class deflate_pool
+{
+public:
+    deflate_pool(std::size_t thread_count)
+        : stopping_(false)
+    {
+        for (std::size_t i = 0; i < thread_count; ++i)
+        {
+            threads_.emplace_back([this]() { run(); });
+        }
+    }
+
+    ~deflate_pool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stopping_ = true;
+        }
+
+        ready_.notify_all();
+
+        for (auto &thread : threads_)
+        {
+            thread.join();
+        }
+    }
+
+    void submit(std::function<void()> &&task)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            tasks_.push_back(std::move(task));
+        }
+
+        ready_.notify_one();
+    }
+
+private:
+    void run()
+    {
+        while (true)
+        {
+            std::function<void()> task;
+
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                ready_.wait(lock, [this]() { return stopping_ || !tasks_.empty(); });
+
+                // queued tasks are still run after stopping so that no entry is left unfinished
+                if (tasks_.empty()) return;
+
+                task = std::move(tasks_.front());
+                tasks_.pop_front();
+            }
+
+            task();
+        }
+    }
+
+    std::vector<std::thread> threads_;
+    std::deque<std::function<void()>> tasks_;
+    std::mutex mutex_;
+    std::condition_variable ready_;
+    bool stopping_;
+};
+
+/// <summary>
+/// A file which has been closed and is being compressed on a deflate_pool.
+/// Its data is split into blocks which are deflated separately and the CRC is
+/// computed by one more task so that all of them can run at the same time.
+/// </summary>
+struct deflate_entry
+{
+    std::size_t header_index;
+    std::vector<std::uint8_t> data;
+    std::vector<std::vector<std::uint8_t>> blocks;
+    std::uint32_t crc = 0;
+
+    std::mutex mutex;
+    std::condition_variable done;
+    std::size_t remaining_tasks = 0;
+    std::exception_ptr error;
+
+    void finish_task(std::exception_ptr task_error)
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+
+            if (task_error && !error)
+            {
+                error = task_error;
+            }
+
+            --remaining_tasks;
+        }
+
+        done.notify_all();
+    }
+};
+
+/// <summary>
+/// Deflates one block of entry as a raw deflate stream. Every block but the
+/// last ends with a sync flush instead of a final block so that the outputs
+/// can be concatenated into a single stream.
+/// </summary>
+void deflate_block(deflate_entry &entry, std::size_t block_index, const save_options &options)
+{
+    const auto first = block_index * parallel_block_size;
+    const auto length = std::min(parallel_block_size, entry.data.size() - first);
+    const auto last = block_index + 1 == entry.blocks.size();
+    const auto flush = last ? Z_FINISH : Z_SYNC_FLUSH;
+
+    z_stream strm;
+    strm.zalloc = nullptr;
+    strm.zfree = nullptr;
+    strm.opaque = nullptr;
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+    if (deflateInit2(&strm, options.compression_level, Z_DEFLATED, -MAX_WBITS, 8, zlib_strategy(options.strategy)) != Z_OK)
+#pragma clang diagnostic pop
+    {
+        throw xlnt::exception("libz: failed to deflateInit");
+    }
+
+    auto &output = entry.blocks[block_index];
+    output.resize(static_cast<std::size_t>(deflateBound(&strm, static_cast<mz_ulong>(length))) + 16);
+
+    strm.next_in = entry.data.data() + first;
+    strm.avail_in = static_cast<unsigned int>(length);
+    strm.next_out = output.data();
+    strm.avail_out = static_cast<unsigned int>(output.size());
+
+    while (true)
+    {
+        const auto ret = deflate(&strm, flush);
+
+        if (ret == Z_STREAM_END || (!last && ret == Z_OK && strm.avail_in == 0 && strm.avail_out != 0))
+        {
+            break;
+        }
+
+        if (ret != Z_OK && ret != Z_BUF_ERROR)
+        {
+            deflateEnd(&strm);
+            throw xlnt::exception("libz: failed to deflate");
+        }
+
+        const auto produced = output.size() - strm.avail_out;
+        output.resize(output.size() * 2);
+        strm.next_out = output.data() + produced;
+        strm.avail_out = static_cast<unsigned int>(output.size() - produced);
+    }
+
+    output.resize(output.size() - strm.avail_out);
+    deflateEnd(&strm);
+}
+
+/// <summary>
+/// Collects the uncompressed contents of a file in memory and hands them to
+/// the ozstream for compression when destroyed.
+/// </summary>
+class deferred_zip_streambuf : public std::streambuf
+{
+public:
+    deferred_zip_streambuf(ozstream &archive, std::size_t header_index)
+        : archive_(archive), header_index_(header_index), written_(0)
+    {
+        setg(nullptr, nullptr, nullptr);
+        setp(nullptr, nullptr);
+    }
+
+    virtual ~deferred_zip_streambuf()
+    {
+        written_ += static_cast<std::size_t>(pptr() - pbase());
+        data_.resize(written_);
+        archive_.deflate_file(header_index_, std::move(data_));
+    }
+
+protected:
+    virtual int_type overflow(int_type c)
+    {
+        // the put area only ever covers the unused end of data_ so that
+        // pbump isn't needed to restore offsets larger than an int
+        written_ += static_cast<std::size_t>(pptr() - pbase());
+        data_.resize(std::max(parallel_block_size, data_.size() * 2));
+
+        auto base = reinterpret_cast<char *>(data_.data());
+        setp(base + written_, base + data_.size());
+
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+        {
+            *pptr() = traits_type::to_char_type(c);
+            pbump(1);
+        }
+
+        return traits_type::not_eof(c);
+    }
+
+    virtual int_type underflow()
+    {
+        throw xlnt::exception("Attempt to read write only ostream");
+    }
+
+private:
+    ozstream &archive_;
+    std::size_t header_index_;
+    std::vector<std::uint8_t> data_;
+    std::size_t written_;
+};
+
 ozstream::ozstream(std::ostream &stream)
-    : destination_stream_(stream)
+    : ozstream(stream, save_options())
+{
+}
+
+ozstream::ozstream(std::ostream &stream, const save_options &options)
+    : destination_stream_(stream),
+      options_(options)
 {
     if (!destination_stream_)
     {
         throw xlnt::exception("bad zip stream");
     }
+
+    if (options.compression_level < 0 || options.compression_level > 9
+        || (options.zip_buffer_size != 0 && options.zip_buffer_size < 16))
+    {
+        throw xlnt::invalid_parameter();
+    }
+
+    if (options.compression_threads != 1)
+    {
+        auto thread_count = options.compression_threads == 0
+            ? static_cast<std::size_t>(std::thread::hardware_concurrency())
+            : options.compression_threads;
+        pool_.reset(new deflate_pool(std::max(thread_count, std::size_t(1))));
+    }
 }
 
 ozstream::~ozstream()
 {
+    if (pool_)
+    {
+        // entries that failed to compress are dropped from pending_ and left out
+        // of the archive, the error having already been reported by flush
+        while (!pending_.empty())
+        {
+            try
+            {
+                write_pending(true);
+            }
+            catch (...)
+            {
+            }
+        }
+
+        pool_.reset();
+    }
+
     // Write all file headers
-    std::ios::streampos final_position = destination_stream_.tellp();
+    const auto central_start = static_cast<std::uint64_t>(destination_stream_.tellp());
+    auto entry_count = std::uint64_t(0);
+
+    for (std::size_t index = 0; index < file_headers_.size(); ++index)
+    {
+        if (!written_[index]) continue;
+
+        write_header(file_headers_[index], destination_stream_, true);
+        ++entry_count;
+    }
 
-    for (const auto &header : file_headers_)
+    const auto central_end = static_cast<std::uint64_t>(destination_stream_.tellp());
+    const auto central_size = central_end - central_start;
+    const auto zip64 = entry_count >= zip64_entry_limit || central_size >= zip64_limit || central_start >= zip64_limit;
+
+    if (zip64)
     {
-        write_header(header, destination_stream_, true);
+        // Write ZIP64 end of central
+        write_int(destination_stream_, static_cast<std::uint32_t>(0x06064b50)); // ZIP64 end of central
+        write_int(destination_stream_, static_cast<std::uint64_t>(44)); // size of the rest of this record
+        write_int(destination_stream_, zip64_version); // version made by
+        write_int(destination_stream_, zip64_version); // version needed
+        write_int(destination_stream_, static_cast<std::uint32_t>(0)); // this disk number
+        write_int(destination_stream_, static_cast<std::uint32_t>(0)); // disk with central
+        write_int(destination_stream_, entry_count); // entries in center in this disk
+        write_int(destination_stream_, entry_count); // entries in center
+        write_int(destination_stream_, central_size); // size of header
+        write_int(destination_stream_, central_start); // offset to header
+
+        // Write ZIP64 end of central locator
+        write_int(destination_stream_, static_cast<std::uint32_t>(0x07064b50)); // ZIP64 locator
+        write_int(destination_stream_, static_cast<std::uint32_t>(0)); // disk with ZIP64 end of central
+        write_int(destination_stream_, central_end); // offset to ZIP64 end of central
+        write_int(destination_stream_, static_cast<std::uint32_t>(1)); // number of disks
     }
 
-    std::ios::streampos central_end = destination_stream_.tellp();
+    // Write end of central, pointing to the ZIP64 record for values which don't fit
+    const auto stored_count = static_cast<std::uint16_t>(std::min(entry_count, zip64_entry_limit));
 
-    // Write end of central
     write_int(destination_stream_, static_cast<std::uint32_t>(0x06054b50)); // end of central
     write_int(destination_stream_, static_cast<std::uint16_t>(0)); // this disk number
     write_int(destination_stream_, static_cast<std::uint16_t>(0)); // this disk number
-    write_int(destination_stream_, static_cast<std::uint16_t>(file_headers_.size())); // one entry in center in this disk
-    write_int(destination_stream_, static_cast<std::uint16_t>(file_headers_.size())); // one entry in center
-    write_int(destination_stream_, static_cast<std::uint32_t>(central_end - final_position)); // size of header
-    write_int(destination_stream_, static_cast<std::uint32_t>(final_position)); // offset to header
+    write_int(destination_stream_, stored_count); // one entry in center in this disk
+    write_int(destination_stream_, stored_count); // one entry in center
+    write_int(destination_stream_, static_cast<std::uint32_t>(std::min(central_size, zip64_limit))); // size of header
+    write_int(destination_stream_, static_cast<std::uint32_t>(std::min(central_start, zip64_limit))); // offset to header
     write_int(destination_stream_, static_cast<std::uint16_t>(0)); // zip comment
 }
 
@@ -482,13 +1080,213 @@ std::unique_ptr<std::streambuf> ozstream::open(const path &filename)
     zheader header;
     header.filename = filename.string();
     file_headers_.push_back(header);
-    auto buffer = new zip_streambuf_compress(&file_headers_.back(), destination_stream_);
+
+    // without a pool the local header is written as soon as the streambuf is created
+    written_.push_back(pool_ == nullptr);
+
+    if (pool_)
+    {
+        return std::unique_ptr<std::streambuf>(new deferred_zip_streambuf(*this, file_headers_.size() - 1));
+    }
+
+    auto buffer = new zip_streambuf_compress(&file_headers_.back(), destination_stream_, options_);
 
     return std::unique_ptr<zip_streambuf_compress>(buffer);
 }
 
+void ozstream::flush()
+{
+    if (pool_)
+    {
+        write_pending(true);
+    }
+}
+
+void ozstream::deflate_file(std::size_t header_index, std::vector<std::uint8_t> &&data)
+{
+    auto entry = std::make_shared<deflate_entry>();
+    entry->header_index = header_index;
+    entry->data = std::move(data);
+
+    // stored entries are written straight from data so only the CRC is computed
+    const auto block_count = options_.store_only ? std::size_t(0) : std::max(std::size_t(1),
+        (entry->data.size() + parallel_block_size - 1) / parallel_block_size);
+    entry->blocks.resize(block_count);
+    entry->remaining_tasks = block_count + 1;
+
+    pending_.push_back(entry);
+
+    pool_->submit([entry]() {
+        entry->crc = static_cast<std::uint32_t>(crc32(0, entry->data.data(), entry->data.size()));
+        entry->finish_task(nullptr);
+    });
+
+    const auto &options = options_;
+
+    for (std::size_t block_index = 0; block_index < block_count; ++block_index)
+    {
+        pool_->submit([entry, block_index, &options]() {
+            std::exception_ptr error;
+
+            try
+            {
+                deflate_block(*entry, block_index, options);
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+
+            entry->finish_task(error);
+        });
+    }
+
+    // write whatever is already done so that finished entries don't pile up in memory
+    write_pending(false);
+}
+
+void ozstream::write_pending(bool wait)
+{
+    while (!pending_.empty())
+    {
+        auto entry = pending_.front();
+
+        {
+            std::unique_lock<std::mutex> lock(entry->mutex);
+
+            // errors are only reported by flush since this may be called from a destructor
+            if (!wait && (entry->remaining_tasks != 0 || entry->error)) return;
+
+            entry->done.wait(lock, [&entry]() { return entry->remaining_tasks == 0; });
+        }
+
+        pending_.pop_front();
+
+        if (entry->error)
+        {
+            std::rethrow_exception(entry->error);
+        }
+
+        auto &header = file_headers_[entry->header_index];
+        header.crc = entry->crc;
+        header.uncompressed_size = static_cast<std::uint64_t>(entry->data.size());
+        header.compressed_size = 0;
+
+        for (const auto &block : entry->blocks)
+        {
+            header.compressed_size += static_cast<std::uint64_t>(block.size());
+        }
+
+        if (options_.store_only)
+        {
+            header.compression_type = 0;
+            header.compressed_size = header.uncompressed_size;
+        }
+
+        // the extra field is reserved as in zip_streambuf_compress so that
+        // archives don't depend on the number of compression threads
+        header.header_offset = static_cast<std::uint64_t>(destination_stream_.tellp());
+        write_header(header, destination_stream_, false, true);
+
+        if (options_.store_only)
+        {
+            destination_stream_.write(reinterpret_cast<const char *>(entry->data.data()),
+                static_cast<std::streamsize>(entry->data.size()));
+        }
+
+        for (const auto &block : entry->blocks)
+        {
+            destination_stream_.write(reinterpret_cast<const char *>(block.data()),
+                static_cast<std::streamsize>(block.size()));
+        }
+
+        written_[entry->header_index] = true;
+    }
+}
+
+// The most bytes a z_stream can be given to read or write at once.
+static const std::uint64_t max_zlib_chunk_size = std::numeric_limits<unsigned int>::max();
+
+/// <summary>
+/// Decompresses the entry described by header from data, the bytes following
+/// its local header, into destination in a single pass unless it is larger
+/// than a z_stream can take at once.
+/// </summary>
+std::size_t read_from_memory(const zheader &header, const std::uint8_t *data, std::uint8_t *destination)
+{
+    if (header.compression_type == 0)
+    {
+        std::memcpy(destination, data, static_cast<std::size_t>(header.uncompressed_size));
+
+        return static_cast<std::size_t>(header.uncompressed_size);
+    }
+
+    if (header.compression_type != 8)
+    {
+        throw xlnt::exception("unsupported compression type, should be DEFLATE or uncompressed");
+    }
+
+    z_stream strm;
+    strm.zalloc = nullptr;
+    strm.zfree = nullptr;
+    strm.opaque = nullptr;
+    strm.next_in = data;
+    strm.avail_in = 0;
+    strm.next_out = destination;
+    strm.avail_out = 0;
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+    if (inflateInit2(&strm, -MAX_WBITS) != Z_OK)
+#pragma clang diagnostic pop
+    {
+        throw xlnt::exception("couldn't inflate ZIP, possibly corrupted");
+    }
+
+    // when all of the input and output is available at once miniz can
+    // decompress straight into destination
+    auto remaining_in = header.compressed_size;
+    auto remaining_out = header.uncompressed_size;
+    int ret = Z_OK;
+
+    while (ret == Z_OK)
+    {
+        if (strm.avail_in == 0 && remaining_in != 0)
+        {
+            strm.avail_in = static_cast<unsigned int>(std::min(remaining_in, max_zlib_chunk_size));
+            remaining_in -= strm.avail_in;
+        }
+
+        if (strm.avail_out == 0 && remaining_out != 0)
+        {
+            strm.avail_out = static_cast<unsigned int>(std::min(remaining_out, max_zlib_chunk_size));
+            remaining_out -= strm.avail_out;
+        }
+
+        ret = inflate(&strm, remaining_in == 0 && remaining_out == 0 ? Z_FINISH : Z_NO_FLUSH);
+    }
+
+    const auto written = static_cast<std::size_t>(strm.next_out - destination);
+    inflateEnd(&strm);
+
+    if (ret != Z_STREAM_END && written != header.uncompressed_size)
+    {
+        throw xlnt::exception("couldn't inflate ZIP, possibly corrupted");
+    }
+
+    return written;
+}
+
 izstream::izstream(std::istream &stream)
-    : source_stream_(stream)
+    : izstream(stream, 0)
+{
+}
+
+izstream::izstream(std::istream &stream, std::size_t buffer_size)
+    : data_(nullptr),
+      data_size_(0),
+      source_stream_(stream),
+      buffer_size_(buffer_size)
 {
     if (!stream)
     {
@@ -498,6 +1296,23 @@ izstream::izstream(std::istream &stream)
     read_central_header();
 }
 
+izstream::izstream(const std::uint8_t *data, std::size_t size, std::size_t buffer_size)
+    : data_(data),
+      data_size_(size),
+      data_buffer_(new memory_istreambuf(data, size)),
+      data_stream_(new std::istream(data_buffer_.get())),
+      source_stream_(*data_stream_),
+      buffer_size_(buffer_size)
+{
+    read_central_header();
+}
+
+izstream::izstream(std::shared_ptr<const mapped_file> mapping, std::size_t buffer_size)
+    : izstream(mapping->data(), mapping->size(), buffer_size)
+{
+    mapping_ = std::move(mapping);
+}
+
 izstream::~izstream()
 {
 }
@@ -538,7 +1353,8 @@ bool izstream::read_central_header()
     auto found_header = false;
     std::size_t header_index = 0;
 
-    for (std::size_t i = 0; i < static_cast<std::size_t>(read_start - 3); ++i)
+    // search backwards since the tail of a large central directory is also in buf
+    for (auto i = static_cast<std::size_t>(read_start - 3); i-- > 0;)
     {
         if (buf[i] == 0x50 && buf[i + 1] == 0x4b && buf[i + 2] == 0x05 && buf[i + 3] == 0x06)
         {
@@ -565,8 +1381,8 @@ bool izstream::read_central_header()
         throw xlnt::exception("multiple disk zip files are not supported");
     }
 
-    auto num_files = read_int<std::uint16_t>(source_stream_); // one entry in center in this disk
-    auto num_files_this_disk = read_int<std::uint16_t>(source_stream_); // one entry in center
+    std::uint64_t num_files = read_int<std::uint16_t>(source_stream_); // one entry in center in this disk
+    std::uint64_t num_files_this_disk = read_int<std::uint16_t>(source_stream_); // one entry in center
 
     if (num_files != num_files_this_disk)
     {
@@ -574,12 +1390,50 @@ bool izstream::read_central_header()
     }
 
     /*auto size_of_header = */ read_int<std::uint32_t>(source_stream_); // size of header
-    auto header_offset = read_int<std::uint32_t>(source_stream_); // offset to header
+    std::uint64_t header_offset = read_int<std::uint32_t>(source_stream_); // offset to header
+
+    // a ZIP64 end of central locator directly before the end of central
+    // points to the record with the real values
+    const auto end_of_central = static_cast<std::uint64_t>(end_position - (read_start - static_cast<std::ptrdiff_t>(header_index)));
+    const auto locator_size = std::uint64_t(20);
+
+    if (end_of_central >= locator_size)
+    {
+        source_stream_.seekg(static_cast<std::streamoff>(end_of_central - locator_size));
+
+        if (read_int<std::uint32_t>(source_stream_) == 0x07064b50)
+        {
+            /*auto zip64_disk = */ read_int<std::uint32_t>(source_stream_);
+            const auto zip64_end_of_central = read_int<std::uint64_t>(source_stream_);
+            source_stream_.seekg(static_cast<std::streamoff>(zip64_end_of_central));
+
+            if (read_int<std::uint32_t>(source_stream_) != 0x06064b50)
+            {
+                throw xlnt::exception("missing ZIP64 end of central directory signature");
+            }
+
+            /*auto record_size = */ read_int<std::uint64_t>(source_stream_);
+            /*auto version_made_by = */ read_int<std::uint16_t>(source_stream_);
+            /*auto version_needed = */ read_int<std::uint16_t>(source_stream_);
+            const auto zip64_disk_number1 = read_int<std::uint32_t>(source_stream_);
+            const auto zip64_disk_number2 = read_int<std::uint32_t>(source_stream_);
+            num_files = read_int<std::uint64_t>(source_stream_);
+            num_files_this_disk = read_int<std::uint64_t>(source_stream_);
+
+            if (zip64_disk_number1 != zip64_disk_number2 || zip64_disk_number1 != 0 || num_files != num_files_this_disk)
+            {
+                throw xlnt::exception("multiple disk zip files are not supported");
+            }
+
+            /*auto size_of_header = */ read_int<std::uint64_t>(source_stream_);
+            header_offset = read_int<std::uint64_t>(source_stream_);
+        }
+    }
 
     // go to header and read all file headers
-    source_stream_.seekg(header_offset);
+    source_stream_.seekg(static_cast<std::streamoff>(header_offset));
 
-    for (std::uint16_t i = 0; i < num_files; ++i)
+    for (std::uint64_t i = 0; i < num_files; ++i)
     {
         auto header = read_header(source_stream_, true);
         file_headers_[header.filename] = header;
@@ -596,19 +1450,233 @@ std::unique_ptr<std::streambuf> izstream::open(const path &filename) const
     }
 
     auto header = file_headers_.at(filename.string());
-    source_stream_.seekg(header.header_offset);
-    auto buffer = new zip_streambuf_decompress(source_stream_, header);
+
+    if (data_ != nullptr)
+    {
+        const auto data = entry_data(header);
+
+        if (header.compression_type == 0)
+        {
+            return std::unique_ptr<std::streambuf>(new memory_istreambuf(data, static_cast<std::size_t>(header.uncompressed_size)));
+        }
+
+        return std::unique_ptr<std::streambuf>(new zip_streambuf_decompress(data, header, buffer_size_));
+    }
+
+    source_stream_.seekg(static_cast<std::streamoff>(header.header_offset));
+    auto buffer = new zip_streambuf_decompress(source_stream_, header, buffer_size_);
 
     return std::unique_ptr<zip_streambuf_decompress>(buffer);
 }
 
+std::unique_ptr<std::streambuf> izstream::open_detached(const path &filename) const
+{
+    if (!has_file(filename))
+    {
+        throw xlnt::exception("file not found");
+    }
+
+    if (data_ != nullptr)
+    {
+        // entries in memory never share any state
+        return open(filename);
+    }
+
+    const auto &header = file_headers_.at(filename.string());
+    std::vector<std::uint8_t> bytes;
+
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+
+        // the local header's name and extra field lengths can differ from the central ones
+        source_stream_.seekg(static_cast<std::streamoff>(header.header_offset + 26));
+        const auto filename_length = read_int<std::uint16_t>(source_stream_);
+        const auto extra_length = read_int<std::uint16_t>(source_stream_);
+        const auto entry_size = static_cast<std::size_t>(30 + filename_length + extra_length + header.compressed_size);
+
+        bytes.resize(entry_size);
+        source_stream_.seekg(static_cast<std::streamoff>(header.header_offset));
+        source_stream_.read(reinterpret_cast<char *>(bytes.data()), static_cast<std::streamsize>(entry_size));
+
+        if (static_cast<std::size_t>(source_stream_.gcount()) != entry_size)
+        {
+            throw xlnt::exception("truncated ZIP entry");
+        }
+    }
+
+    return std::unique_ptr<std::streambuf>(new detached_zip_streambuf(std::move(bytes), header, buffer_size_));
+}
+
 std::string izstream::read(const path &filename) const
 {
-    auto buffer = open(filename);
-    std::istream stream(buffer.get());
-    auto bytes = to_vector(stream);
+    std::string contents(uncompressed_size(filename), '\0');
+
+    if (!contents.empty())
+    {
+        read(filename, reinterpret_cast<std::uint8_t *>(&contents[0]), contents.size());
+    }
+
+    return contents;
+}
+
+std::size_t izstream::read(const path &filename, std::uint8_t *destination, std::size_t size) const
+{
+    if (!has_file(filename))
+    {
+        throw xlnt::exception("file not found");
+    }
+
+    const auto &header = file_headers_.at(filename.string());
+
+    if (size < header.uncompressed_size)
+    {
+        throw xlnt::exception("destination is smaller than the uncompressed file");
+    }
+
+    if (header.uncompressed_size == 0)
+    {
+        return 0;
+    }
+
+    if (data_ != nullptr)
+    {
+        return read_from_memory(header, entry_data(header), destination);
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+
+    source_stream_.seekg(static_cast<std::streamoff>(header.header_offset));
+    read_header(source_stream_, false);
+
+    if (header.compression_type == 0)
+    {
+        source_stream_.read(reinterpret_cast<char *>(destination), static_cast<std::streamsize>(header.uncompressed_size));
+
+        if (source_stream_.gcount() != static_cast<std::streamsize>(header.uncompressed_size))
+        {
+            throw xlnt::exception("truncated ZIP entry");
+        }
+
+        return static_cast<std::size_t>(header.uncompressed_size);
+    }
+
+    if (header.compression_type != 8)
+    {
+        throw xlnt::exception("unsupported compression type, should be DEFLATE or uncompressed");
+    }
+
+    z_stream strm;
+    strm.zalloc = nullptr;
+    strm.zfree = nullptr;
+    strm.opaque = nullptr;
+    strm.avail_in = 0;
+    strm.next_in = nullptr;
+
+#pragma clang diagnostic push
+#pragma clang diagnostic ignored "-Wold-style-cast"
+    if (inflateInit2(&strm, -MAX_WBITS) != Z_OK)
+#pragma clang diagnostic pop
+    {
+        throw xlnt::exception("couldn't inflate ZIP, possibly corrupted");
+    }
+
+    // Only the compressed input is buffered. When all of it fits in one
+    // buffer, inflating with Z_FINISH lets miniz decompress straight into
+    // destination instead of going through its internal window.
+    auto remaining = static_cast<std::size_t>(header.compressed_size);
+    const auto single_pass = buffer_size_ == 0 && remaining <= max_single_pass_size;
+    std::vector<char> in(single_pass ? std::max(remaining, std::size_t(1))
+        : buffer_size_for(header.compressed_size, buffer_size_));
+    const auto flush = single_pass ? Z_FINISH : Z_NO_FLUSH;
+
+    // the output is handed to miniz in chunks a z_stream can count
+    auto remaining_out = header.uncompressed_size;
+    const auto written = [&strm, destination]() { return static_cast<std::uint64_t>(strm.next_out - destination); };
+
+    strm.next_out = destination;
+    strm.avail_out = 0;
+
+    while (written() < header.uncompressed_size)
+    {
+        if (strm.avail_out == 0)
+        {
+            strm.avail_out = static_cast<unsigned int>(std::min(remaining_out, max_zlib_chunk_size));
+            remaining_out -= strm.avail_out;
+        }
+
+        if (strm.avail_in == 0 && remaining != 0)
+        {
+            source_stream_.read(in.data(), static_cast<std::streamsize>(std::min(in.size(), remaining)));
+            strm.avail_in = static_cast<unsigned int>(source_stream_.gcount());
+            strm.next_in = reinterpret_cast<Bytef *>(in.data());
+            remaining -= strm.avail_in;
+        }
+
+        const auto ret = inflate(&strm, flush);
+
+        if (ret == Z_STREAM_END || written() == header.uncompressed_size) break;
+
+        if (ret != Z_OK || (strm.avail_in == 0 && remaining == 0))
+        {
+            inflateEnd(&strm);
+            throw xlnt::exception("couldn't inflate ZIP, possibly corrupted");
+        }
+    }
+
+    inflateEnd(&strm);
+
+    return static_cast<std::size_t>(written());
+}
+
+std::size_t izstream::uncompressed_size(const path &filename) const
+{
+    if (!has_file(filename))
+    {
+        throw xlnt::exception("file not found");
+    }
+
+    return static_cast<std::size_t>(file_headers_.at(filename.string()).uncompressed_size);
+}
+
+const std::uint8_t *izstream::stored_data(const path &filename) const
+{
+    if (!has_file(filename))
+    {
+        throw xlnt::exception("file not found");
+    }
+
+    const auto &header = file_headers_.at(filename.string());
+
+    if (data_ == nullptr || header.compression_type != 0)
+    {
+        return nullptr;
+    }
+
+    return entry_data(header);
+}
+
+const std::uint8_t *izstream::entry_data(const zheader &header) const
+{
+    const auto local_header_size = std::size_t(30);
+
+    if (header.header_offset + local_header_size > data_size_)
+    {
+        throw xlnt::exception("truncated ZIP entry");
+    }
+
+    // the local header's name and extra field lengths can differ from the central ones
+    const auto lengths = data_ + header.header_offset + 26;
+    const auto filename_length = static_cast<std::size_t>(lengths[0] | (lengths[1] << 8));
+    const auto extra_length = static_cast<std::size_t>(lengths[2] | (lengths[3] << 8));
+    const auto offset = header.header_offset + local_header_size + filename_length + extra_length;
+    const auto size = header.compression_type == 0 ? header.uncompressed_size : header.compressed_size;
+
+    if (offset + size > data_size_)
+    {
+        throw xlnt::exception("truncated ZIP entry");
+    }
 
-    return std::string(bytes.begin(), bytes.end());
+    return data_ + offset;
 }
 
 std::vector<path> izstream::files() const
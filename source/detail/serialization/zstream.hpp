@@ -35,19 +35,27 @@ OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
 
 #pragma once
 
+#include <deque>
 #include <iostream>
 #include <memory>
+#include <mutex>
 #include <unordered_map>
 #include <vector>
 
 #include <xlnt/xlnt_config.hpp>
 #include <xlnt/utils/path.hpp>
+#include <xlnt/workbook/save_options.hpp>
 
 //TODO: don't export these classes (some tests are using them for now)
 
 namespace xlnt {
 namespace detail {
 
+class deferred_zip_streambuf;
+class deflate_pool;
+class mapped_file;
+struct deflate_entry;
+
 /// <summary>
 /// A structure representing the header that occurs before each compressed file in a ZIP
 /// archive and again at the end of the file with more information.
@@ -60,17 +68,18 @@ struct XLNT_API zheader
     std::uint16_t stamp_date = 0;
     std::uint16_t stamp_time = 0;
     std::uint32_t crc = 0;
-    std::uint32_t compressed_size = 0;
-    std::uint32_t uncompressed_size = 0;
+    std::uint64_t compressed_size = 0;
+    std::uint64_t uncompressed_size = 0;
     std::string filename;
     std::string comment;
     std::vector<std::uint8_t> extra;
-    std::uint32_t header_offset = 0;
+    std::uint64_t header_offset = 0;
 };
 
 /// <summary>
 /// Writes a series of uncompressed binary file data as ostreams into another ostream
-/// according to the ZIP format.
+/// according to the ZIP format. ZIP64 records are written for the entries and the
+/// central directory only where sizes, offsets or the number of entries require them.
 /// </summary>
 class XLNT_API ozstream
 {
@@ -81,23 +90,72 @@ public:
     ozstream(std::ostream &stream);
 
     /// <summary>
-    /// Destructor.
+    /// Construct a new zip_file_writer which writes a ZIP archive to the given stream
+    /// as described by options.
+    /// </summary>
+    ozstream(std::ostream &stream, const save_options &options);
+
+    /// <summary>
+    /// Destructor. Writes the central directory. Call flush first to find out
+    /// whether any entry failed to compress since errors can't be reported here.
     /// </summary>
     virtual ~ozstream();
 
     /// <summary>
     /// Returns a pointer to a streambuf which compresses the data it receives.
+    /// When compressing in parallel, the data is only compressed once the
+    /// streambuf is destroyed.
     /// </summary>
     std::unique_ptr<std::streambuf> open(const path &file);
 
+    /// <summary>
+    /// Waits for all closed files which are being compressed in the background
+    /// and writes them to the destination stream. Throws if one of them couldn't
+    /// be compressed. Does nothing when not compressing in parallel.
+    /// </summary>
+    void flush();
+
 private:
+    friend class deferred_zip_streambuf;
+
+    /// <summary>
+    /// Queues the uncompressed contents of the file with the given header index
+    /// for compression on the pool.
+    /// </summary>
+    void deflate_file(std::size_t header_index, std::vector<std::uint8_t> &&data);
+
+    /// <summary>
+    /// Writes the compressed files at the front of pending_ to the destination
+    /// stream in the order they were opened. If wait is false, stops at the
+    /// first one which isn't finished yet.
+    /// </summary>
+    void write_pending(bool wait);
+
     std::vector<zheader> file_headers_;
+
+    /// <summary>
+    /// Whether the local header and data of each entry in file_headers_ have been
+    /// written. Entries which failed to compress are left out of the central directory.
+    /// </summary>
+    std::vector<bool> written_;
+
     std::ostream &destination_stream_;
+    save_options options_;
+
+    /// <summary>
+    /// Worker threads used when options.compression_threads isn't 1, otherwise null.
+    /// </summary>
+    std::unique_ptr<deflate_pool> pool_;
+
+    /// <summary>
+    /// Files which have been closed but not yet written, in the order they were opened.
+    /// </summary>
+    std::deque<std::shared_ptr<deflate_entry>> pending_;
 };
 
 /// <summary>
 /// Reads an archive containing a number of files from an istream and allows them
-/// to be decompressed into an istream.
+/// to be decompressed into an istream. ZIP64 archives are supported.
 /// </summary>
 class XLNT_API izstream
 {
@@ -107,6 +165,27 @@ public:
     /// </summary>
     izstream(std::istream &stream);
 
+    /// <summary>
+    /// Construct a new zip_file_reader which reads a ZIP archive from the given stream
+    /// using buffers of buffer_size bytes. If buffer_size is 0, the buffers are sized
+    /// to match each entry.
+    /// </summary>
+    izstream(std::istream &stream, std::size_t buffer_size);
+
+    /// <summary>
+    /// Construct a new zip_file_reader which reads a ZIP archive directly from the
+    /// size bytes at data without copying them. data must outlive the reader.
+    /// Entries are inflated straight from data and stored entries are available
+    /// in place through stored_data.
+    /// </summary>
+    izstream(const std::uint8_t *data, std::size_t size, std::size_t buffer_size);
+
+    /// <summary>
+    /// Construct a new zip_file_reader which reads a ZIP archive from a file mapped
+    /// into memory. The reader keeps the mapping alive.
+    /// </summary>
+    izstream(std::shared_ptr<const mapped_file> mapping, std::size_t buffer_size);
+
     /// <summary>
     /// Destructor.
     /// </summary>
@@ -117,11 +196,37 @@ public:
     /// </summary>
     std::unique_ptr<std::streambuf> open(const path &file) const;
 
+    /// <summary>
+    /// Copies the compressed bytes of file out of the archive and returns a
+    /// streambuf which decompresses them. Unlike open, the result doesn't share
+    /// the archive stream so several entries can be read on different threads.
+    /// When reading from memory nothing is copied and this is the same as open.
+    /// </summary>
+    std::unique_ptr<std::streambuf> open_detached(const path &file) const;
+
     /// <summary>
     ///
     /// </summary>
     std::string read(const path &file) const;
 
+    /// <summary>
+    /// Inflates file directly into the size bytes at destination without any
+    /// intermediate buffering of the output. size must be at least
+    /// uncompressed_size(file). Returns the number of bytes written.
+    /// </summary>
+    std::size_t read(const path &file, std::uint8_t *destination, std::size_t size) const;
+
+    /// <summary>
+    /// Returns the size of file once it is decompressed.
+    /// </summary>
+    std::size_t uncompressed_size(const path &file) const;
+
+    /// <summary>
+    /// Returns the uncompressed_size(file) bytes of file in place if the archive
+    /// is read from memory and file is stored without compression, otherwise nullptr.
+    /// </summary>
+    const std::uint8_t *stored_data(const path &file) const;
+
     /// <summary>
     ///
     /// </summary>
@@ -138,15 +243,56 @@ private:
     /// </summary>
     bool read_central_header();
 
+    /// <summary>
+    /// Returns the start of the compressed data of the entry described by header
+    /// in memory. Throws if the entry runs past the end of the archive.
+    /// </summary>
+    const std::uint8_t *entry_data(const zheader &header) const;
+
     /// <summary>
     ///
     /// </summary>
     std::unordered_map<std::string, zheader> file_headers_;
 
+    /// <summary>
+    /// The archive in memory or nullptr when reading from a stream.
+    /// </summary>
+    const std::uint8_t *data_;
+
+    /// <summary>
+    /// The size of the archive in memory.
+    /// </summary>
+    std::size_t data_size_;
+
+    /// <summary>
+    /// The mapped file that data_ points into, if any.
+    /// </summary>
+    std::shared_ptr<const mapped_file> mapping_;
+
+    /// <summary>
+    /// Stream over data_ used to read the central directory.
+    /// </summary>
+    std::unique_ptr<std::streambuf> data_buffer_;
+
+    /// <summary>
+    /// Stream over data_buffer_ used to read the central directory.
+    /// </summary>
+    std::unique_ptr<std::istream> data_stream_;
+
     /// <summary>
     ///
     /// </summary>
     std::istream &source_stream_;
+
+    /// <summary>
+    /// The size of the buffers used to read entries or 0 to size them per entry.
+    /// </summary>
+    std::size_t buffer_size_;
+
+    /// <summary>
+    /// Serializes access to source_stream_ from open_detached and read.
+    /// </summary>
+    mutable std::mutex mutex_;
 };
 
 } // namespace detail
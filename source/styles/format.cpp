@@ -36,7 +36,9 @@ format::format(detail::format_impl *d)
 
 void format::clear_style()
 {
+    d_->parent->unindex_format(d_);
     d_->style.clear();
+    d_->parent->reindex_format(d_);
 }
 
 format format::style(const xlnt::style &new_style)
@@ -47,7 +49,10 @@ format format::style(const xlnt::style &new_style)
 
 format format::style(const std::string &new_style)
 {
+    d_->parent->unindex_format(d_);
     d_->style = new_style;
+    d_->parent->reindex_format(d_);
+
     return format(d_);
 }
 
@@ -127,8 +132,14 @@ xlnt::number_format format::number_format() const
         return number_format::from_builtin_id(d_->number_format_id.get());
     }
 
-    return *std::find_if(d_->parent->number_formats.begin(), d_->parent->number_formats.end(),
-        [&](const xlnt::number_format nf) { return nf.id() == d_->number_format_id.get(); });
+    const auto match = d_->parent->find_number_format(d_->number_format_id.get());
+
+    if (match == nullptr)
+    {
+        throw invalid_attribute();
+    }
+
+    return *match;
 }
 
 format format::number_format(const xlnt::number_format &new_number_format, bool applied)
@@ -138,7 +149,7 @@ format format::number_format(const xlnt::number_format &new_number_format, bool
     if (!copy.has_id())
     {
         copy.id(d_->parent->next_custom_number_format_id());
-        d_->parent->number_formats.push_back(copy);
+        d_->parent->add_number_format(copy);
     }
 
     d_ = d_->parent->find_or_create_with(d_, copy, applied);
@@ -193,7 +204,9 @@ bool format::pivot_button() const
 
 void format::pivot_button(bool show)
 {
+    d_->parent->unindex_format(d_);
     d_->pivot_button_ = show;
+    d_->parent->reindex_format(d_);
 }
 
 bool format::quote_prefix() const
@@ -203,7 +216,9 @@ bool format::quote_prefix() const
 
 void format::quote_prefix(bool quote)
 {
+    d_->parent->unindex_format(d_);
     d_->quote_prefix_ = quote;
+    d_->parent->reindex_format(d_);
 }
 
 
@@ -24,6 +24,7 @@
 
 #include <algorithm>
 #include <cctype>
+#include <memory>
 #include <unordered_map>
 #include <vector>
 
@@ -253,6 +254,22 @@ number_format::number_format(const std::string &format, std::size_t id)
     format_string(format, id);
 }
 
+number_format::number_format(const number_format &other)
+    : id_(other.id_),
+      format_string_(other.format_string_),
+      program_(std::atomic_load(&other.program_))
+{
+}
+
+number_format &number_format::operator=(const number_format &other)
+{
+    id_ = other.id_;
+    format_string_ = other.format_string_;
+    std::atomic_store(&program_, std::atomic_load(&other.program_));
+
+    return *this;
+}
+
 bool number_format::is_builtin_format(std::size_t builtin_id)
 {
     return builtin_formats().find(builtin_id) != builtin_formats().end();
@@ -276,6 +293,7 @@ std::string number_format::format_string() const
 void number_format::format_string(const std::string &format_string)
 {
     format_string_ = format_string;
+    program_.reset();
     id_ = 0;
 
     for (const auto &pair : builtin_formats())
@@ -291,6 +309,7 @@ void number_format::format_string(const std::string &format_string)
 void number_format::format_string(const std::string &format_string, std::size_t id)
 {
     format_string_ = format_string;
+    program_.reset();
     id_ = id;
 }
 
@@ -314,39 +333,58 @@ std::size_t number_format::id() const
     return id_.get();
 }
 
-bool number_format::is_date_format() const
+std::shared_ptr<const detail::number_format_program> number_format::program() const
 {
-    detail::number_format_parser p(format_string_);
-    p.parse();
-    auto parsed = p.result();
+    auto program = std::atomic_load(&program_);
 
-    bool any_datetime = false;
-    bool any_timedelta = false;
-
-    for (const auto &section : parsed)
+    // threads racing here compile the same program and one of them is kept
+    if (!program)
     {
-        if (section.is_datetime)
-        {
-            any_datetime = true;
-        }
-
-        if (section.is_timedelta)
-        {
-            any_timedelta = true;
-        }
+        program = detail::number_format_program::compile(format_string_);
+        std::atomic_store(&program_, program);
     }
 
-    return any_datetime && !any_timedelta;
+    return program;
+}
+
+bool number_format::is_date_format() const
+{
+    return program()->is_date_format;
+}
+
+bool number_format::is_timedelta_format() const
+{
+    return program()->is_timedelta_format;
 }
 
 std::string number_format::format(const std::string &text) const
 {
-    return detail::number_formatter(format_string_, calendar::windows_1900).format_text(text);
+    return detail::number_formatter(program(), calendar::windows_1900).format_text(text);
 }
 
 std::string number_format::format(double number, calendar base_date) const
 {
-    return detail::number_formatter(format_string_, base_date).format_number(number);
+    std::string output;
+    format(number, base_date, output);
+
+    return output;
+}
+
+void number_format::format(double number, calendar base_date, std::string &output) const
+{
+    detail::number_formatter(program(), base_date).format_number(number, output);
+}
+
+void number_format::format(const std::vector<double> &numbers, calendar base_date, std::vector<std::string> &output) const
+{
+    detail::number_formatter formatter(program(), base_date);
+
+    output.resize(numbers.size());
+
+    for (std::size_t i = 0; i < numbers.size(); ++i)
+    {
+        formatter.format_number(numbers[i], output[i]);
+    }
 }
 
 bool number_format::operator==(const number_format &other) const
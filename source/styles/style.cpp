@@ -32,17 +32,6 @@
 #include <xlnt/styles/protection.hpp>
 #include <xlnt/styles/style.hpp>
 
-namespace {
-
-std::vector<xlnt::number_format>::iterator find_number_format(
-	std::vector<xlnt::number_format> &number_formats, std::size_t id)
-{
-	return std::find_if(number_formats.begin(), number_formats.end(),
-		[=](const xlnt::number_format &nf) { return nf.id() == id; });
-}
-
-} // namespace
-
 namespace xlnt {
 
 style::style(detail::style_impl *d)
@@ -161,10 +150,9 @@ style style::font(const xlnt::font &new_font, bool applied)
 
 xlnt::number_format style::number_format() const
 {
-	auto match = find_number_format(d_->parent->number_formats, 
-		d_->number_format_id.get());
+	auto match = d_->parent->find_number_format(d_->number_format_id.get());
 
-	if (match == d_->parent->number_formats.end())
+	if (match == nullptr)
 	{
 		throw invalid_attribute();
 	}
@@ -184,12 +172,11 @@ style style::number_format(const xlnt::number_format &new_number_format, bool ap
     if (!copy.has_id())
     {
         copy.id(d_->parent->next_custom_number_format_id());
-        d_->parent->number_formats.push_back(copy);
+        d_->parent->add_number_format(copy);
     }
-	else if (find_number_format(d_->parent->number_formats, copy.id()) 
-		== d_->parent->number_formats.end())
+	else if (d_->parent->find_number_format(copy.id()) == nullptr)
 	{
-        d_->parent->number_formats.push_back(copy);
+        d_->parent->add_number_format(copy);
     }
 
     d_->number_format_id = copy.id();
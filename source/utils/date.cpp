@@ -23,6 +23,7 @@
 #include <cmath>
 #include <ctime>
 
+#include <detail/serial_date.hpp>
 #include <xlnt/utils/date.hpp>
 
 namespace {
@@ -54,34 +55,89 @@ date date::from_number(int days_since_base_year, calendar base_date)
 
     if (base_date == calendar::mac_1904)
     {
-        days_since_base_year += 1462;
+        days_since_base_year += detail::mac_1904_offset;
     }
 
-    if (days_since_base_year == 60)
+    detail::date_from_serial(days_since_base_year, result.year, result.month, result.day);
+
+    return result;
+}
+
+void date::from_numbers(const std::vector<double> &numbers, calendar base_date, std::vector<date> &dates)
+{
+    const auto offset = base_date == calendar::mac_1904 ? detail::mac_1904_offset : 0;
+    const auto count = numbers.size();
+
+    dates.resize(count, date(0, 0, 0));
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto &result = dates[i];
+        detail::date_from_serial(static_cast<int>(numbers[i]) + offset, result.year, result.month, result.day);
+    }
+}
+
+void date::to_numbers(const std::vector<date> &dates, calendar base_date, std::vector<double> &numbers)
+{
+    const auto offset = base_date == calendar::mac_1904 ? detail::mac_1904_offset : 0;
+    const auto count = dates.size();
+
+    numbers.resize(count);
+
+    for (std::size_t i = 0; i < count; ++i)
     {
-        result.day = 29;
-        result.month = 2;
-        result.year = 1900;
+        const auto &d = dates[i];
+        numbers[i] = detail::serial_from_date(d.year, d.month, d.day, offset);
+    }
+}
+
+void date::unix_days_from_numbers(const std::vector<double> &numbers, calendar base_date,
+    std::vector<std::int32_t> &days)
+{
+    const auto count = numbers.size();
+    days.resize(count);
+
+    if (base_date == calendar::mac_1904)
+    {
+        const auto epoch = detail::unix_epoch_1900 - detail::mac_1904_offset;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            days[i] = static_cast<std::int32_t>(std::floor(numbers[i])) - epoch;
+        }
 
-        return result;
+        return;
     }
-    else if (days_since_base_year < 60)
+
+    for (std::size_t i = 0; i < count; ++i)
     {
-        days_since_base_year++;
+        const auto serial = static_cast<std::int64_t>(std::floor(numbers[i]));
+        days[i] = static_cast<std::int32_t>(detail::unix_day_from_serial(serial));
     }
+}
 
-    int l = days_since_base_year + 68569 + 2415019;
-    int n = int((4 * l) / 146097);
-    l = l - int((146097 * n + 3) / 4);
-    int i = int((4000 * (l + 1)) / 1461001);
-    l = l - int((1461 * i) / 4) + 31;
-    int j = int((80 * l) / 2447);
-    result.day = l - int((2447 * j) / 80);
-    l = int(j / 11);
-    result.month = j + 2 - (12 * l);
-    result.year = 100 * (n - 49) + i + l;
+void date::numbers_from_unix_days(const std::vector<std::int32_t> &days, calendar base_date,
+    std::vector<double> &numbers)
+{
+    const auto count = days.size();
+    numbers.resize(count);
 
-    return result;
+    if (base_date == calendar::mac_1904)
+    {
+        const auto epoch = detail::unix_epoch_1900 - detail::mac_1904_offset;
+
+        for (std::size_t i = 0; i < count; ++i)
+        {
+            numbers[i] = days[i] + epoch;
+        }
+
+        return;
+    }
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        numbers[i] = static_cast<double>(detail::serial_from_unix_day(days[i]));
+    }
 }
 
 bool date::operator==(const date &comparand) const
@@ -96,26 +152,9 @@ bool date::operator!=(const date &comparand) const
 
 int date::to_number(calendar base_date) const
 {
-    if (day == 29 && month == 2 && year == 1900)
-    {
-        return 60;
-    }
-
-    int days_since_1900 = int((1461 * (year + 4800 + int((month - 14) / 12))) / 4)
-        + int((367 * (month - 2 - 12 * ((month - 14) / 12))) / 12)
-        - int((3 * (int((year + 4900 + int((month - 14) / 12)) / 100))) / 4) + day - 2415019 - 32075;
-
-    if (days_since_1900 <= 60)
-    {
-        days_since_1900--;
-    }
-
-    if (base_date == calendar::mac_1904)
-    {
-        return days_since_1900 - 1462;
-    }
+    const auto offset = base_date == calendar::mac_1904 ? detail::mac_1904_offset : 0;
 
-    return days_since_1900;
+    return detail::serial_from_date(year, month, day, offset);
 }
 
 date date::today()
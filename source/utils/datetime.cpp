@@ -23,6 +23,7 @@
 #include <cmath>
 #include <ctime>
 
+#include <detail/serial_date.hpp>
 #include <xlnt/utils/date.hpp>
 #include <xlnt/utils/datetime.hpp>
 #include <xlnt/utils/time.hpp>
@@ -52,6 +53,85 @@ datetime datetime::from_number(double raw_time, calendar base_date)
         time_part.microsecond);
 }
 
+void datetime::from_numbers(const std::vector<double> &numbers, calendar base_date,
+    std::vector<datetime> &datetimes)
+{
+    const auto offset = base_date == calendar::mac_1904 ? detail::mac_1904_offset : 0;
+    const auto count = numbers.size();
+
+    datetimes.resize(count, datetime(0, 0, 0));
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        auto &result = datetimes[i];
+        detail::date_from_serial(static_cast<int>(numbers[i]) + offset, result.year, result.month, result.day);
+        detail::time_from_fraction(numbers[i], result.hour, result.minute, result.second, result.microsecond);
+    }
+}
+
+void datetime::to_numbers(const std::vector<datetime> &datetimes, calendar base_date,
+    std::vector<double> &numbers)
+{
+    const auto offset = base_date == calendar::mac_1904 ? detail::mac_1904_offset : 0;
+    const auto count = datetimes.size();
+
+    numbers.resize(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto &dt = datetimes[i];
+        numbers[i] = detail::serial_from_date(dt.year, dt.month, dt.day, offset)
+            + detail::fraction_from_time(dt.hour, dt.minute, dt.second, dt.microsecond);
+    }
+}
+
+void datetime::unix_microseconds_from_numbers(const std::vector<double> &numbers, calendar base_date,
+    std::vector<std::int64_t> &microseconds)
+{
+    const auto mac = base_date == calendar::mac_1904;
+    const auto microseconds_per_day = static_cast<double>(detail::microseconds_per_day);
+    const auto count = numbers.size();
+
+    microseconds.resize(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        const auto whole_days = std::floor(numbers[i]);
+        const auto serial = static_cast<std::int64_t>(whole_days) + (mac ? detail::mac_1904_offset : 0);
+        const auto fraction = (numbers[i] - whole_days) * microseconds_per_day + 0.5;
+
+        // the leap year bug doesn't apply to days that only exist in the 1904 system
+        const auto day = mac ? serial - detail::unix_epoch_1900 : detail::unix_day_from_serial(serial);
+
+        microseconds[i] = day * detail::microseconds_per_day + static_cast<std::int64_t>(fraction);
+    }
+}
+
+void datetime::numbers_from_unix_microseconds(const std::vector<std::int64_t> &microseconds,
+    calendar base_date, std::vector<double> &numbers)
+{
+    const auto mac = base_date == calendar::mac_1904;
+    const auto microseconds_per_day = static_cast<double>(detail::microseconds_per_day);
+    const auto count = microseconds.size();
+
+    numbers.resize(count);
+
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        // floored division so that times before the epoch keep a positive time of day
+        auto day = microseconds[i] / detail::microseconds_per_day;
+        auto remainder = microseconds[i] % detail::microseconds_per_day;
+        const auto negative = static_cast<std::int64_t>(remainder < 0);
+        day -= negative;
+        remainder += negative * detail::microseconds_per_day;
+
+        const auto serial = mac ? day + detail::unix_epoch_1900 - detail::mac_1904_offset
+                                : detail::serial_from_unix_day(day);
+
+        numbers[i] = static_cast<double>(serial) + static_cast<double>(remainder) / microseconds_per_day;
+    }
+}
+
 bool datetime::operator==(const datetime &comparand) const
 {
     return year == comparand.year 
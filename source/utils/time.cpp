@@ -23,6 +23,7 @@
 #include <cmath>
 #include <ctime>
 
+#include <detail/serial_date.hpp>
 #include <xlnt/utils/time.hpp>
 
 namespace {
@@ -46,37 +47,7 @@ namespace xlnt {
 time time::from_number(double raw_time)
 {
     time result;
-
-    double integer_part;
-    double fractional_part = std::modf(static_cast<double>(raw_time), &integer_part);
-
-    fractional_part *= 24;
-    result.hour = static_cast<int>(fractional_part);
-    fractional_part = 60 * (fractional_part - result.hour);
-    result.minute = static_cast<int>(fractional_part);
-    fractional_part = 60 * (fractional_part - result.minute);
-    result.second = static_cast<int>(fractional_part);
-    fractional_part = 1000000 * (fractional_part - result.second);
-    result.microsecond = static_cast<int>(fractional_part);
-
-    if (result.microsecond == 999999 && fractional_part - result.microsecond > 0.5)
-    {
-        result.microsecond = 0;
-        result.second += 1;
-
-        if (result.second == 60)
-        {
-            result.second = 0;
-            result.minute += 1;
-
-            // TODO: too much nesting
-            if (result.minute == 60)
-            {
-                result.minute = 0;
-                result.hour += 1;
-            }
-        }
-    }
+    detail::time_from_fraction(raw_time, result.hour, result.minute, result.second, result.microsecond);
 
     return result;
 }
@@ -112,16 +83,7 @@ time::time(const std::string &time_string)
 
 double time::to_number() const
 {
-    std::uint64_t microseconds = static_cast<std::uint64_t>(microsecond);
-    microseconds += static_cast<std::uint64_t>(second * 1e6);
-    microseconds += static_cast<std::uint64_t>(minute * 1e6 * 60);
-    auto microseconds_per_hour = static_cast<std::uint64_t>(1e6) * 60 * 60;
-    microseconds += static_cast<std::uint64_t>(hour) * microseconds_per_hour;
-    auto number = microseconds / (24.0 * microseconds_per_hour);
-    auto hundred_billion = static_cast<std::uint64_t>(1e9) * 100;
-    number = std::floor(number * hundred_billion + 0.5) / hundred_billion;
-
-    return number;
+    return detail::fraction_from_time(hour, minute, second, microsecond);
 }
 
 time time::now()
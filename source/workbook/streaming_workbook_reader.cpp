@@ -25,11 +25,17 @@
 
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/serialization/open_stream.hpp>
+#include <detail/serialization/shared_string_arena.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_consumer.hpp>
 #include <xlnt/cell/cell.hpp>
+#include <xlnt/cell/cell_view.hpp>
+#include <xlnt/cell/rich_text.hpp>
 #include <xlnt/packaging/manifest.hpp>
+#include <xlnt/utils/exceptions.hpp>
 #include <xlnt/utils/optional.hpp>
+#include <xlnt/workbook/load_options.hpp>
+#include <xlnt/workbook/read_plan.hpp>
 #include <xlnt/workbook/streaming_workbook_reader.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
@@ -65,6 +71,11 @@ cell streaming_workbook_reader::read_cell()
     return consumer_->read_cell();
 }
 
+void streaming_workbook_reader::visit_cells(const std::function<void(const cell_view &)> &visitor)
+{
+    consumer_->read_cells(visitor);
+}
+
 bool streaming_workbook_reader::has_worksheet(const std::string &name)
 {
     auto titles = sheet_titles();
@@ -72,6 +83,11 @@ bool streaming_workbook_reader::has_worksheet(const std::string &name)
 }
 
 void streaming_workbook_reader::begin_worksheet(const std::string &title)
+{
+    begin_worksheet(title, read_plan());
+}
+
+void streaming_workbook_reader::begin_worksheet(const std::string &title, const read_plan &plan)
 {
     if (!has_worksheet(title))
     {
@@ -109,6 +125,7 @@ void streaming_workbook_reader::begin_worksheet(const std::string &title)
         throw xlnt::exception("sheet not found");
     }
 
+    consumer_->plan(plan);
     consumer_->read_worksheet_begin(worksheet_rel_id_);
 }
 
@@ -147,6 +164,22 @@ void streaming_workbook_reader::open(const xlnt::path &filename)
     open(*stream_);
 }
 
+void streaming_workbook_reader::open(const xlnt::path &filename, const load_options &options)
+{
+    workbook_.reset(new workbook());
+    consumer_.reset(new detail::xlsx_consumer(*workbook_));
+
+    if (options.memory_map)
+    {
+        consumer_->open(filename, options);
+        return;
+    }
+
+    stream_.reset(new std::ifstream());
+    xlnt::detail::open_stream(static_cast<std::ifstream &>(*stream_), filename.string());
+    consumer_->open(*stream_, options);
+}
+
 void streaming_workbook_reader::open(std::istream &stream)
 {
     workbook_.reset(new workbook());
@@ -170,4 +203,28 @@ std::vector<std::string> streaming_workbook_reader::sheet_titles()
     return workbook_->sheet_titles();
 }
 
+rich_text streaming_workbook_reader::shared_string(std::size_t index)
+{
+    const auto &arena = workbook_->d_->shared_string_arena_;
+
+    if (!arena)
+    {
+        throw invalid_parameter();
+    }
+
+    return arena->at(index);
+}
+
+std::string streaming_workbook_reader::shared_string_text(std::size_t index)
+{
+    const auto &arena = workbook_->d_->shared_string_arena_;
+
+    if (!arena)
+    {
+        throw invalid_parameter();
+    }
+
+    return arena->text(index);
+}
+
 } // namespace xlnt
@@ -23,14 +23,14 @@
 
 #include <fstream>
 
-#include <detail/implementations/cell_impl.hpp>
-#include <detail/implementations/worksheet_impl.hpp>
 #include <detail/serialization/open_stream.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/xlsx_producer.hpp>
 #include <xlnt/cell/cell.hpp>
 #include <xlnt/packaging/manifest.hpp>
+#include <xlnt/styles/format.hpp>
 #include <xlnt/utils/optional.hpp>
+#include <xlnt/workbook/save_options.hpp>
 #include <xlnt/workbook/streaming_workbook_writer.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/worksheet/worksheet.hpp>
@@ -44,15 +44,27 @@ streaming_workbook_writer::streaming_workbook_writer()
 
 streaming_workbook_writer::~streaming_workbook_writer()
 {
-    close();
+    // a destructor can't report errors so they are only seen by calling close
+    try
+    {
+        close();
+    }
+    catch (...)
+    {
+    }
 }
 
 void streaming_workbook_writer::close()
 {
     if (producer_)
     {
-        producer_.reset(nullptr);
-        stream_buffer_.reset(nullptr);
+        // the writer is closed even if finishing the workbook throws, the
+        // producer being destroyed before the stream it writes to
+        std::unique_ptr<std::streambuf> stream_buffer(std::move(stream_buffer_));
+        std::unique_ptr<std::ostream> stream(std::move(stream_));
+        std::unique_ptr<detail::xlsx_producer> producer(std::move(producer_));
+
+        producer->close();
     }
 }
 
@@ -61,6 +73,36 @@ cell streaming_workbook_writer::add_cell(const cell_reference &ref)
     return producer_->add_cell(ref);
 }
 
+void streaming_workbook_writer::add_number(const cell_reference &ref, double value, std::size_t format_id)
+{
+    producer_->add_number_cell(ref, format_id, value);
+}
+
+void streaming_workbook_writer::add_string(const cell_reference &ref, const std::string &value, std::size_t format_id)
+{
+    producer_->add_string_cell(ref, format_id, value);
+}
+
+void streaming_workbook_writer::add_boolean(const cell_reference &ref, bool value, std::size_t format_id)
+{
+    producer_->add_boolean_cell(ref, format_id, value);
+}
+
+void streaming_workbook_writer::add_formula(const cell_reference &ref, const std::string &formula, std::size_t format_id)
+{
+    producer_->add_formula_cell(ref, format_id, formula);
+}
+
+format streaming_workbook_writer::create_format()
+{
+    return workbook_->create_format();
+}
+
+std::size_t streaming_workbook_writer::register_format(const format &format)
+{
+    return producer_->format_id(format);
+}
+
 worksheet streaming_workbook_writer::add_worksheet(const std::string &title)
 {
     return producer_->add_worksheet(title);
@@ -68,16 +110,12 @@ worksheet streaming_workbook_writer::add_worksheet(const std::string &title)
 
 void streaming_workbook_writer::open(std::vector<std::uint8_t> &data)
 {
-    stream_buffer_.reset(new detail::vector_ostreambuf(data));
-    stream_.reset(new std::ostream(stream_buffer_.get()));
-    open(*stream_);
+    open(data, save_options());
 }
 
 void streaming_workbook_writer::open(const std::string &filename)
 {
-    stream_.reset(new std::ofstream());
-    xlnt::detail::open_stream(static_cast<std::ofstream &>(*stream_), filename);
-    open(*stream_);
+    open(filename, save_options());
 }
 
 #ifdef _MSC_VER
@@ -90,20 +128,41 @@ void streaming_workbook_writer::open(const std::wstring &filename)
 #endif
 
 void streaming_workbook_writer::open(const xlnt::path &filename)
+{
+    open(filename, save_options());
+}
+
+void streaming_workbook_writer::open(std::ostream &stream)
+{
+    open(stream, save_options());
+}
+
+void streaming_workbook_writer::open(std::vector<std::uint8_t> &data, const save_options &options)
+{
+    stream_buffer_.reset(new detail::vector_ostreambuf(data));
+    stream_.reset(new std::ostream(stream_buffer_.get()));
+    open(*stream_, options);
+}
+
+void streaming_workbook_writer::open(const std::string &filename, const save_options &options)
+{
+    stream_.reset(new std::ofstream());
+    xlnt::detail::open_stream(static_cast<std::ofstream &>(*stream_), filename);
+    open(*stream_, options);
+}
+
+void streaming_workbook_writer::open(const xlnt::path &filename, const save_options &options)
 {
     stream_.reset(new std::ofstream());
     xlnt::detail::open_stream(static_cast<std::ofstream &>(*stream_), filename.string());
-    open(*stream_);
+    open(*stream_, options);
 }
 
-void streaming_workbook_writer::open(std::ostream &stream)
+void streaming_workbook_writer::open(std::ostream &stream, const save_options &options)
 {
     workbook_.reset(new workbook());
     producer_.reset(new detail::xlsx_producer(*workbook_));
-    producer_->open(stream);
-    producer_->current_worksheet_ = new detail::worksheet_impl(workbook_.get(), 1, "Sheet1");
-    producer_->current_cell_ = new detail::cell_impl();
-    producer_->current_cell_->parent_ = producer_->current_worksheet_;
+    producer_->open(stream, options);
 }
 
 } // namespace xlnt
@@ -26,6 +26,7 @@
 #include <array>
 #include <fstream>
 #include <functional>
+#include <mutex>
 #include <set>
 
 #include <detail/constants.hpp>
@@ -33,6 +34,7 @@
 #include <detail/implementations/cell_impl.hpp>
 #include <detail/implementations/workbook_impl.hpp>
 #include <detail/implementations/worksheet_impl.hpp>
+#include <detail/serialization/deferred_parts.hpp>
 #include <detail/serialization/excel_thumbnail.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
 #include <detail/serialization/open_stream.hpp>
@@ -52,8 +54,10 @@
 #include <xlnt/utils/exceptions.hpp>
 #include <xlnt/utils/path.hpp>
 #include <xlnt/utils/variant.hpp>
+#include <xlnt/workbook/load_options.hpp>
 #include <xlnt/workbook/metadata_property.hpp>
 #include <xlnt/workbook/named_range.hpp>
+#include <xlnt/workbook/save_options.hpp>
 #include <xlnt/workbook/theme.hpp>
 #include <xlnt/workbook/workbook.hpp>
 #include <xlnt/workbook/workbook_view.hpp>
@@ -599,6 +603,7 @@ const worksheet workbook::sheet_by_title(const std::string &title) const
     {
         if (impl.title_ == title)
         {
+            read_deferred_sheet(&impl);
             return worksheet(&impl);
         }
     }
@@ -612,6 +617,7 @@ worksheet workbook::sheet_by_title(const std::string &title)
     {
         if (impl.title_ == title)
         {
+            read_deferred_sheet(&impl);
             return worksheet(&impl);
         }
     }
@@ -633,6 +639,8 @@ worksheet workbook::sheet_by_index(std::size_t index)
         ++iter;
     }
 
+    read_deferred_sheet(&*iter);
+
     return worksheet(&*iter);
 }
 
@@ -644,6 +652,8 @@ const worksheet workbook::sheet_by_index(std::size_t index) const
     {
     }
 
+    read_deferred_sheet(&*iter);
+
     return worksheet(&*iter);
 }
 
@@ -653,6 +663,7 @@ worksheet workbook::sheet_by_id(std::size_t id)
     {
         if (impl.id_ == id)
         {
+            read_deferred_sheet(&impl);
             return worksheet(&impl);
         }
     }
@@ -666,6 +677,7 @@ const worksheet workbook::sheet_by_id(std::size_t id) const
     {
         if (impl.id_ == id)
         {
+            read_deferred_sheet(&impl);
             return worksheet(&impl);
         }
     }
@@ -701,9 +713,9 @@ worksheet workbook::create_sheet()
     }
 
     size_t sheet_id = 1;
-    for (const auto ws : *this)
+    for (const auto &impl : d_->worksheets_)
     {
-        sheet_id = std::max(sheet_id, ws.id() + 1);
+        sheet_id = std::max(sheet_id, impl.id_ + 1);
     }
     std::string sheet_filename = "sheet" + std::to_string(sheet_id) + ".xml";
 
@@ -805,13 +817,33 @@ range workbook::named_range(const std::string &name)
 }
 
 void workbook::load(std::istream &stream)
+{
+    load(stream, load_options());
+}
+
+void workbook::load(const std::vector<std::uint8_t> &data)
+{
+    load(data, load_options());
+}
+
+void workbook::load(const std::string &filename)
+{
+    return load(path(filename));
+}
+
+void workbook::load(const path &filename)
+{
+    load(filename, load_options());
+}
+
+void workbook::load(std::istream &stream, const load_options &options)
 {
     clear();
     detail::xlsx_consumer consumer(*this);
-    consumer.read(stream);
+    consumer.read(stream, options);
 }
 
-void workbook::load(const std::vector<std::uint8_t> &data)
+void workbook::load(const std::vector<std::uint8_t> &data, const load_options &options)
 {
     if (data.size() < 22) // the shortest ZIP file is 22 bytes
     {
@@ -820,16 +852,25 @@ void workbook::load(const std::vector<std::uint8_t> &data)
 
     xlnt::detail::vector_istreambuf data_buffer(data);
     std::istream data_stream(&data_buffer);
-    load(data_stream);
+    load(data_stream, options);
 }
 
-void workbook::load(const std::string &filename)
+void workbook::load(const std::string &filename, const load_options &options)
 {
-    return load(path(filename));
+    return load(path(filename), options);
 }
 
-void workbook::load(const path &filename)
+void workbook::load(const path &filename, const load_options &options)
 {
+    if (options.memory_map)
+    {
+        clear();
+        detail::xlsx_consumer consumer(*this);
+        consumer.read(filename, options);
+
+        return;
+    }
+
     std::ifstream file_stream;
     open_stream(file_stream, filename.string());
 
@@ -838,7 +879,7 @@ void workbook::load(const path &filename)
         throw xlnt::exception("file not found " + filename.string());
     }
 
-    load(file_stream);
+    load(file_stream, options);
 }
 
 void workbook::load(const std::string &filename, const std::string &password)
@@ -880,9 +921,7 @@ void workbook::load(std::istream &stream, const std::string &password)
 
 void workbook::save(std::vector<std::uint8_t> &data) const
 {
-    xlnt::detail::vector_ostreambuf data_buffer(data);
-    std::ostream data_stream(&data_buffer);
-    save(data_stream);
+    save(data, save_options());
 }
 
 void workbook::save(std::vector<std::uint8_t> &data, const std::string &password) const
@@ -904,9 +943,7 @@ void workbook::save(const std::string &filename, const std::string &password) co
 
 void workbook::save(const path &filename) const
 {
-    std::ofstream file_stream;
-    open_stream(file_stream, filename.string());
-    save(file_stream);
+    save(filename, save_options());
 }
 
 void workbook::save(const path &filename, const std::string &password) const
@@ -918,16 +955,42 @@ void workbook::save(const path &filename, const std::string &password) const
 
 void workbook::save(std::ostream &stream) const
 {
-    detail::xlsx_producer producer(*this);
-    producer.write(stream);
+    save(stream, save_options());
 }
 
 void workbook::save(std::ostream &stream, const std::string &password) const
 {
+    read_deferred_parts();
     detail::xlsx_producer producer(*this);
     producer.write(stream, password);
 }
 
+void workbook::save(std::vector<std::uint8_t> &data, const save_options &options) const
+{
+    xlnt::detail::vector_ostreambuf data_buffer(data);
+    std::ostream data_stream(&data_buffer);
+    save(data_stream, options);
+}
+
+void workbook::save(const std::string &filename, const save_options &options) const
+{
+    save(path(filename), options);
+}
+
+void workbook::save(const path &filename, const save_options &options) const
+{
+    std::ofstream file_stream;
+    open_stream(file_stream, filename.string());
+    save(file_stream, options);
+}
+
+void workbook::save(std::ostream &stream, const save_options &options) const
+{
+    read_deferred_parts();
+    detail::xlsx_producer producer(*this);
+    producer.write(stream, options);
+}
+
 #ifdef _MSC_VER
 void workbook::save(const std::wstring &filename) const
 {
@@ -975,6 +1038,13 @@ void workbook::remove_sheet(worksheet ws)
     d_->manifest_.unregister_override_type(ws_part);
     auto rel_id_map = d_->manifest_.unregister_relationship(wb_rel.target(), ws_rel_id);
     d_->sheet_title_rel_id_map_.erase(ws.title());
+
+    if (d_->deferred_parts_)
+    {
+        d_->deferred_parts_->worksheets.erase(&*match_iter);
+        d_->deferred_parts_->failed_worksheets.erase(&*match_iter);
+    }
+
     d_->worksheets_.erase(match_iter);
 
     // Shift sheet title->ID mappings down as a result of manifest::unregister_relationship above.
@@ -1058,9 +1128,9 @@ std::vector<std::string> workbook::sheet_titles() const
 {
     std::vector<std::string> names;
 
-    for (auto ws : *this)
+    for (const auto &impl : d_->worksheets_)
     {
-        names.push_back(ws.title());
+        names.push_back(impl.title_);
     }
 
     return names;
@@ -1106,9 +1176,9 @@ void workbook::swap(workbook &right)
 
     if (left.d_ != nullptr)
     {
-        for (auto ws : left)
+        for (auto &impl : left.d_->worksheets_)
         {
-            ws.parent(left);
+            worksheet(&impl).parent(left);
         }
 
         if (left.d_->stylesheet_.is_set())
@@ -1119,9 +1189,9 @@ void workbook::swap(workbook &right)
 
     if (right.d_ != nullptr)
     {
-        for (auto ws : right)
+        for (auto &impl : right.d_->worksheets_)
         {
-            ws.parent(right);
+            worksheet(&impl).parent(right);
         }
 
         if (right.d_->stylesheet_.is_set())
@@ -1148,6 +1218,7 @@ workbook::workbook(workbook &&other)
 workbook::workbook(const workbook &other)
     : workbook()
 {
+    other.read_deferred_parts();
     *d_.get() = *other.d_.get();
 
     for (auto ws : *this)
@@ -1162,6 +1233,28 @@ workbook::~workbook()
 {
 }
 
+void workbook::read_deferred_sheet(detail::worksheet_impl *ws) const
+{
+    std::lock_guard<std::recursive_mutex> lock(d_->deferred_parts_mutex_);
+
+    if (d_->deferred_parts_)
+    {
+        detail::xlsx_consumer consumer(const_cast<workbook &>(*this));
+        consumer.read_deferred_worksheet(ws);
+    }
+}
+
+void workbook::read_deferred_parts() const
+{
+    std::lock_guard<std::recursive_mutex> lock(d_->deferred_parts_mutex_);
+
+    if (d_->deferred_parts_)
+    {
+        detail::xlsx_consumer consumer(const_cast<workbook &>(*this));
+        consumer.read_deferred_parts();
+    }
+}
+
 bool workbook::has_theme() const
 {
     return d_->theme_.is_set();
@@ -1253,6 +1346,10 @@ const manifest &workbook::manifest() const
 
 std::vector<rich_text> &workbook::shared_strings()
 {
+    // the caller may change the table in any way so the index is rebuilt on next use
+    d_->shared_strings_ids_.clear();
+    d_->shared_strings_indexed_ = 0;
+
     return d_->shared_strings_;
 }
 
@@ -1265,32 +1362,38 @@ std::size_t workbook::add_shared_string(const rich_text &shared, bool allow_dupl
 {
     register_workbook_part(relationship_type::shared_string_table);
 
-    auto index = std::size_t(0);
+    auto &strings = d_->shared_strings_;
+    auto &ids = d_->shared_strings_ids_;
+
+    for (auto index = d_->shared_strings_indexed_; index < strings.size(); ++index)
+    {
+        ids.emplace(strings[index], index);
+    }
+
+    d_->shared_strings_indexed_ = strings.size();
 
     if (!allow_duplicates)
     {
-        // TODO: inefficient, use a set or something?
-        for (auto &s : d_->shared_strings_)
-        {
-            if (s == shared)
-            {
-                return index;
-            }
+        auto match = ids.find(shared);
 
-            ++index;
+        if (match != ids.end())
+        {
+            return match->second;
         }
     }
 
-    d_->shared_strings_.push_back(shared);
+    strings.push_back(shared);
+    ids.emplace(shared, strings.size() - 1);
+    d_->shared_strings_indexed_ = strings.size();
 
-    return index;
+    return strings.size() - 1;
 }
 
 bool workbook::contains(const std::string &sheet_title) const
 {
-    for (auto ws : *this)
+    for (const auto &impl : d_->worksheets_)
     {
-        if (ws.title() == sheet_title) return true;
+        if (impl.title_ == sheet_title) return true;
     }
 
     return false;
@@ -1312,6 +1415,16 @@ void workbook::thumbnail(const std::vector<std::uint8_t> &thumbnail,
 
 const std::vector<std::uint8_t> &workbook::thumbnail() const
 {
+    {
+        std::lock_guard<std::recursive_mutex> lock(d_->deferred_parts_mutex_);
+
+        if (d_->deferred_parts_)
+        {
+            detail::xlsx_consumer consumer(const_cast<workbook &>(*this));
+            consumer.read_deferred_images();
+        }
+    }
+
     auto thumbnail_rel = d_->manifest_.relationship(path("/"), relationship_type::thumbnail);
     return d_->images_.at(thumbnail_rel.target().to_string());
 }
@@ -196,32 +196,18 @@ const workbook &worksheet::workbook() const
 
 void worksheet::garbage_collect()
 {
-    auto cell_map_iter = d_->cell_map_.begin();
+    std::vector<cell_reference> collectible;
 
-    while (cell_map_iter != d_->cell_map_.end())
-    {
-        auto cell_iter = cell_map_iter->second.begin();
-
-        while (cell_iter != cell_map_iter->second.end())
+    d_->cell_map_.for_each([&collectible](detail::cell_impl &impl) {
+        if (xlnt::cell(&impl).garbage_collectible())
         {
-            class cell current_cell(&cell_iter->second);
-
-            if (current_cell.garbage_collectible())
-            {
-                cell_iter = cell_map_iter->second.erase(cell_iter);
-                continue;
-            }
-
-            cell_iter++;
+            collectible.push_back(cell_reference(impl.column_, impl.row_));
         }
+    });
 
-        if (cell_map_iter->second.empty())
-        {
-            cell_map_iter = d_->cell_map_.erase(cell_map_iter);
-            continue;
-        }
-
-        cell_map_iter++;
+    for (const auto &reference : collectible)
+    {
+        d_->cell_map_.erase(reference.row(), reference.column_index());
     }
 }
 
@@ -397,25 +383,26 @@ cell_reference worksheet::active_cell() const
 
 cell worksheet::cell(const cell_reference &reference)
 {
-    auto &row = d_->cell_map_[reference.row()];
-    auto match = row.find(reference.column_index());
+    auto match = d_->cell_map_.emplace(reference.row(), reference.column_index());
 
-    if (match == row.end())
+    if (match.second)
     {
-        match = row.emplace(reference.column_index(), detail::cell_impl()).first;
-        auto &impl = match->second;
-
-        impl.parent_ = d_;
-        impl.column_ = reference.column_index();
-        impl.row_ = reference.row();
+        match.first->parent_ = d_;
     }
 
-    return xlnt::cell(&match->second);
+    return xlnt::cell(match.first);
 }
 
 const cell worksheet::cell(const cell_reference &reference) const
 {
-    return xlnt::cell(&d_->cell_map_.at(reference.row()).at(reference.column_index()));
+    auto match = d_->cell_map_.find(reference.row(), reference.column_index());
+
+    if (match == nullptr)
+    {
+        throw std::out_of_range("cell doesn't exist");
+    }
+
+    return xlnt::cell(match);
 }
 
 cell worksheet::cell(xlnt::column_t column, row_t row)
@@ -430,13 +417,7 @@ const cell worksheet::cell(xlnt::column_t column, row_t row) const
 
 bool worksheet::has_cell(const cell_reference &reference) const
 {
-    const auto row = d_->cell_map_.find(reference.row());
-    if (row == d_->cell_map_.cend()) return false;
-
-    const auto col = row->second.find(reference.column_index());
-    if (col == row->second.cend()) return false;
-
-    return true;
+    return d_->cell_map_.find(reference.row(), reference.column_index()) != nullptr;
 }
 
 bool worksheet::has_row_properties(row_t row) const
@@ -481,17 +462,7 @@ column_t worksheet::lowest_column() const
         return constants::min_column();
     }
 
-    auto lowest = constants::max_column();
-
-    for (auto &row : d_->cell_map_)
-    {
-        for (auto &c : row.second)
-        {
-            lowest = std::min(lowest, c.first);
-        }
-    }
-
-    return lowest;
+    return d_->cell_map_.lowest_column();
 }
 
 column_t worksheet::lowest_column_or_props() const
@@ -518,14 +489,7 @@ row_t worksheet::lowest_row() const
         return constants::min_row();
     }
 
-    auto lowest = constants::max_row();
-
-    for (auto &row : d_->cell_map_)
-    {
-        lowest = std::min(lowest, row.first);
-    }
-
-    return lowest;
+    return d_->cell_map_.lowest_row();
 }
 
 row_t worksheet::lowest_row_or_props() const
@@ -547,14 +511,12 @@ row_t worksheet::lowest_row_or_props() const
 
 row_t worksheet::highest_row() const
 {
-    auto highest = constants::min_row();
-
-    for (auto &row : d_->cell_map_)
+    if (d_->cell_map_.empty())
     {
-        highest = std::max(highest, row.first);
+        return constants::min_row();
     }
 
-    return highest;
+    return d_->cell_map_.highest_row();
 }
 
 row_t worksheet::highest_row_or_props() const
@@ -576,17 +538,12 @@ row_t worksheet::highest_row_or_props() const
 
 column_t worksheet::highest_column() const
 {
-    auto highest = constants::min_column();
-
-    for (auto &row : d_->cell_map_)
+    if (d_->cell_map_.empty())
     {
-        for (auto &c : row.second)
-        {
-            highest = std::max(highest, c.first);
-        }
+        return constants::min_column();
     }
 
-    return highest;
+    return d_->cell_map_.highest_column();
 }
 
 column_t worksheet::highest_column_or_props() const
@@ -703,7 +660,7 @@ row_t worksheet::next_row() const
 {
     auto row = highest_row() + 1;
 
-    if (row == 2 && d_->cell_map_.size() == 0)
+    if (row == 2 && d_->cell_map_.empty())
     {
         row = 1;
     }
@@ -749,13 +706,13 @@ const cell_vector worksheet::cells(bool skip_null) const
 
 void worksheet::clear_cell(const cell_reference &ref)
 {
-    d_->cell_map_.at(ref.row()).erase(ref.column());
+    d_->cell_map_.erase(ref.row(), ref.column_index());
     // TODO: garbage collect newly unreferenced resources such as styles?
 }
 
 void worksheet::clear_row(row_t row)
 {
-    d_->cell_map_.erase(row);
+    d_->cell_map_.erase_row(row);
     // TODO: garbage collect newly unreferenced resources such as styles?
 }
 
@@ -773,35 +730,34 @@ bool worksheet::compare(const worksheet &other, bool reference) const
 
     if (d_->parent_ != other.d_->parent_) return false;
 
-    for (auto &row : d_->cell_map_)
-    {
-        if (other.d_->cell_map_.find(row.first) == other.d_->cell_map_.end())
-        {
-            return false;
-        }
+    auto cells_match = true;
 
-        for (auto &cell : row.second)
-        {
-            if (other.d_->cell_map_[row.first].find(cell.first) == other.d_->cell_map_[row.first].end())
-            {
-                return false;
-            }
+    d_->cell_map_.for_each([&](detail::cell_impl &impl) {
+        if (!cells_match) return;
 
-            xlnt::cell this_cell(&cell.second);
-            xlnt::cell other_cell(&other.d_->cell_map_[row.first][cell.first]);
+        auto other_impl = other.d_->cell_map_.find(impl.row_, impl.column_.index);
 
-            if (this_cell.data_type() != other_cell.data_type())
-            {
-                return false;
-            }
+        if (other_impl == nullptr)
+        {
+            cells_match = false;
+            return;
+        }
 
-            if (this_cell.data_type() == xlnt::cell::type::number
-                && std::fabs(this_cell.value<double>() - other_cell.value<double>()) > 0.0)
-            {
-                return false;
-            }
+        xlnt::cell this_cell(&impl);
+        xlnt::cell other_cell(other_impl);
+
+        if (this_cell.data_type() != other_cell.data_type())
+        {
+            cells_match = false;
         }
-    }
+        else if (this_cell.data_type() == xlnt::cell::type::number
+            && std::fabs(this_cell.value<double>() - other_cell.value<double>()) > 0.0)
+        {
+            cells_match = false;
+        }
+    });
+
+    if (!cells_match) return false;
 
     // todo: missing some comparisons
 
@@ -24,6 +24,7 @@
 #pragma once
 
 #include <sstream>
+#include <thread>
 
 #include <helpers/test_suite.hpp>
 #include <helpers/assertions.hpp>
@@ -66,6 +67,8 @@ public:
         register_test(test_anchor);
         register_test(test_hyperlink);
         register_test(test_comment);
+        register_test(test_reference_buffers);
+        register_test(test_is_date_after_format_change);
     }
 
 private:
@@ -676,4 +679,84 @@ private:
         xlnt_assert(!cell.has_comment());
         xlnt_assert_throws(cell.comment(), xlnt::exception);
     }
+
+    void test_reference_buffers()
+    {
+        char buffer[xlnt::cell_reference::max_string_length];
+
+        const auto reference = xlnt::cell_reference("XFD1048576");
+        xlnt_assert_equals(std::string(buffer, reference.to_chars(buffer)), "XFD1048576");
+        xlnt_assert_equals(xlnt::cell_reference(28, 3).make_absolute().to_string(), "$AB$3");
+
+        const std::string text = "$b12";
+        const auto parsed = xlnt::cell_reference::from_chars(text.data(), text.data() + text.size());
+        xlnt_assert_equals(parsed.column_index(), 2);
+        xlnt_assert_equals(parsed.row(), 12);
+        xlnt_assert(parsed.column_absolute());
+        xlnt_assert(!parsed.row_absolute());
+        xlnt_assert_equals(parsed.to_string(), "$B12");
+
+        bool absolute_column = false;
+        bool absolute_row = false;
+        const auto split = xlnt::cell_reference::split_reference("C$4", absolute_column, absolute_row);
+        xlnt_assert_equals(split.first, "C");
+        xlnt_assert_equals(split.second, 4);
+        xlnt_assert(!absolute_column);
+        xlnt_assert(absolute_row);
+
+        xlnt_assert_throws(xlnt::cell_reference("$$A1"), xlnt::invalid_cell_reference);
+        xlnt_assert_throws(xlnt::cell_reference("1A"), xlnt::invalid_cell_reference);
+        xlnt_assert_throws(xlnt::cell_reference("A99999999999"), xlnt::invalid_cell_reference);
+        xlnt_assert_throws(xlnt::cell_reference("ABCD1"), xlnt::invalid_column_index);
+    }
+
+    void test_is_date_after_format_change()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        auto cell = ws.cell("A1");
+        cell.value(40372.5);
+        xlnt_assert(!cell.is_date());
+
+        cell.number_format(xlnt::number_format::date_yyyymmdd2());
+        xlnt_assert(cell.is_date());
+
+        cell.number_format(xlnt::number_format("0.00"));
+        xlnt_assert(!cell.is_date());
+
+        cell.number_format(xlnt::number_format("[h]:mm:ss"));
+        xlnt_assert(!cell.is_date());
+        xlnt_assert(cell.number_format().is_timedelta_format());
+
+        cell.number_format(xlnt::number_format("yyyy-mm-dd h:mm"));
+        xlnt_assert(cell.is_date());
+
+        // formats are renumbered when unused ones are collected
+        ws.cell("B1").number_format(xlnt::number_format("0.000"));
+        ws.cell("B1").clear_format();
+        std::vector<std::uint8_t> buffer;
+        wb.save(buffer);
+        xlnt_assert(cell.is_date());
+
+        // formats are classified as they change so is_date only reads
+        ws.cell("C1").value(1.5);
+        ws.cell("C1").number_format(xlnt::number_format("mm/dd"));
+        const auto &const_ws = ws;
+        std::vector<int> dates(4, 0);
+        std::vector<std::thread> threads;
+
+        for (std::size_t i = 0; i < dates.size(); ++i)
+        {
+            threads.emplace_back([&const_ws, &dates, i]() {
+                dates[i] = const_ws.cell("A1").is_date() && const_ws.cell("C1").is_date() ? 1 : 0;
+            });
+        }
+
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        xlnt_assert_equals(dates, std::vector<int>(4, 1));
+    }
 };
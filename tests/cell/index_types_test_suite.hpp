@@ -38,6 +38,7 @@ public:
         register_test(test_bad_string_numbers);
         register_test(test_bad_index_zero);
         register_test(test_column_operators);
+        register_test(test_column_buffers);
     }
 
     void test_bad_string_empty()
@@ -102,4 +103,25 @@ public:
         xlnt_assert(3 <= c1);
         xlnt_assert(!(4 <= c1));
     }
+
+    void test_column_buffers()
+    {
+        char buffer[xlnt::column_t::max_string_length];
+
+        for (xlnt::column_t::index_t index = 1; index <= 16384; ++index)
+        {
+            const auto length = xlnt::column_t::column_string_from_index(index, buffer);
+            xlnt_assert_equals(xlnt::column_t::column_index_from_string(buffer, buffer + length), index);
+        }
+
+        xlnt_assert_equals(std::string(buffer, xlnt::column_t::column_string_from_index(28, buffer)), "AB");
+        xlnt_assert_equals(xlnt::column_t::column_string_from_index(702), "ZZ");
+        xlnt_assert_equals(xlnt::column_t::column_string_from_index(703), "AAA");
+
+        const std::string lower = "xfd";
+        xlnt_assert_equals(xlnt::column_t::column_index_from_string(lower.data(), lower.data() + 3), 16384);
+        xlnt_assert_throws(xlnt::column_t::column_index_from_string(lower.data(), lower.data()),
+            xlnt::invalid_column_index);
+        xlnt_assert_throws(xlnt::column_t::column_index_from_string("A@"), xlnt::invalid_column_index);
+    }
 };
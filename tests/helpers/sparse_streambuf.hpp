@@ -0,0 +1,160 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <map>
+#include <streambuf>
+#include <vector>
+
+/// <summary>
+/// A seekable in-memory stream which only keeps the pages that contain
+/// something other than zeros, so that archives of several gigabytes of
+/// mostly zeros can be written and read back without holding them in memory.
+/// </summary>
+class sparse_streambuf : public std::streambuf
+{
+public:
+    sparse_streambuf()
+        : zeros_(page_size, '\0'),
+          position_(0),
+          size_(0),
+          get_start_(0)
+    {
+    }
+
+    /// <summary>
+    /// Returns the number of bytes written up to the furthest position.
+    /// </summary>
+    std::uint64_t size() const
+    {
+        return size_;
+    }
+
+    /// <summary>
+    /// Returns the number of bytes actually held in memory.
+    /// </summary>
+    std::uint64_t stored_size() const
+    {
+        return pages_.size() * page_size;
+    }
+
+protected:
+    virtual std::streamsize xsputn(const char *data, std::streamsize count)
+    {
+        sync_position();
+
+        auto remaining = static_cast<std::uint64_t>(count);
+
+        while (remaining != 0)
+        {
+            const auto offset = static_cast<std::size_t>(position_ % page_size);
+            const auto length = static_cast<std::size_t>(std::min<std::uint64_t>(page_size - offset, remaining));
+            auto page = pages_.find(position_ / page_size);
+
+            if (page == pages_.end() && std::memcmp(data, zeros_.data(), length) != 0)
+            {
+                page = pages_.emplace(position_ / page_size, zeros_).first;
+            }
+
+            if (page != pages_.end())
+            {
+                std::memcpy(page->second.data() + offset, data, length);
+            }
+
+            data += length;
+            position_ += length;
+            remaining -= length;
+        }
+
+        size_ = std::max(size_, position_);
+
+        return count;
+    }
+
+    virtual int_type overflow(int_type c)
+    {
+        if (!traits_type::eq_int_type(c, traits_type::eof()))
+        {
+            const auto character = traits_type::to_char_type(c);
+            xsputn(&character, 1);
+        }
+
+        return traits_type::not_eof(c);
+    }
+
+    virtual int_type underflow()
+    {
+        sync_position();
+
+        if (position_ >= size_)
+        {
+            return traits_type::eof();
+        }
+
+        // the get area points straight into the page or a page of zeros
+        const auto offset = static_cast<std::size_t>(position_ % page_size);
+        const auto length = static_cast<std::size_t>(std::min<std::uint64_t>(page_size - offset, size_ - position_));
+        const auto page = pages_.find(position_ / page_size);
+        auto base = page == pages_.end() ? zeros_.data() : page->second.data();
+
+        setg(base + offset, base + offset, base + offset + length);
+        get_start_ = position_;
+
+        return traits_type::to_int_type(*gptr());
+    }
+
+    virtual pos_type seekoff(off_type offset, std::ios_base::seekdir way, std::ios_base::openmode which)
+    {
+        sync_position();
+
+        auto base = std::uint64_t(0);
+
+        if (way == std::ios_base::cur)
+        {
+            base = position_;
+        }
+        else if (way == std::ios_base::end)
+        {
+            base = size_;
+        }
+
+        return seekpos(pos_type(static_cast<off_type>(base) + offset), which);
+    }
+
+    virtual pos_type seekpos(pos_type position, std::ios_base::openmode)
+    {
+        sync_position();
+
+        if (static_cast<off_type>(position) < 0)
+        {
+            return pos_type(off_type(-1));
+        }
+
+        position_ = static_cast<std::uint64_t>(static_cast<off_type>(position));
+
+        return position;
+    }
+
+private:
+    static const std::size_t page_size = 64 * 1024;
+
+    /// <summary>
+    /// Moves position_ past whatever has been read from the get area and
+    /// discards it so that reads and writes share a single position.
+    /// </summary>
+    void sync_position()
+    {
+        if (eback() != nullptr)
+        {
+            position_ = get_start_ + static_cast<std::uint64_t>(gptr() - eback());
+            setg(nullptr, nullptr, nullptr);
+        }
+    }
+
+    std::map<std::uint64_t, std::vector<char>> pages_;
+    std::vector<char> zeros_;
+    std::uint64_t position_;
+    std::uint64_t size_;
+    std::uint64_t get_start_;
+};
@@ -24,6 +24,7 @@
 #pragma once
 
 #include <iostream>
+#include <thread>
 
 #include <helpers/test_suite.hpp>
 #include <xlnt/xlnt.hpp>
@@ -113,6 +114,10 @@ public:
         register_test(test_builtin_format_date_dmyminus);
         register_test(test_builtin_format_date_dmminus);
         register_test(test_builtin_format_date_myminus);
+        register_test(test_format_into_buffer);
+        register_test(test_format_bulk);
+        register_test(test_recompile_on_format_change);
+        register_test(test_format_from_several_threads);
     }
 
     void test_basic()
@@ -990,4 +995,81 @@ public:
     {
         format_and_test(xlnt::number_format::date_myminus(), {{"5-16", "###########", "1-00", "text"}});
     }
+
+    void test_format_into_buffer()
+    {
+        xlnt::number_format nf("0.00");
+        std::string output = "previous contents";
+
+        nf.format(1.5, xlnt::calendar::windows_1900, output);
+        xlnt_assert_equals(output, "1.50");
+
+        nf.format(-2.25, xlnt::calendar::windows_1900, output);
+        xlnt_assert_equals(output, "-2.25");
+
+        xlnt::number_format::date_ddmmyyyy().format(-1, xlnt::calendar::windows_1900, output);
+        xlnt_assert_equals(output, "###########");
+    }
+
+    void test_format_bulk()
+    {
+        const std::vector<double> numbers{0, 1234.5, -3, 0.5};
+        std::vector<std::string> output(10, "stale");
+
+        xlnt::number_format("#,##0.00;(#,##0.00);\"zero\"").format(numbers, xlnt::calendar::windows_1900, output);
+
+        xlnt_assert_equals(output.size(), numbers.size());
+        xlnt_assert_equals(output[0], "zero");
+        xlnt_assert_equals(output[1], "1,234.50");
+        xlnt_assert_equals(output[2], "(3.00)");
+        xlnt_assert_equals(output[3], "0.50");
+
+        const auto dates = std::vector<double>(1, xlnt::date(2016, 6, 18).to_number(xlnt::calendar::windows_1900));
+        xlnt::number_format::date_ddmmyyyy().format(dates, xlnt::calendar::windows_1900, output);
+        xlnt_assert_equals(output.size(), 1);
+        xlnt_assert_equals(output[0], "18/06/16");
+    }
+
+    void test_recompile_on_format_change()
+    {
+        xlnt::number_format nf("0.0");
+        xlnt_assert_equals(nf.format(2, xlnt::calendar::windows_1900), "2.0");
+        xlnt_assert(!nf.is_date_format());
+
+        auto copy = nf;
+        nf.format_string("yyyy");
+        xlnt_assert(nf.is_date_format());
+        xlnt_assert_equals(nf.format(1, xlnt::calendar::windows_1900), "1900");
+        xlnt_assert_equals(copy.format(2, xlnt::calendar::windows_1900), "2.0");
+
+        nf.format_string("[h]:mm", 200);
+        xlnt_assert(!nf.is_date_format());
+    }
+
+    void test_format_from_several_threads()
+    {
+        // the program is compiled lazily by whichever thread gets there first
+        const xlnt::number_format nf("#,##0.000");
+        std::vector<std::string> results(4);
+        std::vector<std::thread> threads;
+
+        for (std::size_t i = 0; i < results.size(); ++i)
+        {
+            threads.emplace_back([&nf, &results, i]() {
+                auto copy = nf;
+                results[i] = nf.format(1234.5, xlnt::calendar::windows_1900)
+                    + copy.format(1234.5, xlnt::calendar::windows_1900);
+            });
+        }
+
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        for (const auto &result : results)
+        {
+            xlnt_assert_equals(result, "1,234.5001,234.500");
+        }
+    }
 };
@@ -23,7 +23,9 @@
 
 #pragma once
 
+#include <cstdint>
 #include <iostream>
+#include <vector>
 
 #include <helpers/test_suite.hpp>
 #include <xlnt/xlnt.hpp>
@@ -40,6 +42,8 @@ public:
         register_test(test_early_date);
         register_test(test_mac_calendar);
         register_test(test_operators);
+        register_test(test_bulk_conversion);
+        register_test(test_unix_conversion);
     }
 
     void test_from_string()
@@ -113,4 +117,78 @@ public:
         xlnt_assert_equals(d1, d2);
         xlnt_assert_differs(d1, d3);
     }
+
+    void test_bulk_conversion()
+    {
+        for (auto base_date : { xlnt::calendar::windows_1900, xlnt::calendar::mac_1904 })
+        {
+            std::vector<double> numbers;
+
+            for (auto day = 0; day < 100000; ++day)
+            {
+                numbers.push_back(day + (day % 97) / 97.0);
+            }
+
+            numbers.push_back(2958465.999988426); // 9999-12-31 23:59:59
+
+            std::vector<xlnt::date> dates;
+            std::vector<xlnt::datetime> datetimes;
+            xlnt::date::from_numbers(numbers, base_date, dates);
+            xlnt::datetime::from_numbers(numbers, base_date, datetimes);
+            xlnt_assert_equals(dates.size(), numbers.size());
+            xlnt_assert_equals(datetimes.size(), numbers.size());
+
+            for (std::size_t i = 0; i < numbers.size(); ++i)
+            {
+                xlnt_assert_equals(dates[i], xlnt::date::from_number(static_cast<int>(numbers[i]), base_date));
+                xlnt_assert_equals(datetimes[i], xlnt::datetime::from_number(numbers[i], base_date));
+            }
+
+            std::vector<double> date_numbers;
+            std::vector<double> datetime_numbers;
+            xlnt::date::to_numbers(dates, base_date, date_numbers);
+            xlnt::datetime::to_numbers(datetimes, base_date, datetime_numbers);
+
+            for (std::size_t i = 0; i < numbers.size(); ++i)
+            {
+                xlnt_assert_equals(date_numbers[i], dates[i].to_number(base_date));
+                xlnt_assert_equals(datetime_numbers[i], datetimes[i].to_number(base_date));
+            }
+        }
+
+        std::vector<xlnt::date> dates;
+        xlnt::date::from_numbers({}, xlnt::calendar::windows_1900, dates);
+        xlnt_assert(dates.empty());
+    }
+
+    void test_unix_conversion()
+    {
+        std::vector<std::int32_t> days;
+        xlnt::date::unix_days_from_numbers({ 25569, 25570.75, 59, 60, 61, 0 }, xlnt::calendar::windows_1900, days);
+        xlnt_assert_equals(days, std::vector<std::int32_t>({ 0, 1, -25509, -25508, -25508, -25568 }));
+
+        xlnt::date::unix_days_from_numbers({ 24107, 0, -0.5 }, xlnt::calendar::mac_1904, days);
+        xlnt_assert_equals(days, std::vector<std::int32_t>({ 0, -24107, -24108 }));
+
+        std::vector<double> numbers;
+        xlnt::date::numbers_from_unix_days({ 0, -25509, -25508 }, xlnt::calendar::windows_1900, numbers);
+        xlnt_assert_equals(numbers, std::vector<double>({ 25569, 59, 61 }));
+
+        // 2016-07-16 09:00:00 is 1468659600000000 microseconds after the epoch
+        const auto number = xlnt::datetime(2016, 7, 16, 9, 0, 0, 0).to_number(xlnt::calendar::windows_1900);
+        std::vector<std::int64_t> microseconds;
+        xlnt::datetime::unix_microseconds_from_numbers({ number, 25568.75 }, xlnt::calendar::windows_1900, microseconds);
+        xlnt_assert_equals(microseconds[0], 1468659600000000LL);
+        xlnt_assert_equals(microseconds[1], -21600000000LL);
+
+        xlnt::datetime::numbers_from_unix_microseconds(microseconds, xlnt::calendar::windows_1900, numbers);
+        xlnt_assert_equals(numbers[0], number);
+        xlnt_assert_equals(numbers[1], 25568.75);
+
+        xlnt::datetime::unix_microseconds_from_numbers({ number - 1462 }, xlnt::calendar::mac_1904, microseconds);
+        xlnt_assert_equals(microseconds[0], 1468659600000000LL);
+
+        xlnt::datetime::numbers_from_unix_microseconds(microseconds, xlnt::calendar::mac_1904, numbers);
+        xlnt_assert_equals(numbers[0], number - 1462);
+    }
 };
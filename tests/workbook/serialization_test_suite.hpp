@@ -23,13 +23,25 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <limits>
+#include <random>
+#include <thread>
 
+#include <detail/serialization/number_parser.hpp>
+#include <detail/serialization/sheet_data_writer.hpp>
+#include <detail/serialization/shortest_double.hpp>
 #include <detail/serialization/vector_streambuf.hpp>
+#include <detail/serialization/zstream.hpp>
 #include <detail/cryptography/xlsx_crypto_consumer.hpp>
 #include <helpers/temporary_file.hpp>
 #include <helpers/test_suite.hpp>
 #include <helpers/path_helper.hpp>
+#include <helpers/sparse_streambuf.hpp>
 #include <helpers/xml_helper.hpp>
 #include <xlnt/workbook/streaming_workbook_reader.hpp>
 #include <xlnt/workbook/streaming_workbook_writer.hpp>
@@ -71,7 +83,25 @@ public:
         register_test(test_round_trip_rw_encrypted_standard);
         register_test(test_round_trip_rw_encrypted_numbers);
         register_test(test_streaming_read);
+        register_test(test_streaming_visit_cells);
+        register_test(test_streaming_shared_strings);
+        register_test(test_streaming_read_plan);
         register_test(test_streaming_write);
+        register_test(test_streaming_write_typed);
+        register_test(test_streaming_write_failed_cell);
+        register_test(test_round_trip_sparse);
+        register_test(test_load_worksheets_in_parallel);
+        register_test(test_save_compressing_in_parallel);
+        register_test(test_save_compression_options);
+        register_test(test_zip_buffer_sizes);
+        register_test(test_load_memory_mapped);
+        register_test(test_load_lazy_parts);
+        register_test(test_zip64_large_entry);
+        register_test(test_zip64_entry_count);
+        register_test(test_parse_numbers);
+        register_test(test_shortest_double);
+        register_test(test_streaming_date_formats);
+        register_test(test_sheet_data_writer);
     }
 
 	bool workbook_matches_file(xlnt::workbook &wb, const xlnt::path &file)
@@ -581,6 +611,194 @@ public:
         }
     }
 
+    void test_streaming_visit_cells()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value(1.5);
+        ws.cell("B1").value("shared");
+        ws.cell("C1").value(true);
+        ws.cell("B3").error("#REF!");
+        ws.cell("AB3").value(42);
+        ws.cell("AB3").number_format(xlnt::number_format::percentage());
+
+        std::vector<std::uint8_t> buffer;
+        wb.save(buffer);
+
+        xlnt::streaming_workbook_reader reader;
+        reader.open(buffer);
+        reader.begin_worksheet("Sheet1");
+
+        std::vector<std::string> visited;
+
+        reader.visit_cells([&visited](const xlnt::cell_view &view) {
+            auto description = xlnt::cell_reference(view.column, view.row).to_string() + " ";
+
+            switch (view.type)
+            {
+            case xlnt::cell_type::number:
+                description += std::to_string(view.number);
+                break;
+            case xlnt::cell_type::boolean:
+                description += view.number != 0.0 ? "true" : "false";
+                break;
+            case xlnt::cell_type::shared_string:
+                description += "s" + std::to_string(view.shared_string);
+                break;
+            default:
+                description += std::string(view.text, view.text_length);
+                break;
+            }
+
+            if (view.has_format)
+            {
+                description += " f";
+            }
+
+            visited.push_back(description);
+        });
+
+        xlnt_assert(!reader.has_cell());
+        reader.end_worksheet();
+
+        const auto expected = std::vector<std::string>{
+            "A1 1.500000", "B1 s0", "C1 true", "B3 #REF!", "AB3 42.000000 f"};
+        xlnt_assert_equals(visited, expected);
+    }
+
+    void test_streaming_shared_strings()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        xlnt::rich_text formatted;
+        formatted.add_run(xlnt::rich_text_run{"bold", xlnt::optional<xlnt::font>(xlnt::font().bold(true))});
+        formatted.add_run(xlnt::rich_text_run{" & plain", xlnt::optional<xlnt::font>()});
+
+        ws.cell("A1").value("plain");
+        ws.cell("A2").value("  <escaped> & \"quoted\"  ");
+        ws.cell("A3").value(formatted);
+        ws.cell("A4").value("");
+
+        temporary_file file;
+        wb.save(file.get_path());
+
+        // a limit of 0 moves the table to a temporary file immediately
+        for (auto limit : {std::size_t(64 * 1024 * 1024), std::size_t(0)})
+        {
+            xlnt::load_options options;
+            options.shared_string_memory_limit = limit;
+
+            xlnt::streaming_workbook_reader reader;
+            reader.open(file.get_path(), options);
+            reader.begin_worksheet("Sheet1");
+
+            std::vector<xlnt::rich_text> values;
+
+            while (reader.has_cell())
+            {
+                values.push_back(reader.read_cell().value<xlnt::rich_text>());
+            }
+
+            reader.end_worksheet();
+
+            xlnt_assert_equals(values.size(), 4);
+            xlnt_assert_equals(values[0], xlnt::rich_text("plain"));
+            xlnt_assert_equals(values[1].plain_text(), "  <escaped> & \"quoted\"  ");
+            xlnt_assert_equals(values[2], formatted);
+            xlnt_assert_equals(values[3].plain_text(), "");
+
+            std::vector<std::string> texts;
+            reader.begin_worksheet("Sheet1");
+            reader.visit_cells([&](const xlnt::cell_view &view) {
+                texts.push_back(reader.shared_string_text(view.shared_string));
+            });
+            reader.end_worksheet();
+
+            xlnt_assert_equals(texts, std::vector<std::string>({"plain",
+                "  <escaped> & \"quoted\"  ", "bold & plain", ""}));
+            xlnt_assert_throws(reader.shared_string(4), xlnt::invalid_parameter);
+        }
+    }
+
+    void test_streaming_read_plan()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (xlnt::row_t row = 1; row <= 10; ++row)
+        {
+            for (xlnt::column_t::index_t column = 1; column <= 6; ++column)
+            {
+                ws.cell(column, row).value(static_cast<int>(row * 100 + column));
+            }
+        }
+
+        ws.merge_cells("A1:B1");
+        wb.create_sheet().cell("A1").value("second");
+
+        std::vector<std::uint8_t> buffer;
+        wb.save(buffer);
+
+        xlnt::read_plan plan;
+        plan.columns = {"B", "E"};
+        plan.first_row = 3;
+        plan.last_row = 6;
+
+        const auto expected = std::vector<std::string>{"B3", "E3", "B4", "E4", "B5", "E5", "B6", "E6"};
+
+        xlnt::streaming_workbook_reader reader;
+        reader.open(buffer);
+
+        std::vector<std::string> visited;
+        reader.begin_worksheet("Sheet1", plan);
+        reader.visit_cells([&](const xlnt::cell_view &view) {
+            const auto reference = xlnt::cell_reference(view.column, view.row);
+            xlnt_assert_equals(view.number, static_cast<double>(view.row * 100 + view.column));
+            visited.push_back(reference.to_string());
+        });
+        xlnt_assert(!reader.has_cell());
+        reader.end_worksheet();
+        xlnt_assert_equals(visited, expected);
+
+        std::vector<std::string> read;
+        reader.begin_worksheet("Sheet1", plan);
+
+        while (reader.has_cell())
+        {
+            auto cell = reader.read_cell();
+            xlnt_assert_equals(cell.value<int>(), static_cast<int>(cell.row() * 100 + cell.column().index));
+            read.push_back(cell.reference().to_string());
+        }
+
+        reader.end_worksheet();
+        xlnt_assert_equals(read, expected);
+
+        // stopping after one planned cell leaves the rest to end_worksheet
+        reader.begin_worksheet("Sheet1", plan);
+        xlnt_assert(reader.has_cell());
+        reader.end_worksheet();
+
+        // a plan which reaches the last row still reads the rest of the worksheet
+        xlnt::read_plan columns;
+        columns.columns = {"F"};
+        std::size_t count = 0;
+        xlnt::streaming_workbook_reader columns_reader;
+        columns_reader.open(buffer);
+        columns_reader.begin_worksheet("Sheet1", columns);
+        columns_reader.visit_cells([&](const xlnt::cell_view &view) {
+            xlnt_assert_equals(view.column, 6);
+            ++count;
+        });
+        xlnt_assert_equals(count, 10);
+        xlnt_assert_equals(columns_reader.end_worksheet().merged_ranges().size(), 1);
+
+        reader.begin_worksheet("Sheet2");
+        xlnt_assert_equals(reader.read_cell().value<std::string>(), "second");
+        xlnt_assert(!reader.has_cell());
+        reader.end_worksheet();
+    }
+
     void test_streaming_write()
     {
         const auto path = std::string("stream-out.xlsx");
@@ -596,5 +814,749 @@ public:
         auto c3 = writer.add_cell("C3");
         b2.value("should not change");
         c3.value("C3!");
+
+        writer.close();
+
+        xlnt::workbook wb;
+        wb.load(path);
+        auto ws = wb.sheet_by_title("stream");
+        xlnt_assert_equals(ws.cell("B2").value<std::string>(), "B2!");
+        xlnt_assert_equals(ws.cell("C3").value<std::string>(), "C3!");
+    }
+
+    void test_streaming_write_typed()
+    {
+        std::vector<std::uint8_t> buffer;
+
+        {
+            xlnt::streaming_workbook_writer writer;
+            writer.open(buffer);
+
+            auto percent = writer.create_format();
+            percent.number_format(xlnt::number_format::percentage(), true);
+            const auto percent_id = writer.register_format(percent);
+
+            auto first = writer.add_worksheet("first");
+            first.column_properties("A").width = 20.0;
+            first.column_properties("A").custom_width = true;
+            writer.add_string("A1", " padded ");
+            writer.add_string("B1", "a < b & c");
+            writer.add_number("A2", 0.25, percent_id);
+            writer.add_boolean("B2", true);
+            writer.add_formula("C2", "A2*2");
+            xlnt_assert_throws(writer.add_number("A1", 1), xlnt::invalid_parameter);
+
+            writer.add_worksheet("second");
+            writer.add_cell("B3").value("through the cell");
+            writer.add_number("C3", 3);
+
+            writer.close();
+        }
+
+        xlnt::workbook wb;
+        wb.load(buffer);
+        xlnt_assert_equals(wb.sheet_titles(), std::vector<std::string>({"first", "second"}));
+
+        auto first = wb.sheet_by_title("first");
+        xlnt_assert_equals(first.cell("A1").value<std::string>(), " padded ");
+        xlnt_assert_equals(first.cell("B1").value<std::string>(), "a < b & c");
+        xlnt_assert_equals(first.cell("A2").value<double>(), 0.25);
+        xlnt_assert_equals(first.cell("A2").number_format(), xlnt::number_format::percentage());
+        xlnt_assert(first.cell("B2").value<bool>());
+        xlnt_assert_equals(first.cell("C2").formula(), "A2*2");
+        xlnt_assert_equals(first.column_properties("A").width.get(), 20.0);
+
+        auto second = wb.sheet_by_title("second");
+        xlnt_assert_equals(second.cell("B3").value<std::string>(), "through the cell");
+        xlnt_assert_equals(second.cell("C3").value<int>(), 3);
+    }
+
+    void test_streaming_write_failed_cell()
+    {
+        std::vector<std::uint8_t> buffer;
+
+        {
+            xlnt::streaming_workbook_writer writer;
+            writer.open(buffer);
+
+            writer.add_cell("A1").value(std::string("bad \xff utf8"));
+
+            // the bad cell is written when the next one is begun and isn't retried
+            xlnt_assert_throws(writer.add_cell("A2"), std::exception);
+            xlnt_assert_throws(writer.add_cell("A3"), xlnt::exception);
+            xlnt_assert_throws(writer.add_worksheet("other"), xlnt::exception);
+        }
+
+        {
+            xlnt::streaming_workbook_writer writer;
+            writer.open(buffer);
+            writer.add_cell("A1").value(std::string("bad \xff utf8"));
+            xlnt_assert_throws(writer.close(), std::exception);
+            xlnt_assert_throws_nothing(writer.close());
+        }
+    }
+
+    void test_round_trip_sparse()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value("first");
+        ws.cell("XFD1048576").value("last");
+        ws.cell("C3").value(3);
+        ws.cell("C3").clear_value();
+        ws.row_properties(5).height = 20;
+
+        std::vector<std::uint8_t> buffer;
+        wb.save(buffer);
+
+        xlnt::workbook loaded;
+        loaded.load(buffer);
+        auto loaded_ws = loaded.active_sheet();
+
+        xlnt_assert_equals(loaded_ws.cell("A1").value<std::string>(), "first");
+        xlnt_assert_equals(loaded_ws.cell("XFD1048576").value<std::string>(), "last");
+        xlnt_assert(!loaded_ws.has_cell("C3"));
+        xlnt_assert(loaded_ws.has_row_properties(5));
+        xlnt_assert_equals(loaded_ws.calculate_dimension().to_string(), "A1:XFD1048576");
+    }
+
+    void test_load_worksheets_in_parallel()
+    {
+        xlnt::workbook wb;
+
+        for (auto sheet = 0; sheet < 6; ++sheet)
+        {
+            auto ws = sheet == 0 ? wb.active_sheet() : wb.create_sheet();
+
+            for (auto row = 1; row <= 50; ++row)
+            {
+                ws.cell(1, static_cast<xlnt::row_t>(row)).value(sheet * 100 + row);
+                ws.cell(2, static_cast<xlnt::row_t>(row)).value("text " + std::to_string(row));
+            }
+
+            ws.cell("C1").formula("=SUM(A1:A50)");
+            ws.cell("C2").number_format(xlnt::number_format::percentage());
+            ws.cell("C2").value(0.5);
+
+            // cells covered by a merged range are cleared again on load
+            ws.merge_cells("D1:E2");
+            ws.cell("D1").value("merged");
+            ws.cell("E1").value("covered " + std::to_string(sheet));
+            ws.cell("D2").formula("=A1");
+        }
+
+        std::vector<std::uint8_t> buffer;
+        wb.save(buffer);
+
+        xlnt::load_options parallel;
+        parallel.worksheet_threads = 0;
+
+        xlnt::workbook sequential_wb;
+        sequential_wb.load(buffer);
+        xlnt::workbook parallel_wb;
+        parallel_wb.load(buffer, parallel);
+
+        std::vector<std::uint8_t> sequential_data;
+        sequential_wb.save(sequential_data);
+        std::vector<std::uint8_t> parallel_data;
+        parallel_wb.save(parallel_data);
+
+        xlnt_assert(xml_helper::xlsx_archives_match(sequential_data, parallel_data));
+        xlnt_assert_equals(parallel_wb.sheet_titles(), wb.sheet_titles());
+        xlnt_assert_equals(parallel_wb.sheet_by_index(5).cell("A50").value<int>(), 550);
+        xlnt_assert_equals(parallel_wb.sheet_by_index(3).cell("C2").number_format(), xlnt::number_format::percentage());
+
+        for (auto ws : parallel_wb)
+        {
+            xlnt_assert_equals(ws.merged_ranges().size(), 1);
+            xlnt_assert_equals(ws.cell("D1").value<std::string>(), "merged");
+            xlnt_assert(ws.cell("E1").is_merged());
+            xlnt_assert_equals(ws.cell("E1").value<std::string>(), "");
+            xlnt_assert(!ws.cell("D2").has_formula());
+        }
+
+        parallel.worksheet_threads = 2;
+        xlnt::workbook file_wb;
+        file_wb.load(path_helper::test_file("10_comments_hyperlinks_formulae.xlsx"), parallel);
+        xlnt_assert(workbook_matches_file(file_wb, path_helper::test_file("10_comments_hyperlinks_formulae.xlsx")));
+    }
+
+    void test_save_compressing_in_parallel()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        // large enough for the sheet part to be split into several deflate blocks
+        for (auto row = 1; row <= 20000; ++row)
+        {
+            ws.cell(1, static_cast<xlnt::row_t>(row)).value(row);
+            ws.cell(2, static_cast<xlnt::row_t>(row)).value(row * 0.5);
+            ws.cell(3, static_cast<xlnt::row_t>(row)).value("text " + std::to_string(row % 100));
+        }
+
+        wb.create_sheet().cell("B2").value("small");
+
+        std::vector<std::uint8_t> sequential_data;
+        wb.save(sequential_data);
+
+        xlnt::save_options parallel;
+        parallel.compression_threads = 3;
+        std::vector<std::uint8_t> parallel_data;
+        wb.save(parallel_data, parallel);
+
+        xlnt_assert(xml_helper::xlsx_archives_match(sequential_data, parallel_data));
+
+        xlnt::workbook loaded;
+        loaded.load(parallel_data);
+        xlnt_assert_equals(loaded.sheet_by_index(0).cell("A20000").value<int>(), 20000);
+        xlnt_assert_equals(loaded.sheet_by_index(0).cell("C123").value<std::string>(), "text 23");
+        xlnt_assert_equals(loaded.sheet_by_index(1).cell("B2").value<std::string>(), "small");
+    }
+
+    void test_save_compression_options()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (auto row = 1; row <= 1000; ++row)
+        {
+            ws.cell(1, static_cast<xlnt::row_t>(row)).value(row);
+            ws.cell(2, static_cast<xlnt::row_t>(row)).value("repeated text");
+        }
+
+        std::vector<std::uint8_t> default_data;
+        wb.save(default_data);
+
+        xlnt::save_options stored;
+        stored.store_only = true;
+        std::vector<std::uint8_t> stored_data;
+        wb.save(stored_data, stored);
+        xlnt_assert(xml_helper::xlsx_archives_match(default_data, stored_data));
+        xlnt_assert(stored_data.size() > default_data.size());
+
+        stored.compression_threads = 2;
+        std::vector<std::uint8_t> stored_parallel_data;
+        wb.save(stored_parallel_data, stored);
+        xlnt_assert_equals(stored_parallel_data, stored_data);
+
+        xlnt::save_options smallest;
+        smallest.compression_level = 9;
+        smallest.strategy = xlnt::save_options::compression_strategy::filtered;
+        std::vector<std::uint8_t> smallest_data;
+        wb.save(smallest_data, smallest);
+        xlnt_assert(xml_helper::xlsx_archives_match(default_data, smallest_data));
+
+        xlnt::workbook loaded;
+        loaded.load(stored_data);
+        xlnt_assert_equals(loaded.active_sheet().cell("A1000").value<int>(), 1000);
+
+        xlnt::save_options invalid;
+        invalid.compression_level = 10;
+        std::vector<std::uint8_t> invalid_data;
+        xlnt_assert_throws(wb.save(invalid_data, invalid), xlnt::invalid_parameter);
+    }
+
+    void test_zip_buffer_sizes()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (auto row = 1; row <= 1000; ++row)
+        {
+            ws.cell(1, static_cast<xlnt::row_t>(row)).value(row);
+        }
+
+        std::vector<std::uint8_t> default_data;
+        wb.save(default_data);
+
+        // tiny buffers exercise every refill path of the zip streambufs
+        xlnt::save_options tiny_save;
+        tiny_save.zip_buffer_size = 16;
+        std::vector<std::uint8_t> tiny_data;
+        wb.save(tiny_data, tiny_save);
+        xlnt_assert(xml_helper::xlsx_archives_match(default_data, tiny_data));
+
+        xlnt::load_options tiny_load;
+        tiny_load.zip_buffer_size = 16;
+        xlnt::workbook loaded;
+        loaded.load(tiny_data, tiny_load);
+        xlnt_assert_equals(loaded.active_sheet().cell("A1000").value<int>(), 1000);
+
+        xlnt::detail::vector_istreambuf archive_buffer(default_data);
+        std::istream archive_stream(&archive_buffer);
+        xlnt::detail::izstream archive(archive_stream);
+        const auto sheet_path = xlnt::path("xl/worksheets/sheet1.xml");
+
+        const auto streamed = archive.read(sheet_path);
+        std::vector<std::uint8_t> direct(archive.uncompressed_size(sheet_path));
+        xlnt_assert_equals(archive.read(sheet_path, direct.data(), direct.size()), streamed.size());
+        xlnt_assert(std::equal(direct.begin(), direct.end(), streamed.begin()));
+
+        auto part_buffer = archive.open(sheet_path);
+        std::istream part_stream(part_buffer.get());
+        const auto through_streambuf = std::string((std::istreambuf_iterator<char>(part_stream)),
+            std::istreambuf_iterator<char>());
+        xlnt_assert_equals(through_streambuf, streamed);
+    }
+
+    void test_load_memory_mapped()
+    {
+        xlnt::load_options mapped;
+        mapped.memory_map = true;
+
+        const auto sample = path_helper::test_file("10_comments_hyperlinks_formulae.xlsx");
+        xlnt::workbook sample_wb;
+        sample_wb.load(sample, mapped);
+        xlnt_assert(workbook_matches_file(sample_wb, sample));
+
+        mapped.worksheet_threads = 2;
+        sample_wb.load(sample, mapped);
+        xlnt_assert(workbook_matches_file(sample_wb, sample));
+
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (auto row = 1; row <= 1000; ++row)
+        {
+            ws.cell(1, static_cast<xlnt::row_t>(row)).value(row);
+        }
+
+        temporary_file file;
+        xlnt::save_options stored;
+        stored.store_only = true;
+        wb.save(file.get_path(), stored);
+
+        xlnt::workbook loaded;
+        loaded.load(file.get_path(), mapped);
+        xlnt_assert_equals(loaded.active_sheet().cell("A1000").value<int>(), 1000);
+
+        xlnt::streaming_workbook_reader reader;
+        reader.open(file.get_path(), mapped);
+        reader.begin_worksheet("Sheet1");
+        auto cells = 0;
+
+        while (reader.has_cell())
+        {
+            reader.read_cell();
+            ++cells;
+        }
+
+        reader.end_worksheet();
+        reader.close();
+        xlnt_assert_equals(cells, 1000);
+
+        std::vector<std::uint8_t> compressed_data;
+        wb.save(compressed_data);
+        std::vector<std::uint8_t> stored_data;
+        wb.save(stored_data, stored);
+        const auto sheet_path = xlnt::path("xl/worksheets/sheet1.xml");
+
+        xlnt::detail::vector_istreambuf archive_buffer(compressed_data);
+        std::istream archive_stream(&archive_buffer);
+        const auto expected = xlnt::detail::izstream(archive_stream).read(sheet_path);
+
+        // stored entries are exposed in place, deflated ones are inflated from memory
+        xlnt::detail::izstream stored_archive(stored_data.data(), stored_data.size(), 0);
+        const auto stored_sheet = stored_archive.stored_data(sheet_path);
+        xlnt_assert_differs(stored_sheet, nullptr);
+        xlnt_assert(stored_sheet > stored_data.data() && stored_sheet < stored_data.data() + stored_data.size());
+        xlnt_assert_equals(std::string(reinterpret_cast<const char *>(stored_sheet),
+            stored_archive.uncompressed_size(sheet_path)), expected);
+        xlnt_assert_equals(stored_archive.read(sheet_path), expected);
+
+        xlnt::detail::izstream compressed_archive(compressed_data.data(), compressed_data.size(), 16);
+        xlnt_assert_equals(compressed_archive.stored_data(sheet_path), nullptr);
+        xlnt_assert_equals(compressed_archive.read(sheet_path), expected);
+
+        for (auto archive : { &stored_archive, &compressed_archive })
+        {
+            auto part_buffer = archive->open_detached(sheet_path);
+            std::istream part_stream(part_buffer.get());
+            xlnt_assert_equals(std::string((std::istreambuf_iterator<char>(part_stream)),
+                std::istreambuf_iterator<char>()), expected);
+        }
+    }
+
+    void test_load_lazy_parts()
+    {
+        xlnt::workbook wb;
+        wb.active_sheet().cell("A1").value("first");
+        wb.create_sheet().cell("A1").value("second");
+        auto third = wb.create_sheet();
+        third.cell("B2").value(3);
+        third.cell("B2").comment(xlnt::comment("note", "author"));
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        // the same package with an unreadable second worksheet
+        std::vector<std::uint8_t> broken_data;
+
+        {
+            xlnt::detail::vector_istreambuf archive_buffer(data);
+            std::istream archive_stream(&archive_buffer);
+            xlnt::detail::izstream archive(archive_stream);
+
+            xlnt::detail::vector_ostreambuf broken_buffer(broken_data);
+            std::ostream broken_stream(&broken_buffer);
+            xlnt::detail::ozstream broken_archive(broken_stream);
+
+            for (const auto &file : archive.files())
+            {
+                auto part_buffer = broken_archive.open(file);
+                std::ostream part_stream(part_buffer.get());
+                part_stream << (file.string() == "xl/worksheets/sheet2.xml" ? "<broken" : archive.read(file));
+            }
+        }
+
+        xlnt::load_options lazy;
+        lazy.lazy_parts = true;
+
+        xlnt::workbook eager;
+        xlnt_assert_throws_nothing(eager.load(data));
+        xlnt_assert_throws(eager.load(broken_data), std::exception);
+
+        // parts are only read when their worksheet is first reached and the
+        // package doesn't have to outlive the workbook
+        xlnt::workbook loaded;
+        {
+            auto copy = broken_data;
+            loaded.load(copy, lazy);
+        }
+
+        xlnt_assert_equals(loaded.sheet_count(), 3);
+        xlnt_assert(loaded.contains("Sheet2"));
+        xlnt_assert_equals(loaded.sheet_by_title("Sheet1").cell("A1").value<std::string>(), "first");
+        xlnt_assert_equals(loaded.sheet_by_index(2).cell("B2").value<int>(), 3);
+        xlnt_assert_equals(loaded.sheet_by_index(2).cell("B2").comment().plain_text(), "note");
+        xlnt_assert_throws(loaded.sheet_by_title("Sheet2"), std::exception);
+
+        // the broken worksheet keeps failing instead of handing out what was read of it
+        xlnt_assert_throws(loaded.sheet_by_title("Sheet2"), std::exception);
+        xlnt_assert_throws(loaded.sheet_by_index(1), std::exception);
+        std::vector<std::uint8_t> broken_save;
+        xlnt_assert_throws(loaded.save(broken_save), std::exception);
+        xlnt_assert_equals(loaded.sheet_by_title("Sheet1").cell("A1").value<std::string>(), "first");
+
+        // as it does when the remaining worksheets are read together
+        auto threaded_lazy = lazy;
+        threaded_lazy.worksheet_threads = 0;
+        xlnt::workbook broken_threaded;
+        broken_threaded.load(broken_data, threaded_lazy);
+        xlnt_assert_throws(broken_threaded.save(broken_save), std::exception);
+        xlnt_assert_throws(broken_threaded.sheet_by_title("Sheet2"), std::exception);
+        xlnt_assert_equals(broken_threaded.sheet_by_index(2).cell("B2").value<int>(), 3);
+
+        // whatever is left is read before saving or copying
+        xlnt::workbook untouched;
+        untouched.load(data, lazy);
+        std::vector<std::uint8_t> untouched_data;
+        untouched.save(untouched_data);
+        std::vector<std::uint8_t> eager_data;
+        eager.load(data);
+        eager.save(eager_data);
+        xlnt_assert(xml_helper::xlsx_archives_match(eager_data, untouched_data));
+
+        xlnt::workbook copied;
+        copied.load(data, lazy);
+        const auto copy = copied;
+        copied.clear();
+        xlnt_assert_equals(copy.sheet_by_index(1).cell("A1").value<std::string>(), "second");
+
+        // the remaining worksheets can be read by several threads
+        lazy.worksheet_threads = 0;
+        xlnt::workbook threaded;
+        threaded.load(data, lazy);
+        std::vector<std::uint8_t> threaded_data;
+        threaded.save(threaded_data);
+        xlnt_assert(xml_helper::xlsx_archives_match(eager_data, threaded_data));
+
+        // and worksheets can be looked up from several threads at once
+        xlnt::workbook shared;
+        shared.load(data, lazy);
+        const auto &shared_const = shared;
+        std::vector<std::thread> threads;
+
+        for (std::size_t index = 0; index < shared.sheet_count(); ++index)
+        {
+            threads.emplace_back([&shared_const, index]() { shared_const.sheet_by_index(index); });
+        }
+
+        for (auto &thread : threads)
+        {
+            thread.join();
+        }
+
+        xlnt_assert_equals(shared_const.sheet_by_index(1).cell("A1").value<std::string>(), "second");
+        xlnt_assert_equals(shared.sheet_by_index(2).cell("B2").comment().plain_text(), "note");
+
+        const auto sample = path_helper::test_file("10_comments_hyperlinks_formulae.xlsx");
+        lazy.memory_map = true;
+        xlnt::workbook mapped;
+        mapped.load(sample, lazy);
+        xlnt_assert(workbook_matches_file(mapped, sample));
+    }
+
+    void test_zip64_large_entry()
+    {
+        // a part over 4 GiB followed by one which starts past 4 GiB, both of
+        // which need ZIP64, written to a stream which doesn't keep the zeros
+        const auto large_size = (std::uint64_t(1) << 32) + 12345;
+        const std::string head = "large part";
+        sparse_streambuf archive_buffer;
+
+        {
+            std::ostream archive_stream(&archive_buffer);
+            xlnt::save_options options;
+            options.store_only = true;
+            xlnt::detail::ozstream archive(archive_stream, options);
+
+            {
+                auto part_buffer = archive.open(xlnt::path("large.bin"));
+                std::ostream part_stream(part_buffer.get());
+                part_stream << head;
+
+                const std::vector<char> zeros(1024 * 1024, '\0');
+                auto remaining = large_size - head.size();
+
+                while (remaining != 0)
+                {
+                    const auto count = std::min(remaining, static_cast<std::uint64_t>(zeros.size()));
+                    part_stream.write(zeros.data(), static_cast<std::streamsize>(count));
+                    remaining -= count;
+                }
+            }
+
+            auto part_buffer = archive.open(xlnt::path("small.txt"));
+            std::ostream part_stream(part_buffer.get());
+            part_stream << "small part";
+        }
+
+        xlnt_assert(archive_buffer.size() > large_size);
+        xlnt_assert(archive_buffer.stored_size() < 1024 * 1024);
+
+        std::istream archive_stream(&archive_buffer);
+        xlnt::detail::izstream archive(archive_stream);
+        xlnt_assert_equals(archive.files().size(), 2);
+        xlnt_assert_equals(static_cast<std::uint64_t>(archive.uncompressed_size(xlnt::path("large.bin"))), large_size);
+        xlnt_assert_equals(archive.read(xlnt::path("small.txt")), "small part");
+
+        auto part_buffer = archive.open(xlnt::path("large.bin"));
+        std::istream part_stream(part_buffer.get());
+        std::string read_head(head.size(), '\0');
+        part_stream.read(&read_head[0], static_cast<std::streamsize>(read_head.size()));
+        xlnt_assert_equals(read_head, head);
+    }
+
+    void test_zip64_entry_count()
+    {
+        // more entries than the end of central directory record can count
+        const auto entry_count = std::size_t(70000);
+        std::vector<std::uint8_t> data;
+
+        {
+            xlnt::detail::vector_ostreambuf archive_buffer(data);
+            std::ostream archive_stream(&archive_buffer);
+            xlnt::save_options options;
+            options.zip_buffer_size = 16;
+            xlnt::detail::ozstream archive(archive_stream, options);
+
+            for (std::size_t i = 0; i < entry_count; ++i)
+            {
+                auto part_buffer = archive.open(xlnt::path("part" + std::to_string(i)));
+                std::ostream part_stream(part_buffer.get());
+                part_stream << i;
+            }
+        }
+
+        xlnt::detail::izstream archive(data.data(), data.size(), 0);
+        xlnt_assert_equals(archive.files().size(), entry_count);
+        xlnt_assert_equals(archive.read(xlnt::path("part0")), "0");
+        xlnt_assert_equals(archive.read(xlnt::path("part69999")), "69999");
+    }
+
+    void test_parse_numbers()
+    {
+        auto same_double = [](double a, double b) { return std::memcmp(&a, &b, sizeof(double)) == 0; };
+
+        const std::vector<std::string> cases{"0", "-0", "1", "+2", "42503.1234", "-1.5", "0.1", "0.30000000000000004",
+            "1E-3", "2.5e+10", "1e22", "1e23", "9007199254740993", "123456789012345678901234567890",
+            "0.000000000000000000000000000001", "4.9406564584124654E-324", "1.7976931348623157e308", "1e400",
+            "2.2250738585072011e-308", "3.141592653589793238462643383279", "00012.50", ".5", "5."};
+
+        for (const auto &text : cases)
+        {
+            xlnt_assert(same_double(xlnt::detail::parse_double(text), std::strtod(text.c_str(), nullptr)));
+        }
+
+        std::mt19937_64 random(12345);
+        char buffer[64];
+
+        for (auto i = 0; i < 10000; ++i)
+        {
+            auto bits = random();
+            double value = 0;
+            std::memcpy(&value, &bits, sizeof(double));
+
+            if (value != value || value - value != 0) continue;
+
+            std::snprintf(buffer, sizeof(buffer), "%.*g", static_cast<int>(i % 18) + 1, value);
+            xlnt_assert(same_double(xlnt::detail::parse_double(buffer), std::strtod(buffer, nullptr)));
+        }
+
+        xlnt_assert_equals(xlnt::detail::parse_double("12abc"), 12.0);
+        xlnt_assert_equals(xlnt::detail::parse_double("abc"), 0.0);
+        xlnt_assert_equals(xlnt::detail::parse_double("1e"), 1.0);
+
+        xlnt_assert_equals(xlnt::detail::parse_unsigned("1048576"), 1048576);
+        xlnt_assert_equals(xlnt::detail::parse_unsigned("18446744073709551615"), 18446744073709551615ULL);
+        xlnt_assert_throws(xlnt::detail::parse_unsigned(""), xlnt::exception);
+        xlnt_assert_throws(xlnt::detail::parse_unsigned("-1"), xlnt::exception);
+        xlnt_assert_throws(xlnt::detail::parse_unsigned("18446744073709551616"), xlnt::exception);
+    }
+
+    void test_shortest_double()
+    {
+        using xlnt::detail::shortest_double;
+
+        xlnt_assert_equals(shortest_double(0.1), "0.1");
+        xlnt_assert_equals(shortest_double(0.30000000000000004), "0.30000000000000004");
+        xlnt_assert_equals(shortest_double(-42503.1234), "-42503.1234");
+        xlnt_assert_equals(shortest_double(100), "100");
+        xlnt_assert_equals(shortest_double(0.000001), "0.000001");
+        xlnt_assert_equals(shortest_double(1.5e-7), "1.5E-7");
+        xlnt_assert_equals(shortest_double(1e21), "1E+21");
+        xlnt_assert_equals(shortest_double(5e-324), "5E-324");
+        xlnt_assert_equals(shortest_double(1.7976931348623157e308), "1.7976931348623157E+308");
+        xlnt_assert_equals(shortest_double(0.0), "0");
+        xlnt_assert_equals(shortest_double(std::numeric_limits<double>::infinity()), "INF");
+        xlnt_assert_equals(shortest_double(-std::numeric_limits<double>::infinity()), "-INF");
+
+        std::mt19937_64 random(54321);
+
+        for (auto i = 0; i < 100000; ++i)
+        {
+            auto bits = random();
+            double value = 0;
+            std::memcpy(&value, &bits, sizeof(double));
+
+            if (value != value || value - value != 0) continue;
+
+            const auto text = shortest_double(value);
+            const auto parsed = std::strtod(text.c_str(), nullptr);
+            xlnt_assert(std::memcmp(&parsed, &value, sizeof(double)) == 0);
+        }
+
+        const std::vector<double> values{0.1, 1.0 / 3, 2.0 / 3 * 1e-10, 123456.789e100, -0.000123};
+
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            ws.cell(1, static_cast<xlnt::row_t>(i + 1)).value(values[i]);
+        }
+
+        std::vector<std::uint8_t> data;
+        wb.save(data);
+
+        xlnt::workbook loaded;
+        loaded.load(data);
+
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            const auto value = loaded.active_sheet().cell(1, static_cast<xlnt::row_t>(i + 1)).value<double>();
+            xlnt_assert(std::memcmp(&value, &values[i], sizeof(double)) == 0);
+        }
+    }
+
+    void test_streaming_date_formats()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+        ws.cell("A1").value(xlnt::date(2017, 1, 2));
+        ws.cell("B1").value(xlnt::timedelta(1, 2, 3, 4, 5));
+        ws.cell("C1").value(3.5);
+        ws.cell("C1").number_format(xlnt::number_format("0.00"));
+        ws.cell("D1").value(4);
+
+        std::vector<std::uint8_t> buffer;
+        wb.save(buffer);
+
+        xlnt::workbook loaded;
+        loaded.load(buffer);
+        const auto loaded_ws = loaded.active_sheet();
+        xlnt_assert(loaded_ws.cell("A1").is_date());
+        xlnt_assert(!loaded_ws.cell("B1").is_date());
+        xlnt_assert(!loaded_ws.cell("C1").is_date());
+        xlnt_assert(!loaded_ws.cell("D1").is_date());
+
+        xlnt::streaming_workbook_reader reader;
+        reader.open(buffer);
+        reader.begin_worksheet("Sheet1");
+
+        std::string kinds;
+
+        reader.visit_cells([&kinds](const xlnt::cell_view &view) {
+            kinds.push_back(view.is_date ? 'd' : view.is_timedelta ? 't' : 'n');
+        });
+
+        reader.end_worksheet();
+        xlnt_assert_equals(kinds, "dtnn");
+    }
+
+    void test_sheet_data_writer()
+    {
+        auto write_text = [](const std::string &text) {
+            std::ostringstream stream;
+            xlnt::detail::sheet_data_writer writer(stream, "sheet1.xml");
+            writer.write_text(text);
+            writer.flush();
+            return stream.str();
+        };
+
+        xlnt_assert_equals(write_text("plain text which is long enough to be scanned"),
+            "plain text which is long enough to be scanned");
+        xlnt_assert_equals(write_text("a<b & c>d\r\n"), "a&lt;b &amp; c&gt;d&#xD;\n");
+        xlnt_assert_equals(write_text("\xce\x9b \xe2\x82\xac & \xf0\x9f\x98\x80"),
+            "\xce\x9b \xe2\x82\xac &amp; \xf0\x9f\x98\x80");
+        xlnt_assert_throws(write_text(std::string("nul\0", 4)), xml::serialization);
+        xlnt_assert_throws(write_text("bell\x07"), xml::serialization);
+        xlnt_assert_throws(write_text("truncated \xe2\x82"), xml::serialization);
+        xlnt_assert_throws(write_text("overlong \xc0\xaf"), xml::serialization);
+
+        // enough cells to flush the writer's buffer several times
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        for (xlnt::row_t row = 1; row <= 2000; ++row)
+        {
+            ws.cell(1, row).value(static_cast<int>(row) - 1000);
+            ws.cell(2, row).value(row / 8.0);
+            ws.cell(3, row).formula("IF(A" + std::to_string(row) + "<0,\"<&>\",\"\")");
+        }
+
+        ws.cell("D1").value(true);
+        ws.cell("D2").error("#N/A");
+        ws.row_properties(3000).height = 21.25;
+
+        std::vector<std::uint8_t> buffer;
+        wb.save(buffer);
+
+        xlnt::workbook loaded;
+        loaded.load(buffer);
+        auto loaded_ws = loaded.active_sheet();
+
+        for (xlnt::row_t row = 1; row <= 2000; ++row)
+        {
+            xlnt_assert_equals(loaded_ws.cell(1, row).value<int>(), static_cast<int>(row) - 1000);
+            xlnt_assert_equals(loaded_ws.cell(2, row).value<double>(), row / 8.0);
+            xlnt_assert_equals(loaded_ws.cell(3, row).formula(),
+                "IF(A" + std::to_string(row) + "<0,\"<&>\",\"\")");
+        }
+
+        xlnt_assert(loaded_ws.cell("D1").value<bool>());
+        xlnt_assert_equals(loaded_ws.cell("D2").data_type(), xlnt::cell::type::error);
+        xlnt_assert_equals(loaded_ws.row_properties(3000).height.get(), 21.25);
     }
 };
@@ -57,6 +57,9 @@ public:
         register_test(test_clear);
         register_test(test_comparison);
         register_test(test_id_gen);
+        register_test(test_shared_string_index);
+        register_test(test_format_lookup);
+        register_test(test_style_edit_session);
     }
 
     void test_active_sheet()
@@ -339,4 +342,148 @@ public:
         wb.create_sheet();
         xlnt_assert_differs(wb[1].id(), wb[2].id());
     }
+
+    void test_shared_string_index()
+    {
+        xlnt::workbook wb;
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("a")), 0);
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("b")), 1);
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("a")), 0);
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("a"), true), 2);
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("a")), 0);
+
+        // strings appended directly to the table are picked up by the index
+        wb.shared_strings().push_back(xlnt::rich_text("c"));
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("c")), 3);
+
+        xlnt::workbook copy = wb;
+        xlnt_assert_equals(copy.add_shared_string(xlnt::rich_text("b")), 1);
+        xlnt_assert_equals(copy.add_shared_string(xlnt::rich_text("d")), 4);
+        xlnt_assert_equals(wb.shared_strings().size(), 4);
+
+        // edits in place or removals followed by appends leave no stale entries
+        wb.shared_strings()[0] = xlnt::rich_text("e");
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("e")), 0);
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("a")), 2);
+
+        auto &strings = wb.shared_strings();
+        strings.erase(strings.begin());
+        strings.push_back(xlnt::rich_text("f"));
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("b")), 0);
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("f")), 3);
+        xlnt_assert_equals(wb.add_shared_string(xlnt::rich_text("e")), 4);
+    }
+
+    void test_format_lookup()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        // identical formatting is shared by every cell
+        for (auto row = 1; row <= 100; ++row)
+        {
+            ws.cell(1, static_cast<xlnt::row_t>(row)).font(xlnt::font().bold(true));
+        }
+
+        xlnt_assert(wb.format(1).font().bold());
+        xlnt_assert_throws(wb.format(2), std::out_of_range);
+
+        for (auto row = 1; row <= 50; ++row)
+        {
+            ws.cell(2, static_cast<xlnt::row_t>(row)).font(xlnt::font().size(row));
+        }
+
+        xlnt_assert_equals(wb.format(2).font().size(), 1.0);
+        xlnt_assert_equals(wb.format(51).font().size(), 50.0);
+        xlnt_assert_throws(wb.format(52), std::out_of_range);
+
+        // a format changed in place is no longer found by its old contents
+        wb.format(2).quote_prefix(true);
+        ws.cell("C1").font(xlnt::font().size(1));
+        xlnt_assert(wb.format(2).quote_prefix());
+        xlnt_assert(!ws.cell("C1").format().quote_prefix());
+        xlnt_assert_equals(ws.cell("C1").format().font().size(), 1.0);
+
+        ws.cell("D1").number_format(xlnt::number_format("0.000"));
+        ws.cell("D2").number_format(xlnt::number_format("0.0000"));
+        ws.cell("D3").number_format(xlnt::number_format("0.000"));
+        xlnt_assert_equals(ws.cell("D1").number_format().id(), 164);
+        xlnt_assert_equals(ws.cell("D2").number_format().id(), 165);
+        xlnt_assert_equals(ws.cell("D2").number_format().format_string(), "0.0000");
+        xlnt_assert_equals(ws.cell("D3").number_format().format_string(), "0.000");
+    }
+
+    void test_style_edit_session()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        {
+            xlnt::style_edit_session session(wb);
+
+            {
+                xlnt::style_edit_session nested(wb);
+
+                for (auto i = 0; i < 5; ++i)
+                {
+                    wb.create_format();
+                }
+
+                ws.cell("A1").font(xlnt::font().size(10));
+            }
+
+            // unused formats are kept until the outermost session ends
+            xlnt_assert_equals(wb.format(7).font().size(), 10.0);
+        }
+
+        xlnt_assert_equals(wb.format(1).font().size(), 10.0);
+        xlnt_assert_equals(ws.cell("A1").font().size(), 10.0);
+        xlnt_assert_throws(wb.format(2), std::out_of_range);
+
+        {
+            xlnt::style_edit_session session(wb);
+
+            for (auto i = 0; i < 3; ++i)
+            {
+                wb.create_format();
+            }
+
+            ws.cell("A2").font(xlnt::font().size(10));
+            xlnt_assert_equals(wb.format(3).font().size(), 12.0);
+
+            // saving collects deferred garbage so the written ids are dense
+            std::vector<std::uint8_t> data;
+            wb.save(data);
+            xlnt_assert_throws(wb.format(2), std::out_of_range);
+
+            xlnt::workbook loaded;
+            loaded.load(data);
+            xlnt_assert_equals(loaded.active_sheet().cell("A2").font().size(), 10.0);
+            xlnt_assert_throws(loaded.format(2), std::out_of_range);
+        }
+
+        {
+            xlnt::style_edit_session session(wb);
+            wb.create_format();
+            ws.cell("C1").font(xlnt::font().size(12));
+
+            // a copy made while a session is open collects garbage as usual
+            xlnt::workbook copy = wb;
+
+            for (auto i = 0; i < 3; ++i)
+            {
+                copy.create_format();
+            }
+
+            copy.active_sheet().cell("B1").font(xlnt::font().size(11));
+            xlnt_assert_equals(copy.active_sheet().cell("B1").font().size(), 11.0);
+            xlnt_assert_throws(copy.format(2), std::out_of_range);
+
+            // while the original still defers it
+            xlnt_assert_throws_nothing(wb.format(3));
+        }
+
+        xlnt_assert_equals(wb.format(2).font().size(), 12.0);
+        xlnt_assert_throws(wb.format(3), std::out_of_range);
+    }
 };
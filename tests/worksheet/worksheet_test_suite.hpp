@@ -101,6 +101,9 @@ public:
         register_test(test_view_properties_serialization);
         register_test(test_clear_cell);
         register_test(test_clear_row);
+        register_test(test_cell_handle_stability);
+        register_test(test_clear_cell_side_data);
+        register_test(test_bounds_after_clear);
     }
 
     void test_new_worksheet()
@@ -1220,4 +1223,77 @@ public:
         xlnt_assert_equals(ws2.calculate_dimension().height(), height - 1);
         xlnt_assert(!ws2.has_cell(xlnt::cell_reference(1, last_row)));
     }
+
+    void test_cell_handle_stability()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        auto first = ws.cell("B2");
+        first.value(42);
+        first.formula("=SUM(A1:A2)");
+
+        for (xlnt::row_t row = 1; row <= 100; ++row)
+        {
+            for (xlnt::column_t::index_t column = 1; column <= 100; ++column)
+            {
+                ws.cell(xlnt::cell_reference(column, row)).hyperlink("http://example.com/");
+            }
+        }
+
+        xlnt_assert_equals(first.reference(), "B2");
+        xlnt_assert(first.has_formula());
+        xlnt_assert_equals(first.formula(), "SUM(A1:A2)");
+        xlnt_assert(first == ws.cell("B2"));
+
+        auto copy = wb.copy_sheet(ws);
+        xlnt_assert_equals(copy.cell("B2").formula(), "SUM(A1:A2)");
+        xlnt_assert_equals(copy.cell("J10").hyperlink(), "http://example.com/");
+    }
+
+    void test_clear_cell_side_data()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        ws.cell("C3").formula("=A1");
+        ws.cell("C3").hyperlink("http://example.com/");
+        ws.cell("D3").error("#REF!");
+        ws.clear_cell("C3");
+        ws.clear_row(3);
+
+        xlnt_assert(!ws.has_cell("C3"));
+        xlnt_assert(!ws.cell("C3").has_formula());
+        xlnt_assert(!ws.cell("C3").has_hyperlink());
+        xlnt_assert(!ws.cell("D3").has_value());
+        xlnt_assert_equals(ws.cell("D3").value<std::string>(), "");
+    }
+
+    void test_bounds_after_clear()
+    {
+        xlnt::workbook wb;
+        auto ws = wb.active_sheet();
+
+        ws.cell("B2").value(1);
+        ws.cell("E3").value(2);
+        ws.cell("C7").value(3);
+        xlnt_assert_equals(ws.calculate_dimension(), xlnt::range_reference("B2:E7"));
+
+        ws.clear_cell("C7");
+        xlnt_assert_equals(ws.calculate_dimension(), xlnt::range_reference("B2:E3"));
+
+        ws.clear_row(3);
+        xlnt_assert_equals(ws.calculate_dimension(), xlnt::range_reference("B2:B2"));
+
+        ws.cell("A9").value(4);
+        xlnt_assert_equals(ws.lowest_column(), xlnt::column_t("A"));
+        xlnt_assert_equals(ws.highest_row(), 9);
+
+        ws.clear_cell("B2");
+        ws.clear_cell("A9");
+        xlnt_assert_equals(ws.calculate_dimension(), xlnt::range_reference("A1:A1"));
+
+        ws.cell("D4").value(5);
+        xlnt_assert_equals(ws.calculate_dimension(), xlnt::range_reference("D4:D4"));
+    }
 };
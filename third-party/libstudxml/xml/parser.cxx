@@ -686,7 +686,7 @@ namespace xml
     }
     else
     {
-      ns.assign (s, 0, p - s);
+      ns.assign (s, p - s);
 
       s = p + 1;
       p = strchr (s, ' ');
@@ -698,7 +698,7 @@ namespace xml
       }
       else
       {
-        name.assign (s, 0, p - s);
+        name.assign (s, p - s);
         prefix = p + 1;
       }
     }